@@ -22,8 +22,16 @@
 /* Mask to get ACS Reset flag from RESET_STATUS_DIG register */
 #define RESET_DIG_STATUS_ACS_RESET_FLAGS_MASK ((uint32_t)(0x00000001))
 
-/* Wakeup flag for RTC */
-uint8_t wakeup_due_to_RTC = 0;
+/* Periodic RTC wakeup of the sample application; like the timer heap, the
+ * timers are retained through a wakeup from sleep without retention */
+static sw_timer_t rtc_sleep_timer __attribute__ ((section(".noinit")));
+
+/* Periodic calibration of the RC oscillator used as RTC clock */
+static sw_timer_t rtc_calibration_timer __attribute__ ((section(".noinit")));
+
+/* Samples of the impedance measurement cycle in progress */
+static sensor_sample_t impedance_cycle[IMPEDANCE_CYCLE_SAMPLES];
+static uint32_t impedance_cycle_count;
 
 void BLE_SLP_IRQHandler(void)
 {
@@ -39,23 +47,348 @@ void BLE_SLP_IRQHandler(void)
 #endif    /* DEBUG_SLEEP_GPIO */
 }
 
-void Main_Loop(void)
+/**
+ * @brief      Called every RTC_SLEEP_TIME_MS from SW_Timer_Process()
+ * @param [in] arg  Unused
+ */
+static void RTC_Sleep_Timer_Callback(void *arg)
+{
+    (void)arg;
+
+    /* Application operations on each RTC period */
+}
+
+/**
+ * @brief      Called every TIMEBASE_CALIBRATION_PERIOD_MS from SW_Timer_Process()
+ * @param [in] arg  Unused
+ */
+static void RTC_Calibration_Timer_Callback(void *arg)
+{
+    (void)arg;
+
+    /* On a timeout, keep the previous error until the next period */
+    (void)Timebase_Calibrate();
+}
+
+/**
+ * @brief      Emulate application operations in run mode
+ * @param [in] gpio  Activity GPIO of the wakeup source
+ */
+static void App_Activity(uint32_t gpio)
+{
+#if DEBUG_SLEEP_GPIO
+
+    /* Toggle this pin 6 times to emulate application operations
+     * for the wakeup source in run mode */
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        Sys_GPIO_Toggle(gpio);
+    }
+#endif    /* DEBUG_SLEEP_GPIO */
+}
+
+/**
+ * @brief      Process a batch of samples taken from the sample buffer
+ * @param [in] batch  Samples, oldest first
+ * @param [in] count  Number of samples, up to ADC_DATA_LENGTH
+ */
+static void App_Sample_Batch(const sensor_sample_t *batch, uint32_t count)
+{
+    int16_t values[ADC_DATA_LENGTH];
+    sensor_dsp_result_t result;
+
+    /* Impedance samples are reduced to one estimate per measurement cycle
+     * rather than logged */
+    if (Sensor_Profile_Current() == SENSOR_PROFILE_IMPEDANCE)
+    {
+        impedance_result_t impedance;
+
+        /* A cycle may be split across FIFO wakeups */
+        for (uint32_t i = 0; i < count; i++)
+        {
+            impedance_cycle[impedance_cycle_count++] = batch[i];
+
+            if (impedance_cycle_count == IMPEDANCE_CYCLE_SAMPLES)
+            {
+                /* The application reads the estimates with Impedance_Last() */
+                Impedance_Measure(impedance_cycle, &impedance);
+                impedance_cycle_count = 0;
+            }
+        }
+
+        return;
+    }
+
+    /* Keep a compressed copy in the retained log until it is uploaded */
+    Sample_Log_Write(batch, count);
+
+    /* Filter the batch and look for events in one pass */
+    for (uint32_t i = 0; i < count; i++)
+    {
+        values[i] = (batch[i].value > INT16_MAX) ? INT16_MAX : (int16_t)batch[i].value;
+    }
+
+    Sensor_DSP_Process(values, count, &result);
+
+    if (result.events & SENSOR_DSP_EVENT_RISE)
+    {
+        /* Application processing of the detection */
+        App_Activity(WAKEUP_ACTIVITY_FIFO_FULL);
+    }
+}
+
+#if SENSOR_IMPEDANCE_CHECK_PERIOD
+/**
+ * @brief Choose the measurement profile of the next FIFO wakeup
+ */
+static void App_Sensor_Profile_Next(void)
+{
+    /* The count survives a wakeup through reset with the profile */
+    sensor_profile_id_t next = Sensor_Profile_Next(SENSOR_IMPEDANCE_CHECK_PERIOD);
+
+    if (next != Sensor_Profile_Current())
+    {
+        Sensor_Profile_Apply(next);
+        impedance_cycle_count = 0;
+
+        /* A measurement cycle may be split across FIFO wakeups */
+        if (next == SENSOR_PROFILE_IMPEDANCE)
+        {
+            Power_Governor_Hold(POWER_GOVERNOR_HOLD_IMPEDANCE);
+        }
+        else
+        {
+            Power_Governor_Release(POWER_GOVERNOR_HOLD_IMPEDANCE);
+        }
+    }
+}
+
+#endif    /* if SENSOR_IMPEDANCE_CHECK_PERIOD */
+/**
+ * @brief      Process an event posted by an interrupt handler
+ * @param [in] event  Event to process
+ */
+static void App_Event_Process(const app_event_t *event)
+{
+    if (event->type == EVENT_NFC)
+    {
+        NFC_Engine_Process(event);
+        return;
+    }
+
+    if (event->type != EVENT_WAKEUP)
+    {
+        return;
+    }
+
+    switch (event->arg)
+    {
+        case WAKEUP_SRC_RTC_ALARM:
+        {
+            /* Run the expired timers and program the RTC alarm again for
+             * the next one */
+            SW_Timer_Process();
+            App_Activity(WAKEUP_ACTIVITY_RTC);
+        }
+        break;
+
+        case WAKEUP_SRC_FIFO:
+        {
+            sensor_sample_t batch[ADC_DATA_LENGTH];
+            uint32_t count = 0;
+
+            /* Take the samples drained from the FIFO */
+            while (Sample_Buffer_Get(&batch[count]))
+            {
+                FIFO_Controller_Sample(batch[count].value);
+                if ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_ADC) & WAKEUP_SRC_EN_MSK)
+                {
+                    Threshold_Manager_Sample(batch[count].value);
+                }
+
+                if (++count == ADC_DATA_LENGTH)
+                {
+                    App_Sample_Batch(batch, count);
+                    count = 0;
+                }
+            }
+
+            if (count > 0)
+            {
+                App_Sample_Batch(batch, count);
+            }
+
+            /* Choose the FIFO depth for the next wakeups */
+            FIFO_Controller_Update();
+
+#if SENSOR_IMPEDANCE_CHECK_PERIOD
+            App_Sensor_Profile_Next();
+#endif    /* if SENSOR_IMPEDANCE_CHECK_PERIOD */
+
+            App_Activity(WAKEUP_ACTIVITY_FIFO_FULL);
+        }
+        break;
+
+        case WAKEUP_SRC_GPIO:
+        {
+            App_Activity(WAKEUP_ACTIVITY_GPIO);
+        }
+        break;
+
+        case WAKEUP_SRC_NFC:
+        {
+            /* Keep the core clock gated rather than asleep while the field
+             * is present */
+            NFC_Engine_FieldOn();
+            App_Activity(WAKEUP_ACTIVITY_NFC);
+        }
+        break;
+
+        case WAKEUP_SRC_ADC:
+        {
+            /* Move the threshold with the baseline, re-arming it once the
+             * signal is back below it */
+            Threshold_Manager_Sample(event->value);
+            Threshold_Manager_Update();
+
+            App_Activity(WAKEUP_ACTIVITY_THRESHOLD);
+        }
+        break;
+
+        case WAKEUP_SRC_SENSOR_DET:
+        {
+            App_Activity(WAKEUP_ACTIVITY_SENSOR_DET);
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+void Main_Loop(uint8_t cold_boot)
 {
-	RTC_ALARM_Reconfig(CONVERT_TO_RTC_TIMER_COUNTER(RTC_SLEEP_TIME_MS));
+    app_event_t event;
+    uint8_t timers_lost = false;
+
+    /* The RTC alarm is shared by all software timers; add application
+     * timers with SW_Timer_Start(). The timers keep running through a
+     * wakeup from sleep without retention */
+    if (cold_boot)
+    {
+        SW_Timer_Init();
+    }
+    else
+    {
+        timers_lost = !SW_Timer_Restore();
+    }
+
+    /* Like the sensor, the FIFO controller keeps its state through a wakeup
+     * from sleep without retention */
+    if (cold_boot)
+    {
+        FIFO_Controller_Init();
+    }
+    else
+    {
+        (void)FIFO_Controller_Restore();
+    }
+
+    /* So does the sensor processing, with its filter history, baseline and
+     * detection state, and the impedance calibration curve */
+    if (cold_boot)
+    {
+        Sensor_DSP_Init();
+        Impedance_Init();
+    }
+    else
+    {
+        (void)Sensor_DSP_Restore();
+        (void)Impedance_Restore();
+    }
+
+    /* The threshold keeps its holdoff through a wakeup without retention */
+    if ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_ADC) & WAKEUP_SRC_EN_MSK)
+    {
+        if (cold_boot)
+        {
+            Threshold_Manager_Init();
+        }
+        else if (Threshold_Manager_Restore() && timers_lost)
+        {
+            Threshold_Manager_Update();
+        }
+    }
+
+#if SENSOR_REPLAY_EN
+    /* Feed the wakeup handlers from the recorded trace instead of the sensor */
+    Sensor_Replay_Start(sensor_replay_trace, sensor_replay_trace_length);
+#endif    /* if SENSOR_REPLAY_EN */
+
+    /* Scripted wakeup scenarios, started over if the run was lost */
+    if (cold_boot || timers_lost || !Benchmark_Restore())
+    {
+        Benchmark_Start();
+    }
+
+    if (cold_boot || timers_lost)
+    {
+        SW_Timer_Start(&rtc_sleep_timer, CONVERT_TO_RTC_TIMER_COUNTER(RTC_SLEEP_TIME_MS),
+                       CONVERT_TO_RTC_TIMER_COUNTER(RTC_SLEEP_TIME_MS), RTC_Sleep_Timer_Callback, NULL);
+    }
+
+    /* The RC oscillator drifts with temperature and supply: learn its error
+     * against the XTAL periodically, so that timers keep running on time */
+    if (RTC_CLK_SRC == RTC_CLK_SRC_RC_OSC)
+    {
+        /* The error learned before a wakeup through reset is retained */
+        if (cold_boot)
+        {
+            (void)Timebase_Calibrate();
+        }
+
+        if (cold_boot || timers_lost)
+        {
+            SW_Timer_Start(&rtc_calibration_timer, TIMEBASE_MS_TO_TICKS(TIMEBASE_CALIBRATION_PERIOD_MS),
+                           TIMEBASE_MS_TO_TICKS(TIMEBASE_CALIBRATION_PERIOD_MS),
+                           RTC_Calibration_Timer_Callback, NULL);
+        }
+    }
 
     while (1)
     {
     	SYS_WATCHDOG_REFRESH();
 
+    	/* Run the work posted by the interrupt handlers to completion */
+    	while (Event_Get(&event))
+    	{
+    		App_Event_Process(&event);
+    	}
+
+    	/* Let a pending RTC alarm update complete before sleeping */
+    	RTC_ALARM_Reconfig_Wait();
+
     	GLOBAL_INT_DISABLE();
 
-    	SoC_Sleep();
+    	/* Only sleep if no event was posted since the queue was drained */
+    	if (Event_Queue_Empty())
+    	{
+    		if (NFC_Engine_Active())
+    		{
+    			/* The NFC interrupt ends the wait for the next frame */
+    			__WFI();
+    		}
+    		else
+    		{
+    			SoC_Sleep();
+    		}
+    	}
 
     	GLOBAL_INT_RESTORE();
 
     	/* Only reached in the case where VDDC is enabled */
 
-    	if ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_NFC) & WAKEUP_SRC_EN_MSK)
+    	if (((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_NFC) & WAKEUP_SRC_EN_MSK) && !NFC_ENGINE_EN)
     	{
     		/* Stay in run mode for a defined number of seconds
     		 * after waking up from NFC to reduce fluctuation */
@@ -65,16 +398,6 @@ void Main_Loop(void)
     			Sys_Delay(SystemCoreClock);
     		}
     	}
-
-    	/* If wakeup due to RTC timeout */
-    	if(wakeup_due_to_RTC)
-    	{
-    		/* clear flag to consider next wakeup */
-    		wakeup_due_to_RTC = 0;
-
-    		/* Configure RTC alarm again for next wakeup */
-    		RTC_ALARM_Reconfig(CONVERT_TO_RTC_TIMER_COUNTER(RTC_SLEEP_TIME_MS));
-    	}
     }
 }
 
@@ -90,14 +413,43 @@ int main(void)
     if (((ACS->RESET_STATUS & ACS_RESET_STATUS_RESET_FLAGS_MASK) == 0x0) &&
         ((RESET->DIG_STATUS & RESET_DIG_STATUS_ACS_RESET_FLAGS_MASK) == 0x1))
     {
+        /* Account for the sleep that ended with this reset */
+        Metrics_Init();
+        Metrics_SleepExit();
+        Wakeup_Trace_Init();
+        Wakeup_Trace_Add(WAKEUP_TRACE_RESUME_RESET, 0, 0);
+        Sample_Buffer_Init();
+        Sample_Log_Init();
+        NFC_Type2_Init();
+
         App_Sleep_Initialization();
 
         /* Reinitialize the system after wakeup */
         Sys_PowerModes_Wakeup_WithReset(&app_sleep_mode_cfg);
 
-        EnableAppInterrupts();
+        /* Set up the clock dividers, pads and wakeup interrupts again
+         * through their drivers, in the order of the cold boot */
+        Sys_Clocks_DividerConfig(UART_CLK, SENSOR_CLK, USER_CLK);
+        Wakeup_Source_Restore();
+
+        /* The sensor normally keeps its configuration through the reset;
+         * apply it again only if it was lost */
+        if ((((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_FIFO) |
+              (WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_ADC)) & WAKEUP_SRC_EN_MSK) && !SENSOR_REPLAY_EN)
+        {
+            Sensor_Restore();
+        }
 
         if ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_NFC) & WAKEUP_SRC_EN_MSK)
+        {
+            /* Serve the frames of the field that woke the device up */
+            NFC_Engine_Init();
+        }
+
+        EnableAppInterrupts();
+        Metrics_ResetPath();
+
+        if (((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_NFC) & WAKEUP_SRC_EN_MSK) && !NFC_ENGINE_EN)
         {
         	/* Stay in run mode for a defined number of seconds
         	 * after waking up from NFC to reduce fluctuation */
@@ -107,6 +459,9 @@ int main(void)
         		Sys_Delay(SystemCoreClock);
         	}
         }
+
+        /* Execute main loop, keeping the state retained through the reset */
+        Main_Loop(false);
     }
     else    /* Else: Not wakeup from SLEEP mode */
     {
@@ -124,8 +479,8 @@ int main(void)
 
         /* Enable all interrupts */
         EnableAppInterrupts();
-    }
 
-    /* Execute main loop */
-    Main_Loop();
+        /* Execute main loop */
+        Main_Loop(true);
+    }
 }
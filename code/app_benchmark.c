@@ -0,0 +1,227 @@
+/**
+ * @file app_benchmark.c
+ * @brief Scripted wakeup scenarios measuring the cost of each wakeup source
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "app_benchmark.h"
+
+#if APP_BENCHMARK_EN
+
+/* Script: each scenario runs once, in order */
+static const benchmark_scenario_t benchmark_scenarios[BENCHMARK_SCENARIO_COUNT] =
+{
+    /* Reference: the benchmark timer alone */
+    { 0,                          16, 1000, 0 },
+
+    /* Burst of GPIO1 edges */
+    { WAKEUP_GPIO1_EVENT_SET,     32, 10,   0 },
+
+    /* RTC alarm periods */
+    { WAKEUP_RTC_ALARM_EVENT_SET, 16, 1000, 0 },
+
+    /* FIFO full, at the rate of a 16 sample FIFO */
+    { WAKEUP_FIFO_FULL_EVENT_SET, 16, 500,  0 },
+
+    /* NFC field detected; the NFC engine keeps the core awake until its
+     * idle timeout */
+    { WAKEUP_NFC_FIELD_EVENT_SET, 4,  5000, 0 },
+
+    /* Sensor configuration after a wakeup through reset: cold init against
+     * fast restore */
+    { 0,                          15, 1000, 1 }
+};
+
+app_benchmark_t app_benchmark __attribute__ ((section(".noinit")));
+
+/* Retained like the timer heap (see sw_timer.h) */
+static sw_timer_t benchmark_timer __attribute__ ((section(".noinit")));
+
+/* Events injected and not yet taken by WAKEUP_IRQHandler() */
+static volatile uint32_t benchmark_events;
+
+/**
+ * @brief       Read the metrics accumulated since they were cleared
+ * @param [out] result  Metrics
+ */
+static void Benchmark_Snapshot(benchmark_result_t *result)
+{
+    result->wakeups = 0;
+    for (uint32_t i = 0; i < METRICS_WAKEUP_SRC_COUNT; i++)
+    {
+        result->wakeups += app_metrics.wakeups[i];
+    }
+
+    result->sleep_ticks = 0;
+    for (uint32_t mode = 0; mode < POWER_MODE_COUNT; mode++)
+    {
+        result->sleep_ticks += app_metrics.sleep_ticks[mode];
+    }
+
+    /* Include the run period in progress */
+    result->run_cycles = app_metrics.run_cycles + METRICS_CYCLES();
+    result->wakeup_irq_cycles = app_metrics.wakeup_irq_cycles;
+    result->reg_accesses = app_metrics.reg_accesses;
+    result->sample_log_cycles = app_metrics.sample_log_cycles;
+    result->sample_log_samples = app_metrics.sample_log_samples;
+    for (uint32_t path = 0; path < METRICS_SENSOR_PATH_COUNT; path++)
+    {
+        result->sensor_restores[path] = app_metrics.sensor_restores[path];
+        result->sensor_restore_cycles[path] = app_metrics.sensor_restore_cycles[path];
+    }
+    result->charge_nc = Metrics_Charge_nC() +
+                        ((uint64_t)METRICS_CYCLES() * METRICS_CURRENT_RUN_UA * 1000) / SystemCoreClock;
+}
+
+/**
+ * @brief Store the metrics of the running scenario and start the next one
+ */
+static void Benchmark_Next(void)
+{
+    benchmark_result_t end;
+    benchmark_result_t *result = &app_benchmark.results[app_benchmark.scenario];
+
+    Benchmark_Snapshot(&end);
+    result->wakeups = end.wakeups - app_benchmark.start.wakeups;
+    result->run_cycles = end.run_cycles - app_benchmark.start.run_cycles;
+    result->wakeup_irq_cycles = end.wakeup_irq_cycles - app_benchmark.start.wakeup_irq_cycles;
+    result->reg_accesses = end.reg_accesses - app_benchmark.start.reg_accesses;
+    result->sample_log_cycles = end.sample_log_cycles - app_benchmark.start.sample_log_cycles;
+    result->sample_log_samples = end.sample_log_samples - app_benchmark.start.sample_log_samples;
+    for (uint32_t path = 0; path < METRICS_SENSOR_PATH_COUNT; path++)
+    {
+        result->sensor_restores[path] = end.sensor_restores[path] - app_benchmark.start.sensor_restores[path];
+        result->sensor_restore_cycles[path] = end.sensor_restore_cycles[path] -
+                                              app_benchmark.start.sensor_restore_cycles[path];
+    }
+    result->sleep_ticks = end.sleep_ticks - app_benchmark.start.sleep_ticks;
+    result->charge_nc = end.charge_nc - app_benchmark.start.charge_nc;
+
+    app_benchmark.start = end;
+    app_benchmark.scenario++;
+    app_benchmark.injected = 0;
+}
+
+/**
+ * @brief      Configure the sensor as after a wakeup through reset, taking
+ *             one of the Sensor_Restore() paths in turn
+ * @param [in] n  Number of the wakeup in the scenario
+ */
+static void Benchmark_Sensor_Restore(uint32_t n)
+{
+    /* The sensor is left unconfigured while replaying a trace */
+    if (!((((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_FIFO) |
+            (WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_ADC)) & WAKEUP_SRC_EN_MSK) && !SENSOR_REPLAY_EN))
+    {
+        return;
+    }
+
+    switch (n % METRICS_SENSOR_PATH_COUNT)
+    {
+        case SENSOR_RESTORE_COLD:
+        {
+            /* As after a cold boot */
+            Sensor_Profile_Invalidate();
+            break;
+        }
+
+        case SENSOR_RESTORE_REAPPLIED:
+        {
+            /* As if the sensor had lost its configuration in the reset */
+            CLK->DIV_CFG1 &= ~SENSOR_CLK_ENABLE;
+            break;
+        }
+
+        default:
+        break;
+    }
+
+    (void)Sensor_Restore();
+}
+
+/**
+ * @brief      Inject the events of the running scenario, or move on to the
+ *             next scenario one period after its last wakeup
+ * @param [in] arg  Unused
+ */
+static void Benchmark_Timer_Callback(void *arg)
+{
+    const benchmark_scenario_t *scenario;
+
+    (void)arg;
+
+    if (app_benchmark.scenario >= BENCHMARK_SCENARIO_COUNT)
+    {
+        return;
+    }
+
+    scenario = &benchmark_scenarios[app_benchmark.scenario];
+    if (app_benchmark.injected < scenario->count)
+    {
+        /* Raise the events as the hardware would: the wakeup interrupt
+         * dispatches them to the registered handlers */
+        if (scenario->events != 0)
+        {
+            GLOBAL_INT_DISABLE();
+            benchmark_events |= scenario->events;
+            GLOBAL_INT_RESTORE();
+            NVIC_SetPendingIRQ(WAKEUP_IRQn);
+        }
+        if (scenario->sensor_restore)
+        {
+            Benchmark_Sensor_Restore(app_benchmark.injected);
+        }
+        app_benchmark.injected++;
+    }
+    else
+    {
+        Benchmark_Next();
+        if (app_benchmark.scenario >= BENCHMARK_SCENARIO_COUNT)
+        {
+            return;
+        }
+        scenario = &benchmark_scenarios[app_benchmark.scenario];
+    }
+
+    SW_Timer_Start(&benchmark_timer, TIMEBASE_MS_TO_TICKS(scenario->period_ms), 0,
+                   Benchmark_Timer_Callback, NULL);
+}
+
+void Benchmark_Start(void)
+{
+    memset(&app_benchmark, 0, sizeof(app_benchmark));
+    Benchmark_Snapshot(&app_benchmark.start);
+    app_benchmark.magic = BENCHMARK_MAGIC;
+
+    SW_Timer_Start(&benchmark_timer, TIMEBASE_MS_TO_TICKS(benchmark_scenarios[0].period_ms), 0,
+                   Benchmark_Timer_Callback, NULL);
+}
+
+uint8_t Benchmark_Restore(void)
+{
+    return (app_benchmark.magic == BENCHMARK_MAGIC) &&
+           (app_benchmark.scenario <= BENCHMARK_SCENARIO_COUNT);
+}
+
+uint32_t Benchmark_Take_Events(void)
+{
+    uint32_t events = benchmark_events;
+
+    benchmark_events = 0;
+
+    return events;
+}
+
+#endif    /* if APP_BENCHMARK_EN */
@@ -76,6 +76,13 @@ void DeviceInit(void)
         SYS_WATCHDOG_REFRESH();
     }
 
+    /* Start collecting run mode and energy metrics */
+    Metrics_Init();
+    Wakeup_Trace_Init();
+    Sample_Buffer_Init();
+    Sample_Log_Init();
+    NFC_Type2_Init();
+
     /* Load default regulator trim values. */
     uint32_t trim_error __attribute__ ((unused)) = SYS_TRIM_LOAD_DEFAULT();
 
@@ -159,6 +166,9 @@ void DeviceInit(void)
     /* Enable the wakeup source configuration */
     Wakeup_Source_Config();
 
+    /* Start the timebase from the RTC reset */
+    Timebase_Init();
+
     /* Sleep Initialization for Power Mode */
     App_Sleep_Initialization();
 
@@ -177,6 +187,9 @@ void DisableAppInterrupts(void)
 
 void EnableAppInterrupts(void)
 {
+    /* The priorities are reset with the NVIC on a wakeup through reset */
+    NVIC_SetPriority(WAKEUP_IRQn, APP_IRQ_PRIORITY_EVENT);
+
     __set_FAULTMASK(FAULTMASK_ENABLE_INTERRUPTS);
     __set_PRIMASK(PRIMASK_ENABLE_INTERRUPTS);
 }
@@ -285,7 +298,7 @@ void App_Sleep_Initialization(void)
                                   BOOT_PWR_CAL_BYPASS_ENABLE      |
                                   BOOT_ROT_BYPASS_ENABLE;
 
-#elif SLEEP_MODE_TEST == DEEP_SLEEP_TEST
+#elif (SLEEP_MODE_TEST == DEEP_SLEEP_TEST) || (SLEEP_MODE_TEST == SLEEP_MODE_TEST_GOVERNOR)
 
     app_sleep_mode_cfg.boot_cfg = BOOT_FLASH_XTAL_DEFAULT_TRIM    |
                                   BOOT_PWR_CAL_BYPASS_ENABLE      |
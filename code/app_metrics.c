@@ -0,0 +1,163 @@
+/**
+ * @file app_metrics.c
+ * @brief Run mode and energy metrics
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "app_metrics.h"
+
+#if APP_METRICS_EN
+
+/* RTC clock frequency in Hz */
+#define METRICS_RTC_CLK_HZ              32768
+
+app_metrics_t app_metrics __attribute__ ((section(".noinit")));
+
+/* Current drawn in each sleep mode (nA), indexed by power_mode_t */
+static const uint32_t sleep_current_na[POWER_MODE_COUNT] =
+{
+    METRICS_CURRENT_CORE_RETENTION_NA,
+    METRICS_CURRENT_NO_RETENTION_NA,
+    METRICS_CURRENT_DEEP_SLEEP_NA
+};
+
+void Metrics_Init(void)
+{
+    /* Enable the DWT cycle counter */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    if (app_metrics.magic != METRICS_MAGIC)
+    {
+        Metrics_Clear();
+    }
+}
+
+void Metrics_Clear(void)
+{
+    memset(&app_metrics, 0, sizeof(app_metrics));
+    app_metrics.sleep_mode = POWER_MODE_COUNT;
+    app_metrics.magic = METRICS_MAGIC;
+}
+
+void Metrics_SleepEnter(power_mode_t mode)
+{
+    app_metrics.run_cycles += METRICS_CYCLES();
+    app_metrics.sleep_mode = mode;
+    app_metrics.sleep_rtc_time = RTC_ALARM_Time();
+}
+
+void Metrics_SleepExit(void)
+{
+    uint32_t mode = app_metrics.sleep_mode;
+
+    /* The debug domain may have been powered down while asleep */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    if (mode < POWER_MODE_COUNT)
+    {
+        app_metrics.sleeps[mode]++;
+        app_metrics.sleep_ticks[mode] += RTC_ALARM_Time() - app_metrics.sleep_rtc_time;
+        app_metrics.sleep_mode = POWER_MODE_COUNT;
+    }
+}
+
+void Metrics_Wakeup(uint32_t src)
+{
+    if (src < METRICS_WAKEUP_SRC_COUNT)
+    {
+        app_metrics.wakeups[src]++;
+    }
+}
+
+void Metrics_WakeupIRQ(uint32_t start)
+{
+    uint32_t cycles = METRICS_CYCLES() - start;
+
+    app_metrics.wakeup_irq_cycles += cycles;
+    if (cycles > app_metrics.wakeup_irq_max_cycles)
+    {
+        app_metrics.wakeup_irq_max_cycles = cycles;
+    }
+}
+
+void Metrics_SampleLog(uint32_t start, uint32_t samples)
+{
+    app_metrics.sample_log_cycles += METRICS_CYCLES() - start;
+    app_metrics.sample_log_samples += samples;
+}
+
+void Metrics_SensorRestore(uint32_t start, uint32_t path)
+{
+    if (path < METRICS_SENSOR_PATH_COUNT)
+    {
+        app_metrics.sensor_restores[path]++;
+        app_metrics.sensor_restore_cycles[path] += METRICS_CYCLES() - start;
+    }
+}
+
+void Metrics_ResetPath(void)
+{
+    /* The cycle counter was cleared by Metrics_Init() at the start of
+     * main() */
+    uint32_t cycles = METRICS_CYCLES();
+
+    app_metrics.reset_path_cycles = cycles;
+    if (cycles > app_metrics.reset_path_max_cycles)
+    {
+        app_metrics.reset_path_max_cycles = cycles;
+    }
+}
+
+void Metrics_AsyncRead(uint32_t reg, uint32_t retries, uint32_t status)
+{
+    /* The first two reads, then one per retry; an unstable read stops
+     * after its last retry */
+    app_metrics.reg_accesses += retries + ((status == ASYNC_READ_NO_ERROR) ? 2 : 1);
+
+    if (reg < METRICS_ASYNC_REG_COUNT)
+    {
+        app_metrics.async_reads[reg]++;
+        app_metrics.async_retries[reg] += retries;
+        if (status != ASYNC_READ_NO_ERROR)
+        {
+            app_metrics.async_unstable[reg]++;
+        }
+    }
+}
+
+void Metrics_RegAccess(uint32_t count)
+{
+    app_metrics.reg_accesses += count;
+}
+
+uint64_t Metrics_Charge_nC(void)
+{
+    /* Run mode: uA * (cycles / SystemCoreClock) s = uC, scaled to nC */
+    uint64_t charge = (app_metrics.run_cycles * METRICS_CURRENT_RUN_UA * 1000) / SystemCoreClock;
+
+    /* Sleep modes: nA * (ticks / 32768) s = nC */
+    for (uint32_t mode = 0; mode < POWER_MODE_COUNT; mode++)
+    {
+        charge += (app_metrics.sleep_ticks[mode] * sleep_current_na[mode]) / METRICS_RTC_CLK_HZ;
+    }
+
+    return charge;
+}
+
+#endif    /* if APP_METRICS_EN */
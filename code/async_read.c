@@ -0,0 +1,48 @@
+/**
+ * @file async_read.c
+ * @brief Consistent reads of asynchronous registers
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "async_read.h"
+
+uint8_t Async_Read(const volatile uint32_t *reg, uint32_t mask, async_reg_t id, uint32_t *value)
+{
+    uint32_t previous = *reg & mask;
+    uint32_t current = previous;
+    uint32_t tries;
+    uint8_t status = ASYNC_READ_UNSTABLE;
+
+    /* A register sampled while it changes in its own clock domain can
+     * return a mix of the old and new values: only trust a value read twice
+     * in a row */
+    for (tries = 1; tries < ASYNC_READ_MAX_TRIES; tries++)
+    {
+        current = *reg & mask;
+
+        if (current == previous)
+        {
+            status = ASYNC_READ_NO_ERROR;
+            break;
+        }
+
+        previous = current;
+    }
+
+    *value = current;
+    Metrics_AsyncRead(id, tries - 1, status);
+
+    return status;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file event_queue.c
+ * @brief Deferred event queue
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "event_queue.h"
+
+/* Single producer, single consumer ring: head is only written by the
+ * producer and tail only by the consumer, so no lock is needed */
+static app_event_t event_queue[EVENT_QUEUE_LENGTH];
+static volatile uint32_t event_head;
+static volatile uint32_t event_tail;
+static uint32_t event_dropped;
+
+/* Wakeup sources signaled and not yet taken, bit n for source n, and the
+ * value of the last signal of each. A wakeup never depends on a free slot of
+ * the ring: a lost RTC alarm would leave the software timers without an
+ * alarm until the RTC wraps */
+static volatile uint32_t event_signals;
+static uint32_t event_signal_values[EVENT_SIGNAL_COUNT];
+
+uint8_t Event_Post(uint32_t type, uint32_t arg, uint32_t data, uint32_t value)
+{
+    uint32_t head = event_head;
+    app_event_t *event;
+
+    if ((head - event_tail) >= EVENT_QUEUE_LENGTH)
+    {
+        event_dropped++;
+        return 0;
+    }
+
+    event = &event_queue[head & (EVENT_QUEUE_LENGTH - 1)];
+    event->type = (uint8_t)type;
+    event->arg = (uint8_t)arg;
+    event->data = (uint16_t)data;
+    event->value = value;
+
+    /* Publish the event only once it is completely written */
+    __DMB();
+    event_head = head + 1;
+
+    return 1;
+}
+
+void Event_Signal(uint32_t src, uint32_t value)
+{
+    /* The consumer masks the interrupts to take a signal: the producer
+     * cannot be interrupted by it */
+    event_signal_values[src] = value;
+    event_signals |= (1U << src);
+}
+
+uint8_t Event_Get(app_event_t *event)
+{
+    uint32_t tail = event_tail;
+    uint32_t signals;
+
+    GLOBAL_INT_DISABLE();
+
+    signals = event_signals;
+    if (signals != 0)
+    {
+        uint32_t src = __CLZ(__RBIT(signals));
+
+        event->type = EVENT_WAKEUP;
+        event->arg = (uint8_t)src;
+        event->data = 0;
+        event->value = event_signal_values[src];
+        event_signals = signals & ~(1U << src);
+    }
+
+    GLOBAL_INT_RESTORE();
+
+    if (signals != 0)
+    {
+        return 1;
+    }
+
+    if (tail == event_head)
+    {
+        return 0;
+    }
+
+    /* Read the event only after seeing it published */
+    __DMB();
+    *event = event_queue[tail & (EVENT_QUEUE_LENGTH - 1)];
+
+    /* Release the slot only once the event is copied */
+    __DMB();
+    event_tail = tail + 1;
+
+    return 1;
+}
+
+uint8_t Event_Queue_Empty(void)
+{
+    return (event_head == event_tail) && (event_signals == 0);
+}
+
+uint32_t Event_Queue_Dropped(void)
+{
+    return event_dropped;
+}
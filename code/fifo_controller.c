@@ -0,0 +1,149 @@
+/**
+ * @file fifo_controller.c
+ * @brief Adaptive sensor FIFO depth controller
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "fifo_controller.h"
+
+/* FIFO depths the controller steps through (1, 2, 4, 8 and 16 samples) */
+#define FIFO_CONTROLLER_STEPS           5
+
+static const uint32_t fifo_size_cfg[FIFO_CONTROLLER_STEPS] =
+{
+    SENSOR_FIFO_SIZE1,
+    SENSOR_FIFO_SIZE2,
+    SENSOR_FIFO_SIZE4,
+    SENSOR_FIFO_SIZE8,
+    SENSOR_FIFO_SIZE16
+};
+
+/* Programmed depth not known, e.g. after a wakeup through reset */
+#define FIFO_STEP_UNKNOWN               0xFF
+
+typedef struct
+{
+    uint32_t magic;
+
+    /* Current, requested and programmed depth, as an index in fifo_size_cfg */
+    uint8_t step;
+    volatile uint8_t next_step;
+    uint8_t programmed_step;
+
+    /* Largest step between consecutive samples since the last update */
+    uint8_t last_valid;
+    uint32_t activity;
+    uint32_t last_value;
+} fifo_controller_t;
+
+/* Controller state, kept in the non-initialized section so that the depth
+ * chosen survives the reset following a wakeup from sleep without retention,
+ * like the FIFO configuration of the sensor */
+static fifo_controller_t fifo_controller __attribute__ ((section(".noinit")));
+
+void FIFO_Controller_Init(void)
+{
+    fifo_controller.step = 0;
+
+    for (uint8_t i = 0; i < FIFO_CONTROLLER_STEPS; i++)
+    {
+        if (fifo_size_cfg[i] == FIFO_SIZE_VALUE)
+        {
+            fifo_controller.step = i;
+        }
+    }
+
+    fifo_controller.next_step = fifo_controller.step;
+    fifo_controller.programmed_step = FIFO_STEP_UNKNOWN;
+    fifo_controller.activity = 0;
+    fifo_controller.last_valid = false;
+    fifo_controller.magic = FIFO_CONTROLLER_MAGIC;
+}
+
+uint8_t FIFO_Controller_Restore(void)
+{
+    uint8_t valid = ((fifo_controller.magic == FIFO_CONTROLLER_MAGIC) &&
+                     (fifo_controller.step < FIFO_CONTROLLER_STEPS) &&
+                     (fifo_controller.next_step < FIFO_CONTROLLER_STEPS) &&
+                     ((fifo_controller.programmed_step < FIFO_CONTROLLER_STEPS) ||
+                      (fifo_controller.programmed_step == FIFO_STEP_UNKNOWN)));
+
+    if (!valid)
+    {
+        FIFO_Controller_Init();
+    }
+
+    return valid;
+}
+
+void FIFO_Controller_Sample(uint32_t value)
+{
+    uint32_t last = fifo_controller.last_value;
+
+    if (fifo_controller.last_valid)
+    {
+        uint32_t step = (value > last) ? (value - last) : (last - value);
+
+        if (step > fifo_controller.activity)
+        {
+            fifo_controller.activity = step;
+        }
+    }
+
+    fifo_controller.last_value = value;
+    fifo_controller.last_valid = true;
+}
+
+void FIFO_Controller_Update(void)
+{
+    uint32_t period = Sample_Buffer_Period();
+    uint32_t max_ticks = TIMEBASE_MS_TO_TICKS(FIFO_CONTROLLER_MAX_LATENCY_MS);
+    uint8_t step = fifo_controller.step;
+
+    /* Halve the depth on activity, double it while the signal is quiet */
+    if ((fifo_controller.activity > FIFO_CONTROLLER_ACTIVITY_HIGH) && (step > 0))
+    {
+        step--;
+    }
+    else if ((fifo_controller.activity < FIFO_CONTROLLER_ACTIVITY_LOW) && (step < (FIFO_CONTROLLER_STEPS - 1)))
+    {
+        step++;
+    }
+
+    fifo_controller.activity = 0;
+
+    /* A full FIFO must not hold samples older than the allowed latency */
+    if (period != 0)
+    {
+        while ((step > 0) && (((uint32_t)1 << step) * period > max_ticks))
+        {
+            step--;
+        }
+    }
+
+    fifo_controller.step = step;
+    fifo_controller.next_step = step;
+}
+
+void FIFO_Controller_Apply(void)
+{
+    uint8_t step = fifo_controller.next_step;
+
+    if (step != fifo_controller.programmed_step)
+    {
+        Sensor_FIFO_Resize(fifo_size_cfg[step]);
+        fifo_controller.programmed_step = step;
+    }
+}
@@ -0,0 +1,220 @@
+/**
+ * @file impedance.c
+ * @brief Impedance measurement
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "impedance.h"
+
+/* Number of CORDIC iterations, and fractional bits of the angles */
+#define IMPEDANCE_CORDIC_STEPS          15
+#define IMPEDANCE_ANGLE_FRAC            8
+
+/* Fractional bits added to the current steps before the CORDIC iterations */
+#define IMPEDANCE_CORDIC_SHIFT          12
+
+/* atan(2^-i) in hundredths of a degree, with IMPEDANCE_ANGLE_FRAC
+ * fractional bits */
+static const int32_t cordic_atan[IMPEDANCE_CORDIC_STEPS] =
+{
+    1152000, 680065, 359328, 182400, 91554, 45822, 22916, 11459,
+    5730, 2865, 1432, 716, 358, 179, 90
+};
+
+/* Identity calibration curve, loaded by Impedance_Init() */
+static const impedance_cal_point_t cal_identity[] =
+{
+    { 0,       0,       0 },
+    { 1000000, 1000000, 0 }
+};
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t count;
+    impedance_cal_point_t points[IMPEDANCE_CAL_POINTS_MAX];
+} impedance_cal_t;
+
+/* Calibration curve, kept in the non-initialized section so that a curve
+ * set by the application survives the reset following a wakeup from sleep
+ * without retention */
+static impedance_cal_t impedance_cal __attribute__ ((section(".noinit")));
+
+static impedance_result_t impedance_last;
+
+/**
+ * @brief      Angle of a vector with CORDIC iterations
+ * @param [in] y  Vertical component
+ * @param [in] x  Horizontal component, positive
+ * @return     atan(y / x) in hundredths of a degree
+ * @assumptions |x| and |y| below 2^16
+ */
+static int32_t Impedance_Atan2(int32_t y, int32_t x)
+{
+    int32_t angle = 0;
+
+    x <<= IMPEDANCE_CORDIC_SHIFT;
+    y <<= IMPEDANCE_CORDIC_SHIFT;
+
+    /* Rotate the vector onto the x axis, accumulating the rotation */
+    for (uint32_t i = 0; i < IMPEDANCE_CORDIC_STEPS; i++)
+    {
+        int32_t dx = x >> i;
+        int32_t dy = y >> i;
+
+        if (y > 0)
+        {
+            x += dy;
+            y -= dx;
+            angle += cordic_atan[i];
+        }
+        else
+        {
+            x -= dy;
+            y += dx;
+            angle -= cordic_atan[i];
+        }
+    }
+
+    return angle / (1 << IMPEDANCE_ANGLE_FRAC);
+}
+
+/**
+ * @brief      Linear interpolation between two calibration points
+ * @param [in] x   Position between x0 and x1 (or outside, to extrapolate)
+ * @param [in] x0  Start of the segment
+ * @param [in] x1  End of the segment, above x0
+ * @param [in] y0  Value at x0
+ * @param [in] y1  Value at x1
+ * @return     Interpolated value
+ */
+static int64_t Impedance_Interpolate(uint32_t x, uint32_t x0, uint32_t x1, int64_t y0, int64_t y1)
+{
+    return y0 + (((int64_t)x - x0) * (y1 - y0)) / ((int64_t)x1 - x0);
+}
+
+/**
+ * @brief      Check a calibration curve
+ * @param [in] points  Points
+ * @param [in] count   Number of points
+ * @return     true if the number of points is in range and the points are
+ *             sorted by increasing raw_ohm
+ */
+static uint8_t Impedance_Calibration_Valid(const impedance_cal_point_t *points, uint32_t count)
+{
+    if ((count < 2) || (count > IMPEDANCE_CAL_POINTS_MAX))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 1; i < count; i++)
+    {
+        if (points[i].raw_ohm <= points[i - 1].raw_ohm)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Impedance_Init(void)
+{
+    memcpy(impedance_cal.points, cal_identity, sizeof(cal_identity));
+    impedance_cal.count = sizeof(cal_identity) / sizeof(cal_identity[0]);
+    impedance_cal.magic = IMPEDANCE_CAL_MAGIC;
+}
+
+uint8_t Impedance_Restore(void)
+{
+    uint8_t valid = (impedance_cal.magic == IMPEDANCE_CAL_MAGIC) &&
+                    Impedance_Calibration_Valid(impedance_cal.points, impedance_cal.count);
+
+    if (!valid)
+    {
+        Impedance_Init();
+    }
+
+    return valid;
+}
+
+uint8_t Impedance_Measure(const sensor_sample_t *samples, impedance_result_t *result)
+{
+    const uint32_t last_pair = IMPEDANCE_CYCLE_SAMPLES - 2;
+    int32_t first = (int32_t)(samples[0].value - samples[1].value);
+    int32_t last = (int32_t)(samples[last_pair].value - samples[last_pair + 1].value);
+    const impedance_cal_point_t *p0;
+    const impedance_cal_point_t *p1;
+    uint64_t raw;
+    int64_t ohm;
+    int32_t phase;
+    uint32_t seg = 0;
+
+    if ((last <= 0) || (last >= 0x10000) || (first <= -0x10000) || (first >= 0x10000))
+    {
+        return IMPEDANCE_NO_SIGNAL;
+    }
+
+    /* Magnitude: voltage step over settled current step (uV / pA = Mohm) */
+    raw = ((uint64_t)IMPEDANCE_STEP_UV * 1000000) / ((uint64_t)last * IMPEDANCE_PA_PER_LSB);
+    if (raw > UINT32_MAX)
+    {
+        raw = UINT32_MAX;
+    }
+
+    /* Phase: the part of the first current step that has decayed is carried
+     * by the capacitive part of the load */
+    phase = -Impedance_Atan2(first - last, last);
+
+    /* Calibration segment containing the raw estimate, extrapolating from
+     * the first or last segment */
+    while (((seg + 2) < impedance_cal.count) &&
+           ((uint32_t)raw >= impedance_cal.points[seg + 1].raw_ohm))
+    {
+        seg++;
+    }
+    p0 = &impedance_cal.points[seg];
+    p1 = &impedance_cal.points[seg + 1];
+
+    ohm = Impedance_Interpolate((uint32_t)raw, p0->raw_ohm, p1->raw_ohm, p0->ohm, p1->ohm);
+    phase -= (int32_t)Impedance_Interpolate((uint32_t)raw, p0->raw_ohm, p1->raw_ohm,
+                                            p0->phase_offset_cdeg, p1->phase_offset_cdeg);
+
+    result->time = samples[0].time;
+    result->ohm = (ohm < 0) ? 0 : ((ohm > UINT32_MAX) ? UINT32_MAX : (uint32_t)ohm);
+    result->phase_cdeg = (int16_t)((phase > 18000) ? 18000 : ((phase < -18000) ? -18000 : phase));
+    impedance_last = *result;
+
+    return IMPEDANCE_NO_ERROR;
+}
+
+uint8_t Impedance_Calibration_Set(const impedance_cal_point_t *points, uint32_t count)
+{
+    if (!Impedance_Calibration_Valid(points, count))
+    {
+        return IMPEDANCE_INVALID;
+    }
+
+    memcpy(impedance_cal.points, points, count * sizeof(impedance_cal_point_t));
+    impedance_cal.count = count;
+    impedance_cal.magic = IMPEDANCE_CAL_MAGIC;
+
+    return IMPEDANCE_NO_ERROR;
+}
+
+const impedance_result_t *Impedance_Last(void)
+{
+    return &impedance_last;
+}
@@ -19,10 +19,38 @@
 /* sleep mode initialization variable */
 sleep_mode_cfg app_sleep_mode_cfg;
 
-void SoC_Sleep(void)
-{
-#if SLEEP_MODE_TEST == SLEEP_MODE_TEST_CORE_RETENTION
+/* Default wakeup event handlers; the flags are cleared by WAKEUP_IRQHandler
+ * before the handlers run, except for the baseband timer whose flag can only
+ * be cleared once the baseband has been woken up */
+#define WAKEUP_HANDLERS_DEFAULT \
+    { WAKEUP_GPIO1_EVENT_SET,      WAKEUP_GPIO1_EVENT_CLEAR,      WAKEUP_SRC_GPIO,       GPIO1_Wakeup_Process_Handler }, \
+    { WAKEUP_BB_TIMER_EVENT_SET,   0,                             WAKEUP_SRC_BB,         BB_Timer_Wakeup_Process_Handler }, \
+    { WAKEUP_FIFO_FULL_EVENT_SET,  WAKEUP_FIFO_FULL_EVENT_CLEAR,  WAKEUP_SRC_FIFO,       FIFO_Wakeup_Process_Handler }, \
+    { WAKEUP_THRESHOLD_EVENT_SET,  THRESHOLD_FULL_EVENT_CLEAR,    WAKEUP_SRC_ADC,        Threshold_Wakeup_Process_Handler }, \
+    { WAKEUP_RTC_ALARM_EVENT_SET,  WAKEUP_RTC_ALARM_EVENT_CLEAR,  WAKEUP_SRC_RTC_ALARM,  RTC_Alarm_Wakeup_Process_Handler }, \
+    { WAKEUP_NFC_FIELD_EVENT_SET,  WAKEUP_NFC_FIELD_EVENT_CLEAR,  WAKEUP_SRC_NFC,        NFC_Wakeup_Process_Handler }, \
+    { WAKEUP_SENSOR_DET_EVENT_SET, WAKEUP_SENSOR_DET_EVENT_CLEAR, WAKEUP_SRC_SENSOR_DET, Sensor_Detection_Wakeup_Process_Handler }
+
+_Static_assert((sizeof((wakeup_handler_t[]){ WAKEUP_HANDLERS_DEFAULT }) / sizeof(wakeup_handler_t)) ==
+               WAKEUP_HANDLER_DEFAULT_COUNT, "WAKEUP_HANDLER_DEFAULT_COUNT must match WAKEUP_HANDLERS_DEFAULT");
+
+/* Wakeup event handlers, starting with the default ones */
+static wakeup_handler_t wakeup_handlers[WAKEUP_HANDLER_MAX] = { WAKEUP_HANDLERS_DEFAULT };
+
+/* Number of entries used in wakeup_handlers */
+static uint32_t wakeup_handler_count = WAKEUP_HANDLER_DEFAULT_COUNT;
+
+/* Union of the event flags of all registered handlers */
+static uint32_t wakeup_event_mask = (WAKEUP_GPIO1_EVENT_SET     | WAKEUP_BB_TIMER_EVENT_SET  |
+                                     WAKEUP_FIFO_FULL_EVENT_SET | WAKEUP_THRESHOLD_EVENT_SET |
+                                     WAKEUP_RTC_ALARM_EVENT_SET | WAKEUP_NFC_FIELD_EVENT_SET |
+                                     WAKEUP_SENSOR_DET_EVENT_SET);
 
+/**
+ * @brief Enter sleep mode with core retention
+ */
+static void SoC_Sleep_CoreRetention(void)
+{
     /* Initialize sleep before entering sleep */
     Sys_PowerModes_Sleep_Init(&app_sleep_mode_cfg);
 
@@ -32,11 +60,21 @@ void SoC_Sleep(void)
     Sys_GPIO_Set_High(POWER_MODE_GPIO);
 #endif    /* if DEBUG_SLEEP_GPIO */
 
+    Metrics_SleepEnter(POWER_MODE_CORE_RETENTION);
+    Wakeup_Trace_Add(WAKEUP_TRACE_SLEEP_ENTRY, POWER_MODE_CORE_RETENTION, 0);
+
     /* Power Mode enter sleep with core retention */
     Sys_PowerModes_Sleep_Enter(&app_sleep_mode_cfg, SLEEP_CORE_RETENTION);
 
-#elif SLEEP_MODE_TEST == SLEEP_MODE_TEST_NO_RETENTION
+    Metrics_SleepExit();
+    Wakeup_Trace_Add(WAKEUP_TRACE_RESUME_RETENTION, 0, 0);
+}
 
+/**
+ * @brief Enter sleep mode without retention (wakeup through reset)
+ */
+static void SoC_Sleep_NoRetention(void)
+{
     /* Initialize sleep before entering sleep */
     Sys_PowerModes_Sleep_Init(&app_sleep_mode_cfg);
 
@@ -55,11 +93,18 @@ void SoC_Sleep(void)
     RESET->DIG_STATUS = (uint32_t)0xFFFF;
     ACS->RESET_STATUS = (uint32_t)0xFFFF;
 
+    Metrics_SleepEnter(POWER_MODE_NO_RETENTION);
+    Wakeup_Trace_Add(WAKEUP_TRACE_SLEEP_ENTRY, POWER_MODE_NO_RETENTION, 0);
+
     /* Power Mode enter sleep with memory retention */
     Sys_PowerModes_Sleep_Enter(&app_sleep_mode_cfg, SLEEP_NO_RETENTION);
+}
 
-#elif SLEEP_MODE_TEST == DEEP_SLEEP_TEST
-
+/**
+ * @brief Enter deep sleep (storage) mode
+ */
+static void SoC_DeepSleep(void)
+{
     /* Before activating the storage mode with active sensor detector
      * it has to be measured if the sensor indicates that no sensor is connected
      * if the sensor detected bit is high the software must immediately
@@ -89,10 +134,55 @@ void SoC_Sleep(void)
     RESET->DIG_STATUS = (uint32_t)0xFFFF;
     ACS->RESET_STATUS = (uint32_t)0xFFFF;
 
+    Metrics_SleepEnter(POWER_MODE_DEEP_SLEEP);
+    Wakeup_Trace_Add(WAKEUP_TRACE_SLEEP_ENTRY, POWER_MODE_DEEP_SLEEP, 0);
+
     /* Power Mode enter sleep with memory retention */
     Sys_PowerModes_DeepSleep_Enter((deepsleep_mode_cfg *)&app_sleep_mode_cfg);
+}
+
+void SoC_Sleep(void)
+{
+    /* Keep the 64-bit timebase up to date on every sleep cycle */
+    Timebase_Update();
+
+#if SLEEP_MODE_TEST == SLEEP_MODE_TEST_GOVERNOR
+
+    /* Pick the retention level from the time until the next deadline */
+    switch (Power_Governor_Select())
+    {
+        case POWER_MODE_DEEP_SLEEP:
+        {
+            SoC_DeepSleep();
+        }
+        break;
+
+        case POWER_MODE_NO_RETENTION:
+        {
+            SoC_Sleep_NoRetention();
+        }
+        break;
+
+        default:
+        {
+            SoC_Sleep_CoreRetention();
+        }
+        break;
+    }
+
+#elif SLEEP_MODE_TEST == SLEEP_MODE_TEST_CORE_RETENTION
+
+    SoC_Sleep_CoreRetention();
+
+#elif SLEEP_MODE_TEST == SLEEP_MODE_TEST_NO_RETENTION
+
+    SoC_Sleep_NoRetention();
+
+#elif SLEEP_MODE_TEST == DEEP_SLEEP_TEST
 
-#endif    /* if SLEEP_MODE_TEST == SLEEP_MODE_TEST_CORE_RETENTION */
+    SoC_DeepSleep();
+
+#endif    /* if SLEEP_MODE_TEST == SLEEP_MODE_TEST_GOVERNOR */
 }
 
 /**
@@ -100,51 +190,25 @@ void SoC_Sleep(void)
  */
 void FIFO_Wakeup_Process_Handler(void)
 {
-    WAKEUP_FIFO_FULL_FLAG_CLEAR();
-
 #if DEBUG_SLEEP_GPIO
     Sys_GPIO_Set_Low(WAKEUP_ACTIVITY_FIFO_FULL);
 #endif    /* DEBUG_SLEEP_GPIO */
 
-    /* The FIFO_LEVEL is asynchronous to the system clock it is recommended to
-     * read two consecutive times to check the consistency of the value */
-    uint8_t fifo_level = 0;
-    uint8_t previous_fifo_level = 0;
-    uint8_t i = 0;
-    uint8_t read_flag = false;
-
-    /* Read the first FIFO level to check if the level is equal to the FIFO size configured. */
-    fifo_level = (uint8_t)((SENSOR->FIFO_CFG & SENSOR_FIFO_CFG_FIFO_LEVEL_Mask) >> SENSOR_FIFO_CFG_FIFO_LEVEL_Pos);
-
-    do
-    {
-        previous_fifo_level = fifo_level;
+    /* The FIFO_LEVEL is asynchronous to the system clock: read it until two
+     * consecutive reads agree. If they never do, the last read is still a
+     * level the FIFO has reached, and the samples below it are valid */
+    uint32_t fifo_level;
 
-        /* Read FIFO_LEVEL for second time to check the consistency */
-        fifo_level = (uint8_t)(SENSOR->FIFO_CFG & SENSOR_FIFO_CFG_FIFO_LEVEL_Mask) >> SENSOR_FIFO_CFG_FIFO_LEVEL_Pos;
+    SENSOR_FIFO_LEVEL(&fifo_level);
 
-        /* Compare if consecutive read are equal */
-        if (previous_fifo_level == fifo_level)
-        {
-            read_flag = true;
-        }
+    /* Move the samples to the sample buffer, resetting the FIFO */
+    (void)Sample_Buffer_Drain(fifo_level);
 
-        i++;
-    }
-    while ((i < 10) && (!read_flag));
+    /* Change the FIFO depth while the FIFO is empty */
+    FIFO_Controller_Apply();
 
-    /* Force to reset FIFO in here */
-    SensorFIFO_Reset();
-
-#if DEBUG_SLEEP_GPIO
-
-    /* Toggle this pin 6 times to emulate application operations
-     * for FIFO wakeup in run mode */
-    for (uint8_t i = 0; i < 6; i++)
-    {
-        Sys_GPIO_Toggle(WAKEUP_ACTIVITY_FIFO_FULL);
-    }
-#endif    /* DEBUG_SLEEP_GPIO */
+    /* Leave the processing to the main loop */
+    Event_Signal(WAKEUP_SRC_FIFO, 0);
 }
 
 /**
@@ -152,165 +216,222 @@ void FIFO_Wakeup_Process_Handler(void)
  */
 void GPIO1_Wakeup_Process_Handler(void)
 {
-    WAKEUP_GPIO1_FLAG_CLEAR();
-
 #if DEBUG_SLEEP_GPIO
 
     Sys_GPIO_Set_Low(WAKEUP_ACTIVITY_GPIO);
-
-    /* Toggle this pin 6 times to emulate application operations
-     * for GPIO wakeup in run mode */
-    for (uint8_t i = 0; i < 6; i++)
-    {
-        Sys_GPIO_Toggle(WAKEUP_ACTIVITY_GPIO);
-    }
 #endif    /* DEBUG_SLEEP_GPIO */
+
+    Event_Signal(WAKEUP_SRC_GPIO, 0);
 }
 
 void RTC_Alarm_Wakeup_Process_Handler(void)
 {
-    WAKEUP_RTC_ALARM_FLAG_CLEAR();
-
 #if DEBUG_SLEEP_GPIO
 
     Sys_GPIO_Set_Low(WAKEUP_ACTIVITY_RTC);
-
-    /* Toggle this pin 6 times to emulate application operations
-     * for RTC wakeup in run mode */
-    for (uint8_t i = 0; i < 6; i++)
-    {
-        Sys_GPIO_Toggle(WAKEUP_ACTIVITY_RTC);
-    }
 #endif    /* DEBUG_SLEEP_GPIO */
 
-    wakeup_due_to_RTC = 1;
+    /* The expired software timers are run from the main loop */
+    Event_Signal(WAKEUP_SRC_RTC_ALARM, 0);
 }
 
 void NFC_Wakeup_Process_Handler(void)
 {
-    WAKEUP_NFC_FIELD_FLAG_CLEAR();
-
 #if DEBUG_SLEEP_GPIO
 
     Sys_GPIO_Set_Low(WAKEUP_ACTIVITY_NFC);
-
-    /* Toggle this pin 6 times to emulate application operations
-     * for NFC wakeup in run mode */
-    for (uint8_t i = 0; i < 6; i++)
-    {
-        Sys_GPIO_Toggle(WAKEUP_ACTIVITY_NFC);
-    }
 #endif    /* DEBUG_SLEEP_GPIO */
+
+    Event_Signal(WAKEUP_SRC_NFC, 0);
 }
 
 void Threshold_Wakeup_Process_Handler(void)
 {
-    WAKEUP_THRESHOLD_FULL_FLAG_CLEAR();
-
 #if DEBUG_SLEEP_GPIO
 
     Sys_GPIO_Set_Low(WAKEUP_ACTIVITY_THRESHOLD);
-
-    /* Toggle this pin 6 times to emulate application operations
-     * for ADC threshold wakeup in run mode */
-    for (uint8_t i = 0; i < 6; i++)
-    {
-        Sys_GPIO_Toggle(WAKEUP_ACTIVITY_THRESHOLD);
-    }
 #endif    /* DEBUG_SLEEP_GPIO */
+
+    /* Sample that crossed the threshold */
+    uint32_t value = SENSOR_ADC_DATA(0);
+
+    Metrics_RegAccess(1);
+
+    /* Disarm the threshold until the main loop has seen the signal */
+    Threshold_Manager_Trigger();
+
+    Event_Signal(WAKEUP_SRC_ADC, value);
 }
 
 void Sensor_Detection_Wakeup_Process_Handler(void)
 {
-	WAKEUP_SENSOR_DETECT_FLAG_CLEAR();
-
 #if DEBUG_SLEEP_GPIO
 
     Sys_GPIO_Set_Low(WAKEUP_ACTIVITY_SENSOR_DET);
-
-    /* Toggle this pin 6 times to emulate application operations
-     * for ADC threshold wakeup in run mode */
-    for (uint8_t i = 0; i < 6; i++)
-    {
-        Sys_GPIO_Toggle(WAKEUP_ACTIVITY_SENSOR_DET);
-    }
 #endif    /* DEBUG_SLEEP_GPIO */
-}
 
+    Event_Signal(WAKEUP_SRC_SENSOR_DET, 0);
+}
 
 /**
- * @brief   Wakeup IRQ interrupt handler
+ * @brief Baseband timer wakeup Handler routine
  */
-void WAKEUP_IRQHandler(void)
+void BB_Timer_Wakeup_Process_Handler(void)
 {
-    SYS_WATCHDOG_REFRESH();
+    NVIC_EnableIRQ(BLE_SLP_IRQn);
 
-    /* Call GPIO handler to process wakeup event */
-    if (ACS->WAKEUP_CTRL & WAKEUP_GPIO1_EVENT_SET)
-    {
-        GPIO1_Wakeup_Process_Handler();
-    }
+    BBIF->CTRL = (BB_CLK_ENABLE | BBCLK_DIVIDER_8 | BB_DEEP_SLEEP);
 
-    /* Call BBTimer handler to process wakeup event */
-    if (ACS->WAKEUP_CTRL & WAKEUP_BB_TIMER_EVENT_SET)
-    {
-        NVIC_EnableIRQ(BLE_SLP_IRQn);
+    /* Wakeup the BB timer intentionally */
+    BBIF->CTRL |= (BB_WAKEUP);
 
-        BBIF->CTRL = (BB_CLK_ENABLE | BBCLK_DIVIDER_8 | BB_DEEP_SLEEP);
+    Sys_Delay((SystemCoreClock / (32768)) * 2);
 
-        /* Wakeup the BB timer intentionally */
-        BBIF->CTRL |= (BB_WAKEUP);
+    while ((BBIF->STATUS & LOW_POWER_CLK) != MASTER_CLK)
+    {
+        SYS_WATCHDOG_REFRESH();
+    }
 
-        Sys_Delay((SystemCoreClock / (32768)) * 2);
+    BBIF->CTRL &= (~BB_WAKEUP);
 
-        while ((BBIF->STATUS & LOW_POWER_CLK) != MASTER_CLK)
-        {
-            SYS_WATCHDOG_REFRESH();
-        }
+    /* Re intialize BB Timer for next wakeup */
+    BB_Timer_Init();
 
-        BBIF->CTRL &= (~BB_WAKEUP);
+    /* Clear the BB Timer sticky flag */
+    WAKEUP_BB_TIMER_FLAG_CLEAR();
+}
 
-        /* Re intialize BB Timer for next wakeup */
-        BB_Timer_Init();
+uint8_t Wakeup_Handler_Register(uint32_t event, uint32_t clear, uint32_t src,
+                                void (*handler)(void))
+{
+    uint8_t status = WAKEUP_HANDLER_TABLE_FULL;
+    uint32_t i;
 
-        /* Clear the BB Timer sticky flag */
-        WAKEUP_BB_TIMER_FLAG_CLEAR();
-    }
+    GLOBAL_INT_DISABLE();
 
-    /* Call FIFO Handler to process wakeup event */
-    if (ACS->WAKEUP_CTRL & WAKEUP_FIFO_FULL_EVENT_SET)
+    /* Replace the handler already registered for this event, if any */
+    for (i = 0; i < wakeup_handler_count; i++)
     {
-        FIFO_Wakeup_Process_Handler();
+        if (wakeup_handlers[i].event == event)
+        {
+            break;
+        }
     }
 
-    if (ACS->WAKEUP_CTRL & WAKEUP_THRESHOLD_EVENT_SET)
+    if (handler == NULL)
     {
-        Threshold_Wakeup_Process_Handler();
-    }
+        /* Remove the handler, keeping the table packed */
+        if (i < wakeup_handler_count)
+        {
+            wakeup_handlers[i] = wakeup_handlers[--wakeup_handler_count];
+        }
 
-    if (ACS->WAKEUP_CTRL & WAKEUP_RTC_ALARM_EVENT_SET)
+        status = WAKEUP_HANDLER_NO_ERROR;
+    }
+    else if (i < WAKEUP_HANDLER_MAX)
     {
-        RTC_Alarm_Wakeup_Process_Handler();
+        wakeup_handlers[i].event = event;
+        wakeup_handlers[i].clear = clear;
+        wakeup_handlers[i].src = src;
+        wakeup_handlers[i].handler = handler;
+
+        if (i == wakeup_handler_count)
+        {
+            wakeup_handler_count++;
+        }
+
+        status = WAKEUP_HANDLER_NO_ERROR;
     }
 
-    if (ACS->WAKEUP_CTRL & WAKEUP_NFC_FIELD_EVENT_SET)
+    /* Only dispatch the events that still have a handler */
+    wakeup_event_mask = 0;
+    for (i = 0; i < wakeup_handler_count; i++)
     {
-        NFC_Wakeup_Process_Handler();
+        wakeup_event_mask |= wakeup_handlers[i].event;
     }
 
-    if (ACS->WAKEUP_CTRL & WAKEUP_SENSOR_DET_EVENT_SET)
+    GLOBAL_INT_RESTORE();
+
+    return status;
+}
+
+/**
+ * @brief   Wakeup IRQ interrupt handler
+ */
+void WAKEUP_IRQHandler(void)
+{
+    uint32_t irq_start __attribute__ ((unused)) = METRICS_CYCLES();
+    uint32_t handler_start __attribute__ ((unused));
+    uint32_t handled __attribute__ ((unused)) = 0;
+    wakeup_handler_t *pending_handlers[WAKEUP_HANDLER_MAX];
+    uint32_t pass;
+
+    SYS_WATCHDOG_REFRESH();
+
+    for (pass = 0; pass < WAKEUP_DISPATCH_MAX_PASS; pass++)
     {
-    	Sensor_Detection_Wakeup_Process_Handler();
+        /* Latch the sticky flags once per pass */
+        uint32_t events = (ACS->WAKEUP_CTRL | Benchmark_Take_Events()) & wakeup_event_mask;
+        uint32_t clear = 0;
+        uint32_t count = 0;
+
+        Metrics_RegAccess(1);
+
+        if (events == 0)
+        {
+            break;
+        }
+
+        /* Look up the handler of each event, lowest flag first */
+        while (events != 0)
+        {
+            uint32_t event = 1U << __CLZ(__RBIT(events));
+
+            for (uint32_t i = 0; i < wakeup_handler_count; i++)
+            {
+                if (wakeup_handlers[i].event == event)
+                {
+                    clear |= wakeup_handlers[i].clear;
+                    pending_handlers[count++] = &wakeup_handlers[i];
+                    break;
+                }
+            }
+
+            events &= ~event;
+        }
+
+        /* Clear all latched flags at once; an event raised while the
+         * handlers run is latched again on the next pass. Like the
+         * WAKEUP_*_FLAG_CLEAR() macros, use a read-modify-write so that
+         * any other field of WAKEUP_CTRL is left unchanged */
+        if (clear != 0)
+        {
+            ACS->WAKEUP_CTRL |= clear;
+            Metrics_RegAccess(2);
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            Metrics_Wakeup(pending_handlers[i]->src);
+            handler_start = METRICS_CYCLES();
+            pending_handlers[i]->handler();
+            Wakeup_Trace_Add(WAKEUP_TRACE_HANDLER, pending_handlers[i]->src,
+                             Wakeup_Trace_Duration(handler_start));
+            handled |= (WAKEUP_SRC_FLAG_BIT_SET << pending_handlers[i]->src);
+        }
     }
 
-    /* If there is an pending wakeup event set during the execution of this
-     * Wakeup interrupt handler. Set the NVIC WAKEUP_IRQn so that the pending wakeup
-     * event will be serviced again */
-    if (ACS->WAKEUP_CTRL)
+    /* Events still pending after the last pass are serviced on the next
+     * entry, letting lower priority interrupts run in between */
+    if (pass == WAKEUP_DISPATCH_MAX_PASS)
     {
-        if (!NVIC_GetPendingIRQ(WAKEUP_IRQn))
+        Metrics_RegAccess(1);
+        if (ACS->WAKEUP_CTRL & wakeup_event_mask)
         {
             NVIC_SetPendingIRQ(WAKEUP_IRQn);
         }
     }
+
+    Wakeup_Trace_Add(WAKEUP_TRACE_WAKEUP_IRQ, handled, Wakeup_Trace_Duration(irq_start));
+    Metrics_WakeupIRQ(irq_start);
 }
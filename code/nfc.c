@@ -9,7 +9,6 @@
 #include "iso14443.h"
 #include "nfc.h"
 
-extern uint8_t RAW_ARRAY[64];
 static inline uint8_t _isohf_getHFIORAMbyte_local(uint8_t offset)
 {
     return ((uint8_t *)(HF_IO_RAM_START_ADD))[offset];
@@ -20,11 +19,33 @@ static inline void _isohf_setHFIORAMbyte_local(uint8_t offset, uint8_t data)
     ((uint8_t *)(HF_IO_RAM_START_ADD))[offset] = data;
 }
 
+/* The IO RAM is accessed a word at a time where possible; the memory buffers
+ * may be unaligned, and are read with unaligned loads */
+static inline uint32_t _isohf_getHFIORAMword_local(uint32_t offset)
+{
+    return ((volatile uint32_t *)(HF_IO_RAM_START_ADD))[offset >> 2];
+}
+
+static inline void _isohf_setHFIORAMword_local(uint32_t offset, uint32_t data)
+{
+    ((volatile uint32_t *)(HF_IO_RAM_START_ADD))[offset >> 2] = data;
+}
+
 uint32_t _LLHW_isohf_compareIORAM2Mem_local(HFCTRL isohf,  uint8_t *pComp, uint32_t byte_size)
 {
-    uint32_t i;
+    uint32_t i = 0;
+
+    /* The comparison starts at the beginning of the IO RAM, which is word
+     * aligned: compare whole words, and stop at the first one that differs */
+    for (; (i + 4) <= byte_size; i += 4)
+    {
+        if (__UNALIGNED_UINT32_READ(&pComp[i]) != _isohf_getHFIORAMword_local(i))
+        {
+            return -1;
+        }
+    }
 
-    for (i = 0; i < byte_size; i++)
+    for (; i < byte_size; i++)
     {
         if (pComp[i] != _isohf_getHFIORAMbyte_local(i))
         {
@@ -36,11 +57,49 @@ uint32_t _LLHW_isohf_compareIORAM2Mem_local(HFCTRL isohf,  uint8_t *pComp, uint3
 
 void _LLHW_isohf_copyMem2IORAM_local(HFCTRL isohf, uint8_t *pSource, uint8_t offset, uint32_t bytesLength)
 {
-    uint32_t i;
+    uint32_t dest = offset;
+    uint32_t i = 0;
+
+    /* Head: bytes up to the first word boundary of the IO RAM */
+    for (; (i < bytesLength) && (dest & 0x3); i++, dest++)
+    {
+        _isohf_setHFIORAMbyte_local(dest, pSource[i]);
+    }
+
+    /* Body: whole words */
+    for (; (i + 4) <= bytesLength; i += 4, dest += 4)
+    {
+        _isohf_setHFIORAMword_local(dest, __UNALIGNED_UINT32_READ(&pSource[i]));
+    }
 
-    for (i = 0; i < bytesLength; i++)
+    /* Tail: remaining bytes */
+    for (; i < bytesLength; i++, dest++)
     {
-        _isohf_setHFIORAMbyte_local(offset + i, (uint8_t)pSource[i]);
+        _isohf_setHFIORAMbyte_local(dest, pSource[i]);
+    }
+}
+
+void _LLHW_isohf_copyIORAM2Mem_local(HFCTRL isohf, uint8_t *pDest, uint8_t offset, uint32_t bytesLength)
+{
+    uint32_t src = offset;
+    uint32_t i = 0;
+
+    /* Head: bytes up to the first word boundary of the IO RAM */
+    for (; (i < bytesLength) && (src & 0x3); i++, src++)
+    {
+        pDest[i] = _isohf_getHFIORAMbyte_local(src);
+    }
+
+    /* Body: whole words */
+    for (; (i + 4) <= bytesLength; i += 4, src += 4)
+    {
+        __UNALIGNED_UINT32_WRITE(&pDest[i], _isohf_getHFIORAMword_local(src));
+    }
+
+    /* Tail: remaining bytes */
+    for (; i < bytesLength; i++, src++)
+    {
+        pDest[i] = _isohf_getHFIORAMbyte_local(src);
     }
 }
 
@@ -60,18 +119,3 @@ void _isohf_configTypeALayer3BootAndWait_local(HFCTRL isohf, uint8_t *Layer3Sour
     /* Wait */
     _LLHW_isohf_waitForRx(isohf, 0x0);
 }
-
-/* read memory and copy data to array used to send the response */
-uint8_t read_block(uint8_t *ptr_resp, uint8_t *ptr_data)
-{
-    uint16_t start_index = 0;
-    uint16_t end_index = 0;
-    uint8_t i, j = 0;
-    start_index = ptr_data[1] * 4;            /* offset from command */
-    end_index = start_index + 16;           /* offset + 16bytes = end index */
-    for (i = start_index; i < end_index; i++)    /* copy all data from start index to end_index */
-    {
-        ptr_resp[j++] = RAW_ARRAY[i];
-    }
-    return j;
-}
@@ -0,0 +1,238 @@
+/**
+ * @file nfc_engine.c
+ * @brief Interrupt driven NFC transaction engine
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "nfc_engine.h"
+
+#if NFC_ENGINE_EN
+
+#if NFC_ISO4_EN
+#define NFC_ENGINE_DEFAULT_HANDLER      NFC_ISO4_Handler
+#else    /* if NFC_ISO4_EN */
+#define NFC_ENGINE_DEFAULT_HANDLER      NFC_Type2_Handler
+#endif    /* if NFC_ISO4_EN */
+
+static volatile uint8_t nfc_engine_state = NFC_ENGINE_STATE_OFF;
+static nfc_engine_handler_t nfc_engine_handler = NFC_ENGINE_DEFAULT_HANDLER;
+
+/* Idle timeout; retained like the timer heap (see sw_timer.h) */
+static sw_timer_t nfc_engine_timer __attribute__ ((section(".noinit")));
+
+/* Options of the response being sent */
+static uint32_t nfc_engine_back_to_halt;
+static volatile nfc_engine_sent_t nfc_engine_sent;
+
+/**
+ * @brief Forget the state of the protocol layers when a field appears or
+ *        disappears
+ */
+static void NFC_Engine_Reset(void)
+{
+    NFC_ISO4_Reset();
+    NFC_Type2_Reset();
+}
+
+/**
+ * @brief      No frame for NFC_ENGINE_IDLE_TIMEOUT_MS: the field is gone
+ * @param [in] arg  Unused
+ */
+static void NFC_Engine_Timeout_Callback(void *arg)
+{
+    (void)arg;
+
+    nfc_engine_state = NFC_ENGINE_STATE_OFF;
+    NFC_ISO4_Reset();
+}
+
+/**
+ * @brief Restart the idle timeout
+ */
+static void NFC_Engine_Activity(void)
+{
+    SW_Timer_Start(&nfc_engine_timer, TIMEBASE_MS_TO_TICKS(NFC_ENGINE_IDLE_TIMEOUT_MS), 0,
+                   NFC_Engine_Timeout_Callback, NULL);
+}
+
+/**
+ * @brief      Answer a received frame, or wait for the next one
+ * @param [in] size    Frame size in bytes
+ * @param [in] errors  Reception errors (HF_STATUS_ERR_RX bits)
+ */
+static void NFC_Engine_Respond(uint32_t size, uint32_t errors)
+{
+    uint32_t response_bits = 0;
+
+    nfc_engine_back_to_halt = 0;
+    nfc_engine_sent = NULL;
+
+    /* The frame is processed and answered in place in the IO RAM */
+    if ((errors == 0) && (size > 0) && (size <= NFC_ENGINE_FRAME_MAX))
+    {
+        response_bits = nfc_engine_handler((uint8_t *)HF_IO_RAM_START_ADD, size);
+    }
+
+    if ((response_bits > 0) && (response_bits <= (NFC_ENGINE_FRAME_MAX * 8)))
+    {
+        nfc_engine_state = NFC_ENGINE_STATE_TX;
+
+        if (nfc_engine_sent != NULL)
+        {
+            /* End the transaction with the response: the end of
+             * communication is raised once it is sent, and
+             * NFC_IRQHandler() releases the controller */
+            _LLHW_isohf_launchTxBits(HFCTRL_IP, 0, _LLHW_isohf_getSilentTime(HFCTRL_IP, NFC_ENGINE_MIN_SLOTS),
+                                     response_bits, HF_P_CTRL_ENDOFTRANSAC);
+        }
+        else
+        {
+            /* The controller turns around to reception once the response
+             * is sent, and raises the next end of communication on a new
+             * frame */
+            _LLHW_isohf_launchTxBits(HFCTRL_IP, nfc_engine_back_to_halt,
+                                     _LLHW_isohf_getSilentTime(HFCTRL_IP, NFC_ENGINE_MIN_SLOTS),
+                                     response_bits, 0);
+        }
+    }
+    else
+    {
+        nfc_engine_state = NFC_ENGINE_STATE_RX;
+        _LLHW_isohf_waitForRx(HFCTRL_IP, 0);
+    }
+}
+
+void NFC_Engine_Init(void)
+{
+    _isohf_clearStatus(HFCTRL_IP);
+    _isohf_clearRFONStatus(HFCTRL_IP);
+    _isohf_clearRFOFFStatus(HFCTRL_IP);
+
+    _isohf_enableEndOfComIt(HFCTRL_IP);
+    _isohf_enableRFONIt(HFCTRL_IP);
+    _isohf_enableRFOFFIt(HFCTRL_IP);
+
+    /* Same priority as WAKEUP_IRQn: both post to the event queue */
+    NVIC_ClearPendingIRQ(NFC_IRQn);
+    NVIC_SetPriority(NFC_IRQn, APP_IRQ_PRIORITY_EVENT);
+    NVIC_EnableIRQ(NFC_IRQn);
+}
+
+void NFC_Engine_Handler(nfc_engine_handler_t handler)
+{
+    nfc_engine_handler = (handler != NULL) ? handler : NFC_ENGINE_DEFAULT_HANDLER;
+}
+
+void NFC_Engine_Response_Options(uint32_t back_to_halt, nfc_engine_sent_t sent)
+{
+    nfc_engine_back_to_halt = back_to_halt;
+    nfc_engine_sent = sent;
+}
+
+void NFC_Engine_FieldOn(void)
+{
+    if (nfc_engine_state == NFC_ENGINE_STATE_OFF)
+    {
+        NFC_Engine_Reset();
+        nfc_engine_state = NFC_ENGINE_STATE_RX;
+    }
+
+    NFC_Engine_Activity();
+}
+
+void NFC_Engine_Process(const app_event_t *event)
+{
+    switch (event->arg)
+    {
+        case NFC_ENGINE_EVENT_FIELD_ON:
+        {
+            NFC_Engine_Reset();
+            NFC_Engine_Activity();
+        }
+        break;
+
+        case NFC_ENGINE_EVENT_FIELD_OFF:
+        {
+            SW_Timer_Stop(&nfc_engine_timer);
+            NFC_Engine_Reset();
+        }
+        break;
+
+        case NFC_ENGINE_EVENT_RX:
+        {
+            NFC_Engine_Respond(event->data, event->value);
+            NFC_Engine_Activity();
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+uint8_t NFC_Engine_Active(void)
+{
+    return (nfc_engine_state != NFC_ENGINE_STATE_OFF);
+}
+
+void NFC_IRQHandler(void)
+{
+    uint32_t status;
+    nfc_engine_sent_t sent;
+
+    /* With both field events pending, the field may be back: keep the
+     * engine active, the idle timeout covers the other case */
+    if (_isohf_getRFOFFStatus(HFCTRL_IP))
+    {
+        _isohf_clearRFOFFStatus(HFCTRL_IP);
+        nfc_engine_state = NFC_ENGINE_STATE_OFF;
+        Event_Post(EVENT_NFC, NFC_ENGINE_EVENT_FIELD_OFF, 0, 0);
+    }
+
+    if (_isohf_getRFONStatus(HFCTRL_IP))
+    {
+        _isohf_clearRFONStatus(HFCTRL_IP);
+        nfc_engine_state = NFC_ENGINE_STATE_RX;
+        Event_Post(EVENT_NFC, NFC_ENGINE_EVENT_FIELD_ON, 0, 0);
+    }
+
+    if (_isohf_getEndOfComStatus(HFCTRL_IP))
+    {
+        status = _isohf_getStatus(HFCTRL_IP);
+        _isohf_clearEndOfComStatus(HFCTRL_IP);
+
+        sent = nfc_engine_sent;
+        if ((nfc_engine_state == NFC_ENGINE_STATE_TX) && (sent != NULL))
+        {
+            /* End of a transaction: the response is sent, switch the
+             * controller before the next frame can arrive */
+            nfc_engine_sent = NULL;
+            sent();
+            nfc_engine_state = NFC_ENGINE_STATE_RX;
+            _LLHW_isohf_waitForRx(HFCTRL_IP, nfc_engine_back_to_halt);
+        }
+        else if (((status & HF_STATUS_COM_INFO_MASK) >> HF_STATUS_COM_INFO_SHIFT) == HF_STATUS_COM_EXEC)
+        {
+            /* The controller hands the IO RAM over once a frame is
+             * received; the end of a transmission needs no processing */
+            nfc_engine_state = NFC_ENGINE_STATE_EXEC;
+            Event_Post(EVENT_NFC, NFC_ENGINE_EVENT_RX,
+                       (status & HF_STATUS_RX_FRAME_SIZE_MASK) >> HF_STATUS_RX_FRAME_SIZE_SHIFT,
+                       status & HF_STATUS_ERR_RX_MASK);
+        }
+    }
+}
+
+#endif    /* if NFC_ENGINE_EN */
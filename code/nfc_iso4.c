@@ -0,0 +1,688 @@
+/**
+ * @file nfc_iso4.c
+ * @brief ISO/IEC 14443-4 block transmission protocol
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include <stddef.h>
+#include "app.h"
+#include "nfc_iso4.h"
+
+#if NFC_ISO4_EN
+
+/* RATS parameter and PPS parameters */
+#define NFC_ISO4_RATS_SIZE              2
+#define NFC_ISO4_FSDI_SHIFT             4
+#define NFC_ISO4_PPS_MIN_SIZE           2
+#define NFC_ISO4_PPS0_PPS1              0x10
+#define NFC_ISO4_PPS1_DSI_SHIFT         2
+#define NFC_ISO4_PPS1_D_MASK            0x3
+
+/* Supported divisors in TA(1), the same in both directions: DS and DR bits
+ * for 212 kbit/s onwards */
+#define NFC_ISO4_TA1                    (((1 << NFC_ISO4_BIT_RATE_MAX) - 1) * 0x11)
+
+/* Format byte T0: TA(1), TB(1) and TC(1) present; TB(1) holds the frame
+ * waiting time and start-up frame guard time integers */
+#define NFC_ISO4_T0                     (0x70 | NFC_ISO4_FSCI)
+#define NFC_ISO4_TB1                    ((NFC_ISO4_FWI << 4) | NFC_ISO4_SFGI)
+
+/* Protocol control byte and CRC around the information field */
+#define NFC_ISO4_FRAME_OVERHEAD         3
+
+/* Command APDU header: CLA, INS, P1 and P2, followed by Lc when the command
+ * carries data */
+#define NFC_ISO4_APDU_HEADER_SIZE       4
+#define NFC_ISO4_APDU_LC                NFC_ISO4_APDU_HEADER_SIZE
+#define NFC_ISO4_APDU_DATA              (NFC_ISO4_APDU_HEADER_SIZE + 1)
+
+/* SELECT by file identifier with no response data */
+#define NFC_ISO4_SELECT_NO_FCI          0x0C
+#define NFC_ISO4_FILE_ID_SIZE           2
+
+/* Capability container of the NDEF application: CCLEN, mapping version 2.0,
+ * largest READ BINARY response (MLe) and command data (MLc), then a file
+ * control TLV for the NDEF file and one for the sample log file, both read
+ * only */
+#define NFC_ISO4_CC_SIZE                23
+#define NFC_ISO4_MAPPING_VERSION        0x20
+#define NFC_ISO4_MLE                    (NFC_ISO4_RESPONSE_MAX - 2)
+#define NFC_ISO4_MLC                    (NFC_ISO4_COMMAND_MAX - NFC_ISO4_APDU_DATA - 1)
+#define NFC_ISO4_TLV_NDEF_FILE          0x04
+#define NFC_ISO4_TLV_PROPRIETARY_FILE   0x05
+#define NFC_ISO4_FILE_CONTROL_SIZE      6
+#define NFC_ISO4_ACCESS_GRANTED         0x00
+#define NFC_ISO4_ACCESS_DENIED          0xFF
+
+/* NDEF file: NLEN, then the NDEF message */
+#define NFC_ISO4_NLEN_SIZE              2
+#define NFC_ISO4_NDEF_FILE_MAX          (NFC_ISO4_NLEN_SIZE + NFC_TYPE2_DATA_SIZE)
+
+/* 16-bit field, most significant byte first */
+#define NFC_ISO4_U16(x)                 (uint8_t)((x) >> 8), (uint8_t)(x)
+
+/* Rx decoder thresholds per bit rate: the 106 kbit/s reset values scaled to
+ * the shorter pauses at 212 and 424 kbit/s; characterize on the target board */
+#define NFC_ISO4_RX_CNT0(shift)         (((DEC_TH_0_RST_VAL >> (shift)) << HF_DIG_CNT0_SHIFT) | \
+                                         ((DEC_TH_1_RST_VAL >> (shift)) << HF_DIG_CNT1_SHIFT))
+#define NFC_ISO4_RX_CNT1(shift)         (((DEC_TH_2_RST_VAL >> (shift)) << HF_DIG_CNT2_SHIFT) | \
+                                         ((DEC_TH_3_RST_VAL >> (shift)) << HF_DIG_CNT3_SHIFT))
+
+static uint32_t nfc_iso4_rx_config[3][2] =
+{
+    { HFCTRL_DIGITAL_CNT0_RST_VAL, HFCTRL_DIGITAL_CNT1_RST_VAL },
+    { NFC_ISO4_RX_CNT0(1), NFC_ISO4_RX_CNT1(1) },
+    { NFC_ISO4_RX_CNT0(2), NFC_ISO4_RX_CNT1(2) }
+};
+
+/* Maximum frame size of the reader, CRC included, indexed by FSDI */
+static const uint16_t nfc_iso4_fsd[] = { 16, 24, 32, 40, 48, 64, 96, 128, 256 };
+
+/* File of the default APDU handler: a head part followed by a body part, so
+ * that the NDEF file reads as NLEN then the NDEF message in place */
+typedef struct
+{
+    const uint8_t *head;
+    uint32_t head_size;
+    const uint8_t *body;
+    uint32_t body_size;
+} nfc_iso4_file_t;
+
+/* Name of the NFC Forum Type 4 Tag NDEF application */
+static const uint8_t nfc_iso4_ndef_aid[] = { 0xD2, 0x76, 0x00, 0x00, 0x85, 0x01, 0x01 };
+
+static const uint8_t nfc_iso4_cc[NFC_ISO4_CC_SIZE] =
+{
+    NFC_ISO4_U16(NFC_ISO4_CC_SIZE),
+    NFC_ISO4_MAPPING_VERSION,
+    NFC_ISO4_U16(NFC_ISO4_MLE),
+    NFC_ISO4_U16(NFC_ISO4_MLC),
+    NFC_ISO4_TLV_NDEF_FILE, NFC_ISO4_FILE_CONTROL_SIZE,
+    NFC_ISO4_U16(NFC_ISO4_FILE_NDEF),
+    NFC_ISO4_U16(NFC_ISO4_NDEF_FILE_MAX),
+    NFC_ISO4_ACCESS_GRANTED, NFC_ISO4_ACCESS_DENIED,
+    NFC_ISO4_TLV_PROPRIETARY_FILE, NFC_ISO4_FILE_CONTROL_SIZE,
+    NFC_ISO4_U16(NFC_ISO4_FILE_SAMPLE_LOG),
+    NFC_ISO4_U16(sizeof(sample_log_t)),
+    NFC_ISO4_ACCESS_GRANTED, NFC_ISO4_ACCESS_DENIED
+};
+
+static uint32_t NFC_ISO4_Default_APDU(const uint8_t *command, uint32_t length, uint8_t *response);
+
+static nfc_iso4_apdu_handler_t nfc_iso4_apdu_handler = NFC_ISO4_Default_APDU;
+
+/* Layer 3 configuration of the IO RAM, overwritten by frames larger than
+ * NFC_ENGINE_L3_FRAME_MAX once activated */
+static uint8_t nfc_iso4_layer3[HF_IO_RAM_INIT_ISOALAYER3];
+
+/* Protocol state: activated by RATS, PPS accepted as the first block only,
+ * current block number and bit rates requested by PPS */
+static uint8_t nfc_iso4_active;
+static uint8_t nfc_iso4_pps_allowed;
+static uint8_t nfc_iso4_block;
+static uint8_t nfc_iso4_dsi;
+static uint8_t nfc_iso4_dri;
+
+/* Largest information field sent, bounded by the reader frame size */
+static uint32_t nfc_iso4_inf_max;
+
+/* Command APDU being received through chaining */
+static uint8_t nfc_iso4_command[NFC_ISO4_COMMAND_MAX];
+static uint32_t nfc_iso4_command_length;
+static uint8_t nfc_iso4_command_overflow;
+
+/* Default APDU handler: NDEF application selected, file selected
+ * (NFC_ISO4_FILE_*) and NLEN of the NDEF file */
+static uint8_t nfc_iso4_ndef_selected;
+static uint16_t nfc_iso4_file;
+static uint8_t nfc_iso4_nlen[NFC_ISO4_NLEN_SIZE];
+
+/* Response APDU, and last block sent: protocol control byte and part of the
+ * response carried, so that it can be sent again */
+static uint8_t nfc_iso4_response[NFC_ISO4_RESPONSE_MAX];
+static uint32_t nfc_iso4_response_length;
+static uint8_t nfc_iso4_last_pcb;
+static uint32_t nfc_iso4_last_offset;
+static uint32_t nfc_iso4_last_length;
+
+/**
+ * @brief      Select the bit rate of each direction
+ * @param [in] dsi  Divisor from the tag to the reader (0 = 106 kbit/s)
+ * @param [in] dri  Divisor from the reader to the tag (0 = 106 kbit/s)
+ */
+static void NFC_ISO4_Set_Bit_Rate(uint32_t dsi, uint32_t dri)
+{
+    /* The Tx configuration clears the other fields of the register, such
+     * as the rebound filter set by NFC_Init() */
+    uint32_t others = _isohf_getDigitalCfg(HFCTRL_IP) & ~(HF_DIG_CFG_BIT_RATE_MASK | HF_DIG_CFG_COD_TYPE_MASK);
+
+    _LLHW_isohf_configTxDig4TypeA(HFCTRL_IP, dsi);
+    _isohf_setDigitalCfg(HFCTRL_IP, _isohf_getDigitalCfg(HFCTRL_IP) | others);
+    _LLHW_isohf_configRxDig4TypeA(HFCTRL_IP, dri, nfc_iso4_rx_config);
+}
+
+/**
+ * @brief Switch to the bit rates requested by PPS, once the response is
+ *        sent at the previous bit rates
+ */
+static void NFC_ISO4_PPS_Sent(void)
+{
+    NFC_ISO4_Set_Bit_Rate(nfc_iso4_dsi, nfc_iso4_dri);
+}
+
+/**
+ * @brief Go back to Layer 3 once the DESELECT response is sent
+ */
+static void NFC_ISO4_Deselect_Sent(void)
+{
+    NFC_ISO4_Reset();
+}
+
+/**
+ * @brief          Answer RATS with the ATS and enter ISO/IEC 14443-4
+ * @param [in,out] frame  RATS, ATS written over it
+ * @return         Response size in bits
+ */
+static uint32_t NFC_ISO4_Activate(uint8_t *frame)
+{
+    uint32_t fsdi = frame[1] >> NFC_ISO4_FSDI_SHIFT;
+    uint32_t fsd = nfc_iso4_fsd[(fsdi < sizeof(nfc_iso4_fsd) / sizeof(nfc_iso4_fsd[0])) ?
+                                fsdi : (sizeof(nfc_iso4_fsd) / sizeof(nfc_iso4_fsd[0]) - 1)];
+
+    if (fsd > NFC_ENGINE_FRAME_MAX)
+    {
+        fsd = NFC_ENGINE_FRAME_MAX;
+    }
+    nfc_iso4_inf_max = fsd - NFC_ISO4_FRAME_OVERHEAD;
+
+    /* Save the Layer 3 configuration before larger frames overwrite it */
+    _LLHW_isohf_copyIORAM2Mem_local(HFCTRL_IP, nfc_iso4_layer3, (uint8_t)(HF_IO_RAM_EMPTY_OFFSET >> 2),
+                                    HF_IO_RAM_INIT_ISOALAYER3);
+    _isohf_setProtocolIgnoreReqA(HFCTRL_IP);
+    _isohf_setProtocolTypeALayer4(HFCTRL_IP);
+
+    nfc_iso4_active = 1;
+    nfc_iso4_pps_allowed = 1;
+    nfc_iso4_block = 1;
+    nfc_iso4_command_length = 0;
+    nfc_iso4_command_overflow = 0;
+    nfc_iso4_response_length = 0;
+    nfc_iso4_last_pcb = 0;
+
+    frame[0] = NFC_ISO4_ATS_SIZE;
+    frame[1] = NFC_ISO4_T0;
+    frame[2] = NFC_ISO4_TA1;
+    frame[3] = NFC_ISO4_TB1;
+    frame[4] = 0x00;
+
+    return NFC_ISO4_ATS_SIZE * 8;
+}
+
+/**
+ * @brief          Answer PPS and switch the bit rates once answered
+ * @param [in,out] frame  PPS, response written over it
+ * @param [in]     size   Frame size in bytes
+ * @return         Response size in bits, 0 if the parameters are not
+ *                 supported
+ */
+static uint32_t NFC_ISO4_PPS(uint8_t *frame, uint32_t size)
+{
+    uint32_t dsi = 0;
+    uint32_t dri = 0;
+
+    if (size < NFC_ISO4_PPS_MIN_SIZE)
+    {
+        return 0;
+    }
+
+    if (frame[1] & NFC_ISO4_PPS0_PPS1)
+    {
+        if (size <= NFC_ISO4_PPS_MIN_SIZE)
+        {
+            return 0;
+        }
+        dsi = (frame[2] >> NFC_ISO4_PPS1_DSI_SHIFT) & NFC_ISO4_PPS1_D_MASK;
+        dri = frame[2] & NFC_ISO4_PPS1_D_MASK;
+    }
+
+    if ((dsi > NFC_ISO4_BIT_RATE_MAX) || (dri > NFC_ISO4_BIT_RATE_MAX))
+    {
+        return 0;
+    }
+
+    nfc_iso4_dsi = (uint8_t)dsi;
+    nfc_iso4_dri = (uint8_t)dri;
+    NFC_Engine_Response_Options(0, NFC_ISO4_PPS_Sent);
+
+    /* The response is the start byte alone */
+    return 8;
+}
+
+/**
+ * @brief          Send the last block again
+ * @param [in,out] frame  Response written over it
+ * @return         Response size in bits
+ */
+static uint32_t NFC_ISO4_Resend(uint8_t *frame)
+{
+    frame[0] = nfc_iso4_last_pcb;
+    _LLHW_isohf_copyMem2IORAM_local(HFCTRL_IP, &nfc_iso4_response[nfc_iso4_last_offset],
+                                    (uint8_t)(frame - (uint8_t *)HF_IO_RAM_START_ADD) + 1,
+                                    nfc_iso4_last_length);
+
+    return (1 + nfc_iso4_last_length) * 8;
+}
+
+/**
+ * @brief          Send the next part of the response, chained if it does not
+ *                 fit in a frame of the reader
+ * @param [in,out] frame  Response written over it
+ * @return         Response size in bits
+ */
+static uint32_t NFC_ISO4_Send_Next(uint8_t *frame)
+{
+    uint32_t offset = nfc_iso4_last_offset + nfc_iso4_last_length;
+    uint32_t length = nfc_iso4_response_length - offset;
+
+    nfc_iso4_last_pcb = NFC_ISO4_PCB_I | nfc_iso4_block;
+    if (length > nfc_iso4_inf_max)
+    {
+        length = nfc_iso4_inf_max;
+        nfc_iso4_last_pcb |= NFC_ISO4_PCB_CHAINING;
+    }
+    nfc_iso4_last_offset = offset;
+    nfc_iso4_last_length = length;
+
+    return NFC_ISO4_Resend(frame);
+}
+
+/**
+ * @brief          Send an R(ACK) block
+ * @param [in,out] frame  Response written over it
+ * @return         Response size in bits
+ */
+static uint32_t NFC_ISO4_Send_ACK(uint8_t *frame)
+{
+    nfc_iso4_last_pcb = NFC_ISO4_PCB_R | nfc_iso4_block;
+    nfc_iso4_last_offset = 0;
+    nfc_iso4_last_length = 0;
+
+    return NFC_ISO4_Resend(frame);
+}
+
+/**
+ * @brief          Process an I-block: store the information field, and
+ *                 acknowledge it if chained or execute the command APDU
+ * @param [in,out] frame  I-block, response written over it
+ * @param [in]     size   Frame size in bytes
+ * @return         Response size in bits
+ */
+static uint32_t NFC_ISO4_I_Block(uint8_t *frame, uint32_t size)
+{
+    uint32_t length = size - 1;
+
+    nfc_iso4_block ^= NFC_ISO4_PCB_BLOCK_NUM;
+
+    /* The information field is copied with word accesses; a command that
+     * does not fit is rejected once completely received */
+    if ((nfc_iso4_command_length + length) <= NFC_ISO4_COMMAND_MAX)
+    {
+        _LLHW_isohf_copyIORAM2Mem_local(HFCTRL_IP, &nfc_iso4_command[nfc_iso4_command_length],
+                                        (uint8_t)(frame - (uint8_t *)HF_IO_RAM_START_ADD) + 1, length);
+        nfc_iso4_command_length += length;
+    }
+    else
+    {
+        nfc_iso4_command_overflow = 1;
+    }
+
+    if (frame[0] & NFC_ISO4_PCB_CHAINING)
+    {
+        return NFC_ISO4_Send_ACK(frame);
+    }
+
+    if (nfc_iso4_command_overflow)
+    {
+        nfc_iso4_response[0] = (uint8_t)(NFC_ISO4_SW_WRONG_LENGTH >> 8);
+        nfc_iso4_response[1] = (uint8_t)(NFC_ISO4_SW_WRONG_LENGTH);
+        nfc_iso4_response_length = 2;
+    }
+    else
+    {
+        nfc_iso4_response_length = nfc_iso4_apdu_handler(nfc_iso4_command, nfc_iso4_command_length,
+                                                         nfc_iso4_response);
+    }
+    nfc_iso4_command_length = 0;
+    nfc_iso4_command_overflow = 0;
+
+    nfc_iso4_last_offset = 0;
+    nfc_iso4_last_length = 0;
+
+    return NFC_ISO4_Send_Next(frame);
+}
+
+/**
+ * @brief          Process an R-block: send the next part of a chained
+ *                 response, or the last block again
+ * @param [in,out] frame  R-block, response written over it
+ * @return         Response size in bits, 0 to send no response
+ */
+static uint32_t NFC_ISO4_R_Block(uint8_t *frame)
+{
+    uint8_t same_block = ((frame[0] & NFC_ISO4_PCB_BLOCK_NUM) == nfc_iso4_block);
+
+    if (frame[0] & NFC_ISO4_PCB_NAK)
+    {
+        return same_block ? NFC_ISO4_Resend(frame) : NFC_ISO4_Send_ACK(frame);
+    }
+
+    if (same_block)
+    {
+        return NFC_ISO4_Resend(frame);
+    }
+
+    /* R(ACK) of the previous part of a chained response */
+    if (((nfc_iso4_last_pcb & NFC_ISO4_PCB_I_MASK) == NFC_ISO4_PCB_I) &&
+        (nfc_iso4_last_pcb & NFC_ISO4_PCB_CHAINING))
+    {
+        nfc_iso4_block ^= NFC_ISO4_PCB_BLOCK_NUM;
+        return NFC_ISO4_Send_Next(frame);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief      SELECT the NDEF application by name, or one of its files by
+ *             identifier once the application is selected
+ * @param [in] command  Command APDU
+ * @param [in] length   Command size in bytes
+ * @return     Status word
+ */
+static uint32_t NFC_ISO4_Select(const uint8_t *command, uint32_t length)
+{
+    uint32_t lc;
+    uint32_t id;
+
+    if (length <= NFC_ISO4_APDU_LC)
+    {
+        return NFC_ISO4_SW_WRONG_LENGTH;
+    }
+
+    /* Lc and the data, optionally followed by Le */
+    lc = command[NFC_ISO4_APDU_LC];
+    if ((lc == 0) || ((length != (NFC_ISO4_APDU_DATA + lc)) && (length != (NFC_ISO4_APDU_DATA + lc + 1))))
+    {
+        return NFC_ISO4_SW_WRONG_LENGTH;
+    }
+
+    if (command[2] == NFC_ISO4_SELECT_BY_NAME)
+    {
+        nfc_iso4_file = NFC_ISO4_FILE_NONE;
+        nfc_iso4_ndef_selected = ((lc == sizeof(nfc_iso4_ndef_aid)) &&
+                                  (memcmp(&command[NFC_ISO4_APDU_DATA], nfc_iso4_ndef_aid, lc) == 0));
+
+        return nfc_iso4_ndef_selected ? NFC_ISO4_SW_OK : NFC_ISO4_SW_FILE_NOT_FOUND;
+    }
+
+    if ((command[2] != NFC_ISO4_SELECT_BY_ID) || (command[3] != NFC_ISO4_SELECT_NO_FCI))
+    {
+        return NFC_ISO4_SW_WRONG_P1_P2;
+    }
+
+    if (lc != NFC_ISO4_FILE_ID_SIZE)
+    {
+        return NFC_ISO4_SW_WRONG_LENGTH;
+    }
+
+    id = ((uint32_t)command[NFC_ISO4_APDU_DATA] << 8) | command[NFC_ISO4_APDU_DATA + 1];
+    if (!nfc_iso4_ndef_selected ||
+        ((id != NFC_ISO4_FILE_CC) && (id != NFC_ISO4_FILE_NDEF) && (id != NFC_ISO4_FILE_SAMPLE_LOG)))
+    {
+        return NFC_ISO4_SW_FILE_NOT_FOUND;
+    }
+
+    nfc_iso4_file = (uint16_t)id;
+
+    return NFC_ISO4_SW_OK;
+}
+
+/**
+ * @brief       Locate the content of the file selected
+ * @param [out] file  Head and body of the file; both empty if no file is
+ *                    selected
+ */
+static void NFC_ISO4_File(nfc_iso4_file_t *file)
+{
+    memset(file, 0, sizeof(*file));
+
+    switch (nfc_iso4_file)
+    {
+        case NFC_ISO4_FILE_CC:
+        {
+            file->body = nfc_iso4_cc;
+            file->body_size = sizeof(nfc_iso4_cc);
+        }
+        break;
+
+        case NFC_ISO4_FILE_NDEF:
+        {
+            /* The Type 2 Tag memory may have been written by the
+             * application or by a reader since the last command */
+            file->body_size = NFC_Type2_NDEF_Message(&file->body);
+            nfc_iso4_nlen[0] = (uint8_t)(file->body_size >> 8);
+            nfc_iso4_nlen[1] = (uint8_t)file->body_size;
+            file->head = nfc_iso4_nlen;
+            file->head_size = NFC_ISO4_NLEN_SIZE;
+        }
+        break;
+
+        case NFC_ISO4_FILE_SAMPLE_LOG:
+        {
+            /* Up to the last byte used */
+            file->body = (const uint8_t *)&sample_log;
+            file->body_size = offsetof(sample_log_t, data) + sample_log.length;
+        }
+        break;
+
+        default:
+        {
+        }
+        break;
+    }
+}
+
+/**
+ * @brief       READ BINARY on the file selected, offset in P1 and P2
+ * @param [in]  command   Command APDU
+ * @param [in]  length    Command size in bytes
+ * @param [out] response  Data read
+ * @param [out] size      Number of bytes read
+ * @return      Status word
+ */
+static uint32_t NFC_ISO4_Read_Binary(const uint8_t *command, uint32_t length, uint8_t *response,
+                                     uint32_t *size)
+{
+    nfc_iso4_file_t file;
+    uint32_t offset;
+    uint32_t end;
+    uint32_t head;
+    uint32_t le;
+    uint32_t sw = NFC_ISO4_SW_OK;
+
+    if (length > (NFC_ISO4_APDU_HEADER_SIZE + 1))
+    {
+        return NFC_ISO4_SW_WRONG_LENGTH;
+    }
+
+    if (nfc_iso4_file == NFC_ISO4_FILE_NONE)
+    {
+        return NFC_ISO4_SW_NO_CURRENT_EF;
+    }
+
+    NFC_ISO4_File(&file);
+    end = file.head_size + file.body_size;
+    offset = ((uint32_t)(command[2] & 0x7F) << 8) | command[3];
+    if (offset > end)
+    {
+        return NFC_ISO4_SW_WRONG_OFFSET;
+    }
+
+    /* Le absent or 0 asks for up to 256 bytes */
+    le = (length > NFC_ISO4_APDU_HEADER_SIZE) ? command[NFC_ISO4_APDU_HEADER_SIZE] : 0;
+    if (le == 0)
+    {
+        le = NFC_ISO4_RESPONSE_MAX - 2;
+    }
+
+    *size = end - offset;
+    if (*size >= le)
+    {
+        *size = le;
+    }
+    else
+    {
+        sw = NFC_ISO4_SW_END_OF_FILE;
+    }
+
+    head = (offset < file.head_size) ? (file.head_size - offset) : 0;
+    if (head > *size)
+    {
+        head = *size;
+    }
+    if (head != 0)
+    {
+        memcpy(response, file.head + offset, head);
+    }
+    if (*size > head)
+    {
+        memcpy(response + head, file.body + (offset + head - file.head_size), *size - head);
+    }
+
+    return sw;
+}
+
+/**
+ * @brief       Default APDU handler: NFC Forum Type 4 Tag NDEF application,
+ *              with SELECT of the application and of its files, and READ
+ *              BINARY on the file selected
+ * @param [in]  command   Command APDU
+ * @param [in]  length    Command size in bytes
+ * @param [out] response  Response APDU
+ * @return      Response size in bytes
+ */
+static uint32_t NFC_ISO4_Default_APDU(const uint8_t *command, uint32_t length, uint8_t *response)
+{
+    uint32_t size = 0;
+    uint32_t sw;
+
+    if (length < NFC_ISO4_APDU_HEADER_SIZE)
+    {
+        sw = NFC_ISO4_SW_WRONG_LENGTH;
+    }
+    else if (command[0] != 0x00)
+    {
+        sw = NFC_ISO4_SW_CLA_NOT_SUPPORTED;
+    }
+    else if (command[1] == NFC_ISO4_INS_SELECT)
+    {
+        sw = NFC_ISO4_Select(command, length);
+    }
+    else if (command[1] == NFC_ISO4_INS_READ_BINARY)
+    {
+        sw = NFC_ISO4_Read_Binary(command, length, response, &size);
+    }
+    else
+    {
+        sw = NFC_ISO4_SW_INS_NOT_SUPPORTED;
+    }
+
+    response[size] = (uint8_t)(sw >> 8);
+    response[size + 1] = (uint8_t)sw;
+
+    return size + 2;
+}
+
+void NFC_ISO4_APDU_Handler(nfc_iso4_apdu_handler_t handler)
+{
+    nfc_iso4_apdu_handler = (handler != NULL) ? handler : NFC_ISO4_Default_APDU;
+}
+
+void NFC_ISO4_Reset(void)
+{
+    nfc_iso4_ndef_selected = 0;
+    nfc_iso4_file = NFC_ISO4_FILE_NONE;
+    nfc_iso4_pps_allowed = 0;
+    nfc_iso4_command_length = 0;
+    nfc_iso4_command_overflow = 0;
+
+    if (nfc_iso4_active)
+    {
+        nfc_iso4_active = 0;
+        _isohf_resetProtocolTypeALayer4(HFCTRL_IP);
+        NFC_ISO4_Set_Bit_Rate(0, 0);
+        _LLHW_isohf_configIORAM4TypeALayer3_local(HFCTRL_IP, nfc_iso4_layer3);
+    }
+}
+
+uint32_t NFC_ISO4_Handler(uint8_t *frame, uint32_t size)
+{
+    uint8_t pcb = frame[0];
+    uint8_t pps_allowed = nfc_iso4_pps_allowed;
+
+    if (!nfc_iso4_active)
+    {
+        if ((size == NFC_ISO4_RATS_SIZE) && (pcb == NFC_ISO4_RATS))
+        {
+            return NFC_ISO4_Activate(frame);
+        }
+
+        return NFC_Type2_Handler(frame, size);
+    }
+
+    nfc_iso4_pps_allowed = 0;
+    if (pps_allowed && ((pcb & NFC_ISO4_PPSS_MASK) == NFC_ISO4_PPSS))
+    {
+        return NFC_ISO4_PPS(frame, size);
+    }
+
+    /* CID and NAD were not announced in the ATS: blocks carrying them are
+     * ignored */
+    if (pcb & (NFC_ISO4_PCB_CID | NFC_ISO4_PCB_NAD))
+    {
+        return 0;
+    }
+
+    if ((pcb & NFC_ISO4_PCB_I_MASK) == NFC_ISO4_PCB_I)
+    {
+        return NFC_ISO4_I_Block(frame, size);
+    }
+
+    if ((pcb & NFC_ISO4_PCB_R_MASK) == NFC_ISO4_PCB_R)
+    {
+        return NFC_ISO4_R_Block(frame);
+    }
+
+    if ((pcb & NFC_ISO4_PCB_S_MASK) == NFC_ISO4_PCB_S_DESELECT)
+    {
+        /* The response is the DESELECT itself; the controller then goes
+         * back to the HALT state at 106 kbit/s */
+        NFC_Engine_Response_Options(HF_P_CTRL_BACK2HALT, NFC_ISO4_Deselect_Sent);
+        return 8;
+    }
+
+    return 0;
+}
+
+#endif    /* if NFC_ISO4_EN */
@@ -0,0 +1,420 @@
+/**
+ * @file nfc_type2.c
+ * @brief NFC Forum Type 2 Tag memory emulation
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include <stddef.h>
+#include "app.h"
+#include "nfc_type2.h"
+
+/* Byte offset of the static lock bytes */
+#define NFC_TYPE2_LOCK_OFFSET           ((NFC_TYPE2_LOCK_PAGE * NFC_TYPE2_PAGE_SIZE) + 2)
+
+/* No COMPATIBILITY WRITE in progress */
+#define NFC_TYPE2_NO_PAGE               0xFFFFFFFF
+
+/* Size of the SECTOR_SELECT second part, holding the sector number */
+#define NFC_TYPE2_SECTOR_SELECT_SIZE    4
+
+/* Empty NDEF message TLV followed by the terminator TLV */
+static const uint8_t nfc_type2_empty_ndef[] = { 0x03, 0x00, 0xFE };
+
+extern uint8_t RAW_ARRAY[64];
+
+nfc_type2_t nfc_type2 __attribute__ ((section(".noinit")));
+
+/* Page addressed by the first part of a COMPATIBILITY WRITE */
+static uint32_t nfc_type2_comp_write_page = NFC_TYPE2_NO_PAGE;
+
+/* Sector selected with SECTOR_SELECT, and first part of a SECTOR_SELECT
+ * received */
+static uint8_t nfc_type2_sector;
+static uint8_t nfc_type2_sector_select;
+
+/**
+ * @brief  Number of sectors: the tag memory, then the sample log
+ * @return Number of sectors
+ */
+static uint32_t NFC_Type2_Sectors(void)
+{
+#if NFC_TYPE2_LOG_EN
+    return NFC_TYPE2_LOG_SECTOR + ((sizeof(sample_log) + (NFC_TYPE2_SECTOR_PAGES * NFC_TYPE2_PAGE_SIZE) - 1) /
+                                   (NFC_TYPE2_SECTOR_PAGES * NFC_TYPE2_PAGE_SIZE));
+#else    /* if NFC_TYPE2_LOG_EN */
+    return 1;
+#endif    /* if NFC_TYPE2_LOG_EN */
+}
+
+/**
+ * @brief      Copy pages of the selected sector to the IO RAM
+ * @param [in] page    First page
+ * @param [in] count   Number of pages
+ * @param [in] offset  IO RAM offset of the response
+ * @return     Response size in bits
+ * @assumptions page + count is at most NFC_TYPE2_PAGES in the tag memory
+ *              sector; in the sample log sectors, pages past the end of a
+ *              sector continue into the next one
+ */
+static uint32_t NFC_Type2_Read_Pages(uint32_t page, uint32_t count, uint8_t offset)
+{
+    uint32_t size = count * NFC_TYPE2_PAGE_SIZE;
+
+#if NFC_TYPE2_LOG_EN
+    if (nfc_type2_sector >= NFC_TYPE2_LOG_SECTOR)
+    {
+        /* The log is only exported up to its last byte used; the rest of
+         * the sectors reads as zeros */
+        uint32_t start = (((nfc_type2_sector - NFC_TYPE2_LOG_SECTOR) * NFC_TYPE2_SECTOR_PAGES) + page) *
+                         NFC_TYPE2_PAGE_SIZE;
+        uint32_t end = offsetof(sample_log_t, data) + sample_log.length;
+        uint32_t used = (start < end) ? (end - start) : 0;
+
+        if (used > size)
+        {
+            used = size;
+        }
+
+        _LLHW_isohf_copyMem2IORAM_local(HFCTRL_IP, (uint8_t *)&sample_log + start, offset, used);
+        memset((uint8_t *)HF_IO_RAM_START_ADD + offset + used, 0, size - used);
+
+        return size * 8;
+    }
+#endif    /* if NFC_TYPE2_LOG_EN */
+
+    _LLHW_isohf_copyMem2IORAM_local(HFCTRL_IP, &nfc_type2.data[page * NFC_TYPE2_PAGE_SIZE], offset, size);
+
+    return size * 8;
+}
+
+/**
+ * @brief  GET_VERSION storage size byte: the 7 upper bits give n, the
+ *         data area holds 2^n bytes, or between 2^n and 2^(n+1) bytes if
+ *         the last bit is set
+ * @return Storage size byte
+ */
+static uint8_t NFC_Type2_Storage_Size(void)
+{
+    uint32_t n = 31 - __CLZ(NFC_TYPE2_DATA_SIZE);
+
+    return (uint8_t)((n << 1) | ((NFC_TYPE2_DATA_SIZE & (NFC_TYPE2_DATA_SIZE - 1)) != 0));
+}
+
+/**
+ * @brief      Check if a page is write protected by the static lock bytes
+ * @param [in] page  Page number
+ * @return     1 if the page cannot be written, 0 otherwise
+ */
+static uint8_t NFC_Type2_Locked(uint32_t page)
+{
+    uint32_t lock = nfc_type2.data[NFC_TYPE2_LOCK_OFFSET] |
+                    (nfc_type2.data[NFC_TYPE2_LOCK_OFFSET + 1] << 8);
+
+    if (page < NFC_TYPE2_CC_PAGE)
+    {
+        return 1;
+    }
+
+    /* Bit n locks page n, from the capability container to page 15 */
+    if (page < NFC_TYPE2_STATIC_LOCK_PAGES)
+    {
+        return (lock >> page) & 0x1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief      Write a page received from a reader
+ * @param [in] page  Page number
+ * @param [in] data  Page data, in the IO RAM
+ * @return     NFC_TYPE2_ACK or a NAK code
+ */
+static uint8_t NFC_Type2_Write_Page(uint32_t page, uint8_t *data)
+{
+    uint8_t *dest;
+
+    if (page >= NFC_TYPE2_PAGES)
+    {
+        return NFC_TYPE2_NAK_ARGUMENT;
+    }
+    dest = &nfc_type2.data[page * NFC_TYPE2_PAGE_SIZE];
+
+    /* The lock bytes and the capability container are one-time
+     * programmable: bits can be set but not cleared */
+    if (page == NFC_TYPE2_LOCK_PAGE)
+    {
+        dest[2] |= data[2];
+        dest[3] |= data[3];
+        return NFC_TYPE2_ACK;
+    }
+
+    if (NFC_Type2_Locked(page))
+    {
+        return NFC_TYPE2_NAK_WRITE;
+    }
+
+    if (page == NFC_TYPE2_CC_PAGE)
+    {
+        for (uint32_t i = 0; i < NFC_TYPE2_PAGE_SIZE; i++)
+        {
+            dest[i] |= data[i];
+        }
+        return NFC_TYPE2_ACK;
+    }
+
+    memcpy(dest, data, NFC_TYPE2_PAGE_SIZE);
+
+    return NFC_TYPE2_ACK;
+}
+
+void NFC_Type2_Init(void)
+{
+    uint8_t *cc = &nfc_type2.data[NFC_TYPE2_CC_PAGE * NFC_TYPE2_PAGE_SIZE];
+
+    if (nfc_type2.magic == NFC_TYPE2_MAGIC)
+    {
+        return;
+    }
+
+    memset(nfc_type2.data, 0, sizeof(nfc_type2.data));
+    memcpy(nfc_type2.data, RAW_ARRAY, sizeof(RAW_ARRAY));
+
+    if (cc[0] != NFC_TYPE2_CC_MAGIC)
+    {
+        cc[0] = NFC_TYPE2_CC_MAGIC;
+        cc[1] = NFC_TYPE2_CC_VERSION;
+        cc[2] = (uint8_t)(NFC_TYPE2_DATA_SIZE / 8);
+        cc[3] = NFC_TYPE2_CC_ACCESS;
+        memcpy(&nfc_type2.data[NFC_TYPE2_DATA_OFFSET], nfc_type2_empty_ndef, sizeof(nfc_type2_empty_ndef));
+    }
+
+    nfc_type2.magic = NFC_TYPE2_MAGIC;
+}
+
+void NFC_Type2_Reset(void)
+{
+    nfc_type2_sector = 0;
+    nfc_type2_sector_select = 0;
+    nfc_type2_comp_write_page = NFC_TYPE2_NO_PAGE;
+}
+
+uint8_t NFC_Type2_Write(uint32_t page, const uint8_t *data, uint32_t length)
+{
+    if ((page >= NFC_TYPE2_PAGES) ||
+        (length > ((NFC_TYPE2_PAGES - page) * NFC_TYPE2_PAGE_SIZE)))
+    {
+        return NFC_TYPE2_INVALID;
+    }
+
+    memcpy(&nfc_type2.data[page * NFC_TYPE2_PAGE_SIZE], data, length);
+
+    return NFC_TYPE2_NO_ERROR;
+}
+
+uint32_t NFC_Type2_NDEF_Message(const uint8_t **message)
+{
+    uint32_t offset = NFC_TYPE2_DATA_OFFSET;
+    uint32_t end = NFC_TYPE2_DATA_OFFSET + NFC_TYPE2_DATA_SIZE;
+    uint32_t length;
+    uint8_t type;
+
+    /* Walk the TLV blocks, skipping the NULL TLVs and the control TLVs
+     * written by a reader ahead of the NDEF message */
+    while (offset < end)
+    {
+        type = nfc_type2.data[offset++];
+        if (type == NFC_TYPE2_TLV_NULL)
+        {
+            continue;
+        }
+
+        if ((type == NFC_TYPE2_TLV_TERMINATOR) || (offset >= end))
+        {
+            break;
+        }
+
+        length = nfc_type2.data[offset++];
+        if (length == NFC_TYPE2_TLV_LENGTH_3_BYTES)
+        {
+            if ((end - offset) < 2)
+            {
+                break;
+            }
+            length = ((uint32_t)nfc_type2.data[offset] << 8) | nfc_type2.data[offset + 1];
+            offset += 2;
+        }
+
+        if (length > (end - offset))
+        {
+            break;
+        }
+
+        if (type == NFC_TYPE2_TLV_NDEF)
+        {
+            *message = &nfc_type2.data[offset];
+            return length;
+        }
+        offset += length;
+    }
+
+    return 0;
+}
+
+uint32_t NFC_Type2_Handler(uint8_t *frame, uint32_t size)
+{
+    uint8_t offset = (uint8_t)(frame - (uint8_t *)HF_IO_RAM_START_ADD);
+    uint32_t comp_write_page = nfc_type2_comp_write_page;
+    uint8_t sector_select = nfc_type2_sector_select;
+    uint32_t last = (nfc_type2_sector == 0) ? NFC_TYPE2_PAGES : NFC_TYPE2_SECTOR_PAGES;
+    uint32_t page;
+
+    /* Any frame ends a COMPATIBILITY WRITE or a SECTOR_SELECT */
+    nfc_type2_comp_write_page = NFC_TYPE2_NO_PAGE;
+    nfc_type2_sector_select = 0;
+
+    /* Second part of a SECTOR_SELECT: the sector number, acknowledged by
+     * not responding */
+    if (sector_select)
+    {
+        if ((size == NFC_TYPE2_SECTOR_SELECT_SIZE) && (frame[0] < NFC_Type2_Sectors()))
+        {
+            nfc_type2_sector = frame[0];
+            return 0;
+        }
+
+        frame[0] = NFC_TYPE2_NAK_ARGUMENT;
+        return NFC_TYPE2_ACK_BITS;
+    }
+
+    /* Second part of a COMPATIBILITY WRITE: 16 bytes, of which only the
+     * first page is written */
+    if (comp_write_page != NFC_TYPE2_NO_PAGE)
+    {
+        if (size != (NFC_TYPE2_READ_PAGES * NFC_TYPE2_PAGE_SIZE))
+        {
+            frame[0] = NFC_TYPE2_NAK_ARGUMENT;
+            return NFC_TYPE2_ACK_BITS;
+        }
+
+        frame[0] = NFC_Type2_Write_Page(comp_write_page, frame);
+        return NFC_TYPE2_ACK_BITS;
+    }
+
+    if (size < 1)
+    {
+        return 0;
+    }
+
+    switch (frame[0])
+    {
+        case NFC_TYPE2_CMD_READ:
+        {
+            page = frame[1];
+            if ((size != 2) || (page >= last))
+            {
+                break;
+            }
+
+            /* Copy the pages straight to the IO RAM, over the command; the
+             * tag memory wraps around at its end */
+            if ((nfc_type2_sector != 0) || ((page + NFC_TYPE2_READ_PAGES) <= last))
+            {
+                return NFC_Type2_Read_Pages(page, NFC_TYPE2_READ_PAGES, offset);
+            }
+            else
+            {
+                uint32_t head = last - page;
+
+                NFC_Type2_Read_Pages(page, head, offset);
+                NFC_Type2_Read_Pages(0, NFC_TYPE2_READ_PAGES - head, (uint8_t)(offset + (head * NFC_TYPE2_PAGE_SIZE)));
+                return NFC_TYPE2_READ_PAGES * NFC_TYPE2_PAGE_SIZE * 8;
+            }
+        }
+
+        case NFC_TYPE2_CMD_FAST_READ:
+        {
+            /* Pages from the start address to the end address included,
+             * in one frame */
+            page = frame[1];
+            if ((size != 3) || (page > frame[2]) || (frame[2] >= last) ||
+                ((uint32_t)(frame[2] - page) >= NFC_TYPE2_FAST_READ_PAGES))
+            {
+                break;
+            }
+
+            return NFC_Type2_Read_Pages(page, frame[2] - page + 1, offset);
+        }
+
+        case NFC_TYPE2_CMD_WRITE:
+        {
+            /* The sample log is read only */
+            if ((size != (2 + NFC_TYPE2_PAGE_SIZE)) || (nfc_type2_sector != 0))
+            {
+                break;
+            }
+
+            frame[0] = NFC_Type2_Write_Page(frame[1], &frame[2]);
+            return NFC_TYPE2_ACK_BITS;
+        }
+
+        case NFC_TYPE2_CMD_COMP_WRITE:
+        {
+            if ((size != 2) || (frame[1] >= NFC_TYPE2_PAGES) || (nfc_type2_sector != 0))
+            {
+                break;
+            }
+
+            nfc_type2_comp_write_page = frame[1];
+            frame[0] = NFC_TYPE2_ACK;
+            return NFC_TYPE2_ACK_BITS;
+        }
+
+        case NFC_TYPE2_CMD_SECTOR_SELECT:
+        {
+            if ((size != 2) || (frame[1] != 0xFF))
+            {
+                break;
+            }
+
+            nfc_type2_sector_select = 1;
+            frame[0] = NFC_TYPE2_ACK;
+            return NFC_TYPE2_ACK_BITS;
+        }
+
+        case NFC_TYPE2_CMD_GET_VERSION:
+        {
+            if (size != 1)
+            {
+                break;
+            }
+
+            frame[0] = 0x00;
+            frame[1] = NFC_TYPE2_VENDOR_ID;
+            frame[2] = NFC_TYPE2_PRODUCT_TYPE;
+            frame[3] = NFC_TYPE2_PRODUCT_SUBTYPE;
+            frame[4] = NFC_TYPE2_VERSION_MAJOR;
+            frame[5] = NFC_TYPE2_VERSION_MINOR;
+            frame[6] = NFC_Type2_Storage_Size();
+            frame[7] = NFC_TYPE2_PROTOCOL;
+            return NFC_TYPE2_VERSION_SIZE * 8;
+        }
+
+        default:
+        break;
+    }
+
+    frame[0] = NFC_TYPE2_NAK_ARGUMENT;
+    return NFC_TYPE2_ACK_BITS;
+}
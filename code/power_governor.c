@@ -0,0 +1,133 @@
+/**
+ * @file power_governor.c
+ * @brief Runtime power mode selection
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "power_governor.h"
+
+/* Wakeup sources that can end a sleep at a known time */
+#define WAKEUP_SRC_TIMED_MSK    ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_RTC_ALARM) | \
+                                 (WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_BB))
+
+/* Wakeup sources that cannot wake the device from deep sleep */
+#define WAKEUP_SRC_NO_DEEP_SLEEP_MSK  (WAKEUP_SRC_TIMED_MSK                              | \
+                                       (WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_FIFO)       | \
+                                       (WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_ADC))
+
+/* Break-even time of each power mode in RTC clock cycles */
+static uint32_t break_even[POWER_MODE_COUNT] =
+{
+    POWER_GOVERNOR_BREAK_EVEN_CORE_RETENTION,
+    POWER_GOVERNOR_BREAK_EVEN_NO_RETENTION,
+    POWER_GOVERNOR_BREAK_EVEN_DEEP_SLEEP
+};
+
+/* Deepest power mode the application currently allows */
+static power_mode_t deepest_allowed = POWER_MODE_DEEP_SLEEP;
+
+/* Subsystems that need the core retained; not retained itself, since none of
+ * them can be active after a wakeup with reset */
+static volatile uint32_t hold_mask;
+
+uint32_t Power_Governor_NextDeadline(void)
+{
+    uint32_t deadline = POWER_GOVERNOR_NO_DEADLINE;
+
+    /* Work is already waiting: the sleep will end immediately */
+    if ((NVIC->ISER[0] & NVIC->ISPR[0]) || (NVIC->ISER[1] & NVIC->ISPR[1]))
+    {
+        return 0;
+    }
+
+    if ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_RTC_ALARM) & WAKEUP_SRC_EN_MSK)
+    {
+        /* The RTC counts down to the alarm at zero */
+        Async_Read_RTC_Count(&deadline);
+    }
+
+    if ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_BB) & WAKEUP_SRC_EN_MSK)
+    {
+        /* The baseband timer cannot be read back while it is isolated;
+         * use its configured period as the estimate */
+        uint32_t bb_period = BB_DEEP_SLEEP_TIME >> BB_DEEPSLWKUP_DEEPSLTIME_Pos;
+
+        if (bb_period < deadline)
+        {
+            deadline = bb_period;
+        }
+    }
+
+    return deadline;
+}
+
+power_mode_t Power_Governor_Select(void)
+{
+    uint32_t deadline = Power_Governor_NextDeadline();
+    power_mode_t mode = POWER_MODE_CORE_RETENTION;
+
+    if (deadline >= break_even[POWER_MODE_NO_RETENTION])
+    {
+        mode = POWER_MODE_NO_RETENTION;
+    }
+
+    /* Deep sleep only wakes up on GPIO, NFC field or sensor detection, so it
+     * is only usable when none of the other sources have been enabled */
+    if ((deadline == POWER_GOVERNOR_NO_DEADLINE) &&
+        (deadline >= break_even[POWER_MODE_DEEP_SLEEP]) &&
+        !(WAKEUP_SRC_EN_MSK & WAKEUP_SRC_NO_DEEP_SLEEP_MSK))
+    {
+        mode = POWER_MODE_DEEP_SLEEP;
+    }
+
+    if (mode > deepest_allowed)
+    {
+        mode = deepest_allowed;
+    }
+
+    if (hold_mask && (mode > POWER_MODE_CORE_RETENTION))
+    {
+        mode = POWER_MODE_CORE_RETENTION;
+    }
+
+    return mode;
+}
+
+void Power_Governor_SetBreakEven(power_mode_t mode, uint32_t ticks)
+{
+    if (mode < POWER_MODE_COUNT)
+    {
+        break_even[mode] = ticks;
+    }
+}
+
+void Power_Governor_Limit(power_mode_t deepest)
+{
+    deepest_allowed = deepest;
+}
+
+void Power_Governor_Hold(uint32_t holder)
+{
+    GLOBAL_INT_DISABLE();
+    hold_mask |= holder;
+    GLOBAL_INT_RESTORE();
+}
+
+void Power_Governor_Release(uint32_t holder)
+{
+    GLOBAL_INT_DISABLE();
+    hold_mask &= ~holder;
+    GLOBAL_INT_RESTORE();
+}
@@ -0,0 +1,122 @@
+/**
+ * @file sample_buffer.c
+ * @brief Retained sensor sample buffer
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "sample_buffer.h"
+
+/* Sample buffer, kept in the non-initialized section so that samples not yet
+ * processed survive the reset following a wakeup from sleep without retention */
+sample_buffer_t sample_buffer __attribute__ ((section(".noinit")));
+
+void Sample_Buffer_Init(void)
+{
+    if (sample_buffer.magic != SAMPLE_BUFFER_MAGIC)
+    {
+        memset(&sample_buffer, 0, sizeof(sample_buffer));
+        sample_buffer.magic = SAMPLE_BUFFER_MAGIC;
+    }
+}
+
+uint32_t Sample_Buffer_Drain(uint32_t level)
+{
+    uint32_t now = (uint32_t)Timebase_Ticks();
+    uint32_t head = sample_buffer.head;
+    uint32_t free = SAMPLE_BUFFER_LENGTH - (head - sample_buffer.tail);
+    uint32_t stored;
+    uint32_t oldest;
+
+    if (level > ADC_DATA_LENGTH)
+    {
+        level = ADC_DATA_LENGTH;
+    }
+
+    /* The samples were taken at a regular interval, the last one just
+     * before the wakeup: estimate the interval from the previous drain */
+    if ((level > 0) && (sample_buffer.last_drain != 0))
+    {
+        sample_buffer.period = (now - sample_buffer.last_drain) / level;
+    }
+    sample_buffer.last_drain = now;
+
+    stored = (level < free) ? level : free;
+    sample_buffer.dropped += level - stored;
+
+    /* Reading ADC_DATA[0] resets the FIFO, so read the samples from the
+     * newest to the oldest */
+    for (uint32_t i = level; i-- > 1; )
+    {
+        uint32_t value = SENSOR_ADC_DATA(i);
+
+        if (i < stored)
+        {
+            sensor_sample_t *sample = &sample_buffer.samples[(head + i) & (SAMPLE_BUFFER_LENGTH - 1)];
+
+            sample->value = value;
+            sample->time = now - ((level - 1 - i) * sample_buffer.period);
+        }
+    }
+
+    oldest = SENSOR_ADC_DATA(0);
+    Metrics_RegAccess((level > 0) ? level : 1);
+
+    if (stored > 0)
+    {
+        sensor_sample_t *sample = &sample_buffer.samples[head & (SAMPLE_BUFFER_LENGTH - 1)];
+
+        sample->value = oldest;
+        sample->time = now - ((level - 1) * sample_buffer.period);
+
+        /* Publish the samples only once they are completely written */
+        __DMB();
+        sample_buffer.head = head + stored;
+    }
+
+    return stored;
+}
+
+uint8_t Sample_Buffer_Get(sensor_sample_t *sample)
+{
+    uint32_t tail = sample_buffer.tail;
+
+    if (tail == sample_buffer.head)
+    {
+        return 0;
+    }
+
+    __DMB();
+    *sample = sample_buffer.samples[tail & (SAMPLE_BUFFER_LENGTH - 1)];
+
+    __DMB();
+    sample_buffer.tail = tail + 1;
+
+    return 1;
+}
+
+uint32_t Sample_Buffer_Count(void)
+{
+    return sample_buffer.head - sample_buffer.tail;
+}
+
+uint32_t Sample_Buffer_Period(void)
+{
+    return sample_buffer.period;
+}
+
+uint32_t Sample_Buffer_Dropped(void)
+{
+    return sample_buffer.dropped;
+}
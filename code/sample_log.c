@@ -0,0 +1,203 @@
+/**
+ * @file sample_log.c
+ * @brief Compressed sensor sample log
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "sample_log.h"
+
+/* Sample log, kept in the non-initialized section so that it survives the
+ * reset following a wakeup from sleep without retention */
+sample_log_t sample_log __attribute__ ((section(".noinit")));
+
+/* Bit writer over the log data */
+typedef struct
+{
+    uint8_t *data;
+    uint32_t acc;
+    uint32_t bits;
+} bit_writer_t;
+
+/**
+ * @brief      Append bits, most significant first
+ * @param [in] writer  Bit writer
+ * @param [in] value   Bits to write, right aligned
+ * @param [in] bits    Number of bits to write (at most 24)
+ */
+static inline void Bit_Write(bit_writer_t *writer, uint32_t value, uint32_t bits)
+{
+    writer->acc = (writer->acc << bits) | (value & ((1U << bits) - 1));
+    writer->bits += bits;
+
+    while (writer->bits >= 8)
+    {
+        writer->bits -= 8;
+        *writer->data++ = (uint8_t)(writer->acc >> writer->bits);
+    }
+}
+
+/**
+ * @brief      Store a 32-bit value in little endian order
+ * @param [in] data   Destination
+ * @param [in] value  Value to store
+ */
+static void Sample_Log_Put32(uint8_t *data, uint32_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+    data[2] = (uint8_t)(value >> 16);
+    data[3] = (uint8_t)(value >> 24);
+}
+
+/**
+ * @brief      Compress one block of samples
+ * @param [in] samples  Samples, oldest first
+ * @param [in] count    Number of samples (1 to SAMPLE_LOG_BLOCK_SAMPLES)
+ * @return     1 if the block was appended, 0 if it does not fit in the log
+ */
+static uint8_t Sample_Log_Block(const sensor_sample_t *samples, uint32_t count)
+{
+    uint32_t zigzag[SAMPLE_LOG_BLOCK_SAMPLES];
+    uint32_t sum = 0;
+    uint32_t bits = 0;
+    uint32_t period = 0;
+    uint32_t k = 0;
+    uint32_t size;
+    uint8_t *block;
+    bit_writer_t writer;
+
+    /* Zig-zag encoded differences: small differences of either sign give
+     * small codes */
+    for (uint32_t i = 1; i < count; i++)
+    {
+        int32_t delta = (int32_t)(samples[i].value - samples[i - 1].value);
+
+        zigzag[i] = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+        sum += (zigzag[i] > 0x00FFFFFF) ? 0x00FFFFFF : zigzag[i];
+    }
+
+    /* Rice parameter close to log2 of the mean difference */
+    if (count > 1)
+    {
+        uint32_t mean = sum / (count - 1);
+
+        k = (mean > 0) ? (31 - __CLZ(mean)) : 0;
+        period = (samples[count - 1].time - samples[0].time) / (count - 1);
+    }
+
+    for (uint32_t i = 1; i < count; i++)
+    {
+        uint32_t q = zigzag[i] >> k;
+
+        bits += (q < SAMPLE_LOG_RICE_ESCAPE) ? (q + 1 + k) : (SAMPLE_LOG_RICE_ESCAPE + 32);
+    }
+
+    size = SAMPLE_LOG_BLOCK_HEADER_SIZE + ((bits + 7) / 8);
+    if (size > (SAMPLE_LOG_SIZE - sample_log.length))
+    {
+        return 0;
+    }
+
+    block = &sample_log.data[sample_log.length];
+    block[0] = (uint8_t)count;
+    block[1] = (uint8_t)k;
+    Sample_Log_Put32(&block[2], samples[0].time);
+    Sample_Log_Put32(&block[6], period);
+    Sample_Log_Put32(&block[10], samples[0].value);
+
+    writer.data = &block[SAMPLE_LOG_BLOCK_HEADER_SIZE];
+    writer.acc = 0;
+    writer.bits = 0;
+
+    for (uint32_t i = 1; i < count; i++)
+    {
+        uint32_t q = zigzag[i] >> k;
+
+        if (q < SAMPLE_LOG_RICE_ESCAPE)
+        {
+            /* Quotient in unary, terminated by a zero, then k bits */
+            Bit_Write(&writer, (1U << (q + 1)) - 2, q + 1);
+            if (k > 0)
+            {
+                Bit_Write(&writer, zigzag[i], k);
+            }
+        }
+        else
+        {
+            Bit_Write(&writer, (1U << SAMPLE_LOG_RICE_ESCAPE) - 1, SAMPLE_LOG_RICE_ESCAPE);
+            Bit_Write(&writer, zigzag[i] >> 16, 16);
+            Bit_Write(&writer, zigzag[i], 16);
+        }
+    }
+
+    /* Pad the last byte */
+    if (writer.bits > 0)
+    {
+        Bit_Write(&writer, 0, 8 - writer.bits);
+    }
+
+    sample_log.length += size;
+    sample_log.blocks++;
+
+    return 1;
+}
+
+void Sample_Log_Init(void)
+{
+    /* Sample_Log_Block() and the NFC exports trust the length, and each
+     * block takes at least its header */
+    if ((sample_log.magic != SAMPLE_LOG_MAGIC) ||
+        (sample_log.length > SAMPLE_LOG_SIZE) ||
+        (sample_log.blocks > (sample_log.length / SAMPLE_LOG_BLOCK_HEADER_SIZE)))
+    {
+        Sample_Log_Clear();
+    }
+}
+
+uint32_t Sample_Log_Write(const sensor_sample_t *samples, uint32_t count)
+{
+    uint32_t start __attribute__ ((unused)) = METRICS_CYCLES();
+    uint32_t logged = 0;
+
+    while (logged < count)
+    {
+        uint32_t n = count - logged;
+
+        if (n > SAMPLE_LOG_BLOCK_SAMPLES)
+        {
+            n = SAMPLE_LOG_BLOCK_SAMPLES;
+        }
+
+        if (!Sample_Log_Block(&samples[logged], n))
+        {
+            break;
+        }
+
+        logged += n;
+    }
+
+    sample_log.dropped += count - logged;
+    Metrics_SampleLog(start, logged);
+
+    return logged;
+}
+
+void Sample_Log_Clear(void)
+{
+    sample_log.length = 0;
+    sample_log.blocks = 0;
+    sample_log.dropped = 0;
+    sample_log.magic = SAMPLE_LOG_MAGIC;
+}
@@ -0,0 +1,398 @@
+/**
+ * @file sensor_dsp.c
+ * @brief Fixed-point sensor sample processing
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "sensor_dsp.h"
+
+/* Two 16-bit ones, used to sum sample pairs with SMUAD / SMLAD and to take
+ * the sign bit of each half-word */
+#define SENSOR_DSP_ONES_X2              (uint32_t)(0x00010001)
+
+/* Fractional bits of the baseline */
+#define SENSOR_DSP_BASELINE_FRAC        8
+
+/* Index of the first new sample in the work buffer; the filter history is
+ * kept just before it */
+#define SENSOR_DSP_WORK_BASE            (SENSOR_DSP_TAPS_MAX - 1)
+
+typedef struct
+{
+    uint32_t magic;
+
+    /* Current configuration; the filter coefficients are stored in reverse
+     * order so that each output is the dot product of the coefficients with
+     * consecutive samples */
+    sensor_dsp_config_t config;
+    int16_t coeffs_rev[SENSOR_DSP_TAPS_MAX];
+
+    /* Filter history followed by the decimated samples of the current batch */
+    int16_t work[SENSOR_DSP_WORK_BASE + SENSOR_DSP_BATCH_MAX];
+
+    /* Samples left over by the decimation, followed by the current batch */
+    int16_t stage[SENSOR_DSP_DECIMATION_MAX - 1 + SENSOR_DSP_BATCH_MAX];
+    uint32_t carry_count;
+
+    /* Baseline with SENSOR_DSP_BASELINE_FRAC fractional bits */
+    int32_t baseline;
+    uint8_t baseline_valid;
+
+    /* Detection state */
+    uint8_t active;
+} sensor_dsp_t;
+
+/* Processing state, kept in the non-initialized section so that the filter
+ * history, baseline and detection state survive the reset following a
+ * wakeup from sleep without retention */
+static sensor_dsp_t sensor_dsp __attribute__ ((section(".noinit")));
+
+/**
+ * @brief      Read two consecutive samples as one word
+ * @param [in] p  First sample, in the low half-word
+ * @return     Sample pair
+ */
+static inline uint32_t Sensor_DSP_Read2(const int16_t *p)
+{
+    uint32_t pair;
+
+    memcpy(&pair, p, sizeof(pair));
+    return pair;
+}
+
+/**
+ * @brief      Write two consecutive samples from one word
+ * @param [in] p     First sample, from the low half-word
+ * @param [in] pair  Sample pair
+ */
+static inline void Sensor_DSP_Write2(int16_t *p, uint32_t pair)
+{
+    memcpy(p, &pair, sizeof(pair));
+}
+
+/**
+ * @brief      Saturate a value to 16 bits
+ * @param [in] value  Value to saturate
+ * @return     Saturated value
+ */
+static inline int16_t Sensor_DSP_Sat16(int32_t value)
+{
+    return (value > INT16_MAX) ? INT16_MAX : ((value < INT16_MIN) ? INT16_MIN : (int16_t)value);
+}
+
+/**
+ * @brief      Average groups of sensor_dsp.config.decimation samples
+ * @param [in] in     Samples
+ * @param [in] count  Number of output samples
+ * @param [out] out   Output samples
+ */
+static void Sensor_DSP_Decimate(const int16_t *in, uint32_t count, int16_t *out)
+{
+    if (sensor_dsp.config.decimation == 2)
+    {
+        for (uint32_t i = 0; i < count; i++, in += 2)
+        {
+#if SENSOR_DSP_SIMD
+            out[i] = (int16_t)((int32_t)__SMUAD(Sensor_DSP_Read2(in), SENSOR_DSP_ONES_X2) >> 1);
+#else    /* if SENSOR_DSP_SIMD */
+            out[i] = (int16_t)(((int32_t)in[0] + in[1]) >> 1);
+#endif    /* if SENSOR_DSP_SIMD */
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < count; i++, in += 4)
+        {
+#if SENSOR_DSP_SIMD
+            int32_t sum = (int32_t)__SMUAD(Sensor_DSP_Read2(in), SENSOR_DSP_ONES_X2);
+
+            sum = (int32_t)__SMLAD(Sensor_DSP_Read2(in + 2), SENSOR_DSP_ONES_X2, (uint32_t)sum);
+            out[i] = (int16_t)(sum >> 2);
+#else    /* if SENSOR_DSP_SIMD */
+            out[i] = (int16_t)(((int32_t)in[0] + in[1] + in[2] + in[3]) >> 2);
+#endif    /* if SENSOR_DSP_SIMD */
+        }
+    }
+}
+
+/**
+ * @brief      Filter the samples of the work buffer
+ * @param [in] count  Number of samples
+ * @param [out] out   Filtered samples
+ */
+static void Sensor_DSP_Filter(uint32_t count, int16_t *out)
+{
+    uint32_t taps = sensor_dsp.config.taps;
+    const int16_t *x = &sensor_dsp.work[SENSOR_DSP_WORK_BASE + 1 - taps];
+
+    for (uint32_t n = 0; n < count; n++, x++)
+    {
+        /* Rounding of the Q15 result */
+        int32_t acc = 1 << 14;
+
+        for (uint32_t j = 0; j < taps; j += 2)
+        {
+#if SENSOR_DSP_SIMD
+            acc = (int32_t)__SMLAD(Sensor_DSP_Read2(&x[j]),
+                                   Sensor_DSP_Read2(&sensor_dsp.coeffs_rev[j]), (uint32_t)acc);
+#else    /* if SENSOR_DSP_SIMD */
+            acc = (int32_t)((uint32_t)acc + (uint32_t)(x[j] * sensor_dsp.coeffs_rev[j]) +
+                            (uint32_t)(x[j + 1] * sensor_dsp.coeffs_rev[j + 1]));
+#endif    /* if SENSOR_DSP_SIMD */
+        }
+
+        out[n] = Sensor_DSP_Sat16(acc >> 15);
+    }
+}
+
+/**
+ * @brief      Sum samples
+ * @param [in] in     Samples
+ * @param [in] count  Number of samples
+ * @return     Sum of the samples
+ */
+static int32_t Sensor_DSP_Sum(const int16_t *in, uint32_t count)
+{
+    int32_t sum = 0;
+    uint32_t i = 0;
+
+#if SENSOR_DSP_SIMD
+    for (; (i + 1) < count; i += 2)
+    {
+        sum = (int32_t)__SMLAD(Sensor_DSP_Read2(&in[i]), SENSOR_DSP_ONES_X2, (uint32_t)sum);
+    }
+#endif    /* if SENSOR_DSP_SIMD */
+
+    for (; i < count; i++)
+    {
+        sum += in[i];
+    }
+
+    return sum;
+}
+
+/**
+ * @brief      Subtract the same value from all samples, with saturation
+ * @param [in,out] samples  Samples
+ * @param [in] count        Number of samples
+ * @param [in] value        Value to subtract
+ */
+static void Sensor_DSP_Subtract(int16_t *samples, uint32_t count, int16_t value)
+{
+    uint32_t i = 0;
+
+#if SENSOR_DSP_SIMD
+    uint32_t value2 = ((uint32_t)(uint16_t)value << 16) | (uint16_t)value;
+
+    for (; (i + 1) < count; i += 2)
+    {
+        Sensor_DSP_Write2(&samples[i], __QSUB16(Sensor_DSP_Read2(&samples[i]), value2));
+    }
+#endif    /* if SENSOR_DSP_SIMD */
+
+    for (; i < count; i++)
+    {
+        samples[i] = Sensor_DSP_Sat16((int32_t)samples[i] - value);
+    }
+}
+
+/**
+ * @brief      Find the largest sample
+ * @param [in] in     Samples
+ * @param [in] count  Number of samples (at least 1)
+ * @return     Largest sample
+ */
+static int16_t Sensor_DSP_Peak(const int16_t *in, uint32_t count)
+{
+    int16_t peak = in[0];
+    uint32_t i = 0;
+
+#if SENSOR_DSP_SIMD
+    if (count >= 2)
+    {
+        /* Running maximum of the even and odd samples: the saturated
+         * difference keeps the sign of each half-word difference, and the
+         * half-words where it is negative keep the current maximum. The GE
+         * flags are not used, since nothing guarantees that they survive
+         * between two intrinsics. */
+        uint32_t peak2 = Sensor_DSP_Read2(in);
+
+        for (i = 2; (i + 1) < count; i += 2)
+        {
+            uint32_t pair = Sensor_DSP_Read2(&in[i]);
+            uint32_t keep = ((__QSUB16(pair, peak2) >> 15) & SENSOR_DSP_ONES_X2) * 0xFFFF;
+
+            peak2 = (peak2 & keep) | (pair & ~keep);
+        }
+
+        peak = (int16_t)peak2;
+        if ((int16_t)(peak2 >> 16) > peak)
+        {
+            peak = (int16_t)(peak2 >> 16);
+        }
+    }
+#endif    /* if SENSOR_DSP_SIMD */
+
+    for (; i < count; i++)
+    {
+        if (in[i] > peak)
+        {
+            peak = in[i];
+        }
+    }
+
+    return peak;
+}
+
+/**
+ * @brief      Check the parameters of a configuration
+ * @param [in] config  Configuration
+ * @return     true if all parameters are in range
+ */
+static uint8_t Sensor_DSP_Config_Valid(const sensor_dsp_config_t *config)
+{
+    return ((config->decimation == 1) || (config->decimation == 2) || (config->decimation == 4)) &&
+           (config->taps != 0) && (config->taps <= SENSOR_DSP_TAPS_MAX) && !(config->taps & 1) &&
+           (config->baseline_shift <= 15) && (config->hysteresis >= 0);
+}
+
+void Sensor_DSP_Init(void)
+{
+    sensor_dsp_config_t config;
+
+    memset(&config, 0, sizeof(config));
+    config.decimation = SENSOR_DSP_DEFAULT_DECIMATION;
+    config.taps = SENSOR_DSP_DEFAULT_TAPS;
+    config.baseline_shift = SENSOR_DSP_DEFAULT_BASELINE_SHIFT;
+    for (uint32_t i = 0; i < SENSOR_DSP_DEFAULT_TAPS; i++)
+    {
+        config.coeffs[i] = (int16_t)(0x8000 / SENSOR_DSP_DEFAULT_TAPS);
+    }
+    config.threshold = SENSOR_DSP_DEFAULT_THRESHOLD;
+    config.hysteresis = SENSOR_DSP_DEFAULT_HYSTERESIS;
+
+    Sensor_DSP_Configure(&config);
+}
+
+uint8_t Sensor_DSP_Configure(const sensor_dsp_config_t *config)
+{
+    if (!Sensor_DSP_Config_Valid(config))
+    {
+        return SENSOR_DSP_INVALID;
+    }
+
+    sensor_dsp.config = *config;
+    for (uint32_t i = 0; i < config->taps; i++)
+    {
+        sensor_dsp.coeffs_rev[i] = config->coeffs[config->taps - 1 - i];
+    }
+
+    memset(sensor_dsp.work, 0, sizeof(sensor_dsp.work));
+    sensor_dsp.carry_count = 0;
+    sensor_dsp.baseline = 0;
+    sensor_dsp.baseline_valid = 0;
+    sensor_dsp.active = 0;
+    sensor_dsp.magic = SENSOR_DSP_MAGIC;
+
+    return SENSOR_DSP_NO_ERROR;
+}
+
+uint8_t Sensor_DSP_Restore(void)
+{
+    uint8_t valid = (sensor_dsp.magic == SENSOR_DSP_MAGIC) &&
+                    Sensor_DSP_Config_Valid(&sensor_dsp.config) &&
+                    (sensor_dsp.carry_count < sensor_dsp.config.decimation);
+
+    if (!valid)
+    {
+        Sensor_DSP_Init();
+    }
+
+    return valid;
+}
+
+void Sensor_DSP_Process(int16_t *samples, uint32_t count, sensor_dsp_result_t *result)
+{
+    uint32_t decimation = sensor_dsp.config.decimation;
+    uint32_t total;
+    uint32_t m;
+
+    result->count = 0;
+    result->peak = INT16_MIN;
+    result->events = 0;
+
+    if (count > SENSOR_DSP_BATCH_MAX)
+    {
+        count = SENSOR_DSP_BATCH_MAX;
+    }
+
+    /* Decimation, with the samples left over by the previous batch */
+    if (decimation == 1)
+    {
+        m = count;
+        memcpy(&sensor_dsp.work[SENSOR_DSP_WORK_BASE], samples, count * sizeof(int16_t));
+    }
+    else
+    {
+        memcpy(&sensor_dsp.stage[sensor_dsp.carry_count], samples, count * sizeof(int16_t));
+        total = sensor_dsp.carry_count + count;
+        m = total / decimation;
+        Sensor_DSP_Decimate(sensor_dsp.stage, m, &sensor_dsp.work[SENSOR_DSP_WORK_BASE]);
+
+        sensor_dsp.carry_count = total - (m * decimation);
+        memmove(sensor_dsp.stage, &sensor_dsp.stage[m * decimation],
+                sensor_dsp.carry_count * sizeof(int16_t));
+    }
+
+    if (m == 0)
+    {
+        return;
+    }
+
+    /* Filter, then keep the last inputs as history for the next batch */
+    Sensor_DSP_Filter(m, samples);
+    memmove(sensor_dsp.work, &sensor_dsp.work[m], SENSOR_DSP_WORK_BASE * sizeof(int16_t));
+
+    /* Subtract the baseline, then update it with the batch mean */
+    if (sensor_dsp.config.baseline_shift > 0)
+    {
+        int32_t mean = (Sensor_DSP_Sum(samples, m) / (int32_t)m) * (1 << SENSOR_DSP_BASELINE_FRAC);
+
+        if (!sensor_dsp.baseline_valid)
+        {
+            sensor_dsp.baseline = mean;
+            sensor_dsp.baseline_valid = 1;
+        }
+
+        Sensor_DSP_Subtract(samples, m, (int16_t)(sensor_dsp.baseline >> SENSOR_DSP_BASELINE_FRAC));
+        sensor_dsp.baseline += (mean - sensor_dsp.baseline) >> sensor_dsp.config.baseline_shift;
+    }
+
+    /* Detection with hysteresis */
+    result->count = m;
+    result->peak = Sensor_DSP_Peak(samples, m);
+
+    if (!sensor_dsp.active && (result->peak >= sensor_dsp.config.threshold))
+    {
+        sensor_dsp.active = 1;
+        result->events = SENSOR_DSP_EVENT_RISE;
+    }
+    else if (sensor_dsp.active &&
+             ((int32_t)result->peak < ((int32_t)sensor_dsp.config.threshold - sensor_dsp.config.hysteresis)))
+    {
+        sensor_dsp.active = 0;
+        result->events = SENSOR_DSP_EVENT_FALL;
+    }
+}
@@ -0,0 +1,164 @@
+/**
+ * @file sensor_profile.c
+ * @brief Sensor measurement profiles
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "sensor_profile.h"
+#include "sensor.h"
+
+/* Sensor interface configuration shared by all profiles */
+#if SENSOR_CALIB == 1
+#define SENSOR_PROFILE_IF_CFG           (SENSOR_ENABLED | SENSOR_RE_VSSA | SENSOR_CALIB_ENABLED | \
+                                         SENSOR_AMP_ENABLED | SENSOR_GUARD_ENABLED)
+#else    /* if SENSOR_CALIB == 1 */
+#define SENSOR_PROFILE_IF_CFG           (SENSOR_ENABLED | SENSOR_RE_VSSA | SENSOR_CALIB_DISABLED | \
+                                         SENSOR_AMP_ENABLED | SENSOR_GUARD_ENABLED)
+#endif    /* if SENSOR_CALIB == 1 */
+
+/* Sensor timer states shared by all profiles */
+#define SENSOR_PROFILE_TIMER_CTL        (SENSOR_TIMER_ENABLED | WAITSLEEP_ENABLED | DLY2_WE_L_NOT_USED | \
+                                         DLY1_WE_H_NOT_USED | DLY2_WE_H_NOT_USED | IDLE_USED)
+
+/* Reference electrode connection */
+#if SENSOR_WUT == 1
+#define SENSOR_PROFILE_RE_CFG           RE_DISCONNECTED_BYTE
+#else    /* if SENSOR_WUT == 1 */
+#define SENSOR_PROFILE_RE_CFG           RE_CONNECTED_BYTE
+#endif    /* if SENSOR_WUT == 1 */
+
+/* Register images, indexed by sensor_profile_id_t */
+static const sensor_profile_t sensor_profiles[SENSOR_PROFILE_COUNT] =
+{
+    /* SENSOR_PROFILE_NORMAL */
+    {
+        .if_cfg     = SENSOR_PROFILE_IF_CFG | SENSOR_IOFFSET_40NA | SENSOR_IRANGE_80NA,
+        .wedac_high = SENSOR_WEDAC_HIGH_0600,
+        .wedac_low  = SENSOR_WEDAC_LOW_0600,
+        .timer_ctl  = SENSOR_PROFILE_TIMER_CTL | DLY1_WE_L_NOT_USED | PULSE_CNT_NOT_USED,
+        .re_cfg     = SENSOR_PROFILE_RE_CFG,
+        .int_cfg    = PRE_COUNT_INT_VALUE_2S,
+        .delay_l    = DLY1_WE_L_DIV_ENABLED_SHORT | DLY1_WE_L_VALUE_1S,
+        .idle       = IDLE_TIME_VALUE_27S,
+        .threshold  = ADC_THRESHOLD_VALUE_1NA,
+        .diff_mode  = SENSOR_DIFF_MODE_DISABLED
+    },
+
+    /* SENSOR_PROFILE_IMPEDANCE */
+    {
+        .if_cfg     = SENSOR_PROFILE_IF_CFG | SENSOR_IOFFSET_40NA | SENSOR_IRANGE_240NA,
+        .wedac_high = SENSOR_WEDAC_HIGH_0616,
+        .wedac_low  = SENSOR_WEDAC_LOW_0600,
+        .timer_ctl  = SENSOR_PROFILE_TIMER_CTL | DLY1_WE_L_USED | PULSE_CNT_USED,
+        .re_cfg     = SENSOR_PROFILE_RE_CFG,
+        .int_cfg    = PRE_COUNT_INT_VALUE_3P9MS,
+        .delay_l    = DLY1_WE_L_DIV_ENABLED_SHORT | DLY1_WE_L_VALUE_117P19MS,
+        .idle       = IDLE_TIME_VALUE_29P875S,
+        .threshold  = ADC_THRESHOLD_VALUE_77P75NA,
+        .diff_mode  = SENSOR_DIFF_MODE_ENABLED
+    }
+};
+
+/* Profile currently programmed, and FIFO wakeups counted by
+ * Sensor_Profile_Next() */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t profile;
+    uint32_t cycle;
+} sensor_profile_record_t;
+
+/* Kept in the non-initialized section since the sensor keeps its
+ * configuration through a wakeup from sleep without retention */
+static sensor_profile_record_t sensor_profile_record __attribute__ ((section(".noinit")));
+
+void Sensor_Profile_Apply(sensor_profile_id_t profile)
+{
+    const sensor_profile_t *image = &sensor_profiles[profile];
+
+    /* First profile since the last cold boot */
+    if (!Sensor_Profile_Valid())
+    {
+        sensor_profile_record.cycle = 0;
+    }
+
+    sensor_profile_record.profile = profile;
+    sensor_profile_record.magic = SENSOR_PROFILE_MAGIC;
+
+    Sys_Sensor_ADCConfig(image->if_cfg, image->wedac_high, image->wedac_low, SENSOR_CLK_SRC);
+
+    /* Restart the sensor timer with the states of the profile */
+    Sys_Sensor_TimerReset();
+    Sys_Sensor_TimerConfig(image->timer_ctl, image->re_cfg);
+    SENSOR->INT_CFG = image->int_cfg;
+    SENSOR_DELAY_L_CFG->DLY1_WE_L_SHORT = image->delay_l;
+    Sys_Sensor_IdleConfig(image->idle);
+
+    /* Samples taken with the previous profile are discarded */
+    SensorFIFO_Reset();
+    Sensor_FIFO_Resize(Sensor_FIFO_Size());
+}
+
+sensor_profile_id_t Sensor_Profile_Current(void)
+{
+    if (!Sensor_Profile_Valid())
+    {
+        return SENSOR_PROFILE_DEFAULT;
+    }
+
+    return (sensor_profile_id_t)sensor_profile_record.profile;
+}
+
+sensor_profile_id_t Sensor_Profile_Next(uint32_t period)
+{
+    /* The count starts with the first profile applied */
+    if (!Sensor_Profile_Valid())
+    {
+        return SENSOR_PROFILE_DEFAULT;
+    }
+
+    if (++sensor_profile_record.cycle >= period)
+    {
+        sensor_profile_record.cycle = 0;
+        return SENSOR_PROFILE_IMPEDANCE;
+    }
+
+    return SENSOR_PROFILE_DEFAULT;
+}
+
+uint8_t Sensor_Profile_Valid(void)
+{
+    return ((sensor_profile_record.magic == SENSOR_PROFILE_MAGIC) &&
+            (sensor_profile_record.profile < SENSOR_PROFILE_COUNT));
+}
+
+void Sensor_Profile_Invalidate(void)
+{
+    sensor_profile_record.magic = 0;
+}
+
+uint8_t Sensor_Profile_Check(void)
+{
+    const sensor_profile_t *image = &sensor_profiles[Sensor_Profile_Current()];
+
+    return (((CLK->DIV_CFG1 & SENSOR_CLK_ENABLE) == SENSOR_CLK_ENABLE) &&
+            (SENSOR->INT_CFG == image->int_cfg) &&
+            (SENSOR_DELAY_L_CFG->DLY1_WE_L_SHORT == image->delay_l));
+}
+
+const sensor_profile_t *Sensor_Profile_Get(sensor_profile_id_t profile)
+{
+    return &sensor_profiles[profile];
+}
@@ -0,0 +1,239 @@
+/**
+ * @file sensor_replay.c
+ * @brief Replay of recorded sensor traces
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "sensor_replay.h"
+
+#if SENSOR_REPLAY_EN
+
+/* FIFO sizes and their depth in samples */
+#define REPLAY_FIFO_SIZES               5
+
+static const uint32_t replay_fifo_size_cfg[REPLAY_FIFO_SIZES] =
+{
+    SENSOR_FIFO_SIZE1,
+    SENSOR_FIFO_SIZE2,
+    SENSOR_FIFO_SIZE4,
+    SENSOR_FIFO_SIZE8,
+    SENSOR_FIFO_SIZE16
+};
+
+static const uint8_t replay_fifo_depth[REPLAY_FIFO_SIZES] = { 1, 2, 4, 8, 16 };
+
+/* Replayed FIFO */
+static uint32_t replay_fifo[ADC_DATA_LENGTH];
+static volatile uint32_t replay_level;
+
+/* Trace and position in the trace */
+static const sensor_sample_t *replay_trace;
+static uint32_t replay_length;
+static uint32_t replay_index;
+static uint32_t replay_start;
+
+/* Retained like the timer heap (see sw_timer.h) */
+static sw_timer_t replay_timer __attribute__ ((section(".noinit")));
+
+/* Counters since Sensor_Replay_Start() */
+static uint32_t replay_fifo_dropped;
+static uint32_t replay_fifo_wakeups;
+static uint32_t replay_threshold_wakeups;
+static uint32_t replay_buffer_dropped;
+#if APP_METRICS_EN
+static uint64_t replay_run_cycles;
+#endif    /* if APP_METRICS_EN */
+
+/**
+ * @brief  Number of samples that fill the FIFO with its current size
+ * @return FIFO depth in samples
+ */
+static uint32_t Sensor_Replay_Depth(void)
+{
+    uint32_t size = Sensor_FIFO_Size();
+
+    for (uint32_t i = 0; i < REPLAY_FIFO_SIZES; i++)
+    {
+        if (replay_fifo_size_cfg[i] == size)
+        {
+            return replay_fifo_depth[i];
+        }
+    }
+
+    return ADC_DATA_LENGTH;
+}
+
+/**
+ * @brief      Time a trace sample is due at
+ * @param [in] index  Position in the trace
+ * @return     SW_Timer_Now() time of the sample
+ */
+static uint32_t Sensor_Replay_Due(uint32_t index)
+{
+    return replay_start + ((replay_trace[index].time - replay_trace[0].time) / SENSOR_REPLAY_SPEEDUP);
+}
+
+/**
+ * @brief      Push a sample into the FIFO and raise the wakeups the sensor
+ *             would have raised
+ * @param [in] value  Sample value
+ */
+static void Sensor_Replay_Push(uint32_t value)
+{
+    uint8_t fifo_wakeup = ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_FIFO) & WAKEUP_SRC_EN_MSK) != 0;
+    uint32_t depth = Sensor_Replay_Depth();
+    uint32_t basepri = __get_BASEPRI();
+
+    /* The wakeup handlers run from the main loop instead of
+     * WAKEUP_IRQHandler: raise the execution priority to that of WAKEUP_IRQn
+     * and NFC_IRQn, so that Event_Post() and Event_Signal() keep a single
+     * producer priority, while the RTC edge interrupt can still preempt */
+    __set_BASEPRI(APP_IRQ_PRIORITY_EVENT << (8U - __NVIC_PRIO_BITS));
+
+    if (fifo_wakeup)
+    {
+        if (replay_level < ADC_DATA_LENGTH)
+        {
+            replay_fifo[replay_level++] = value;
+        }
+        else
+        {
+            replay_fifo_dropped++;
+        }
+    }
+    else
+    {
+        /* Without the FIFO wakeup, ADC_DATA[0] holds the latest sample */
+        replay_fifo[0] = value;
+        replay_level = 1;
+    }
+
+    if (fifo_wakeup && (replay_level >= depth))
+    {
+        replay_fifo_wakeups++;
+        Metrics_Wakeup(WAKEUP_SRC_FIFO);
+        FIFO_Wakeup_Process_Handler();
+    }
+
+    if (((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_ADC) & WAKEUP_SRC_EN_MSK) &&
+        (value >= Threshold_Manager_Threshold()))
+    {
+        replay_threshold_wakeups++;
+        Metrics_Wakeup(WAKEUP_SRC_ADC);
+        Threshold_Wakeup_Process_Handler();
+    }
+
+    __set_BASEPRI(basepri);
+}
+
+/**
+ * @brief      Push the samples that are due, then wait for the next one
+ * @param [in] arg  Unused
+ */
+static void Sensor_Replay_Timer_Callback(void *arg)
+{
+    uint32_t now = SW_Timer_Now();
+
+    (void)arg;
+
+    while ((replay_index < replay_length) && ((int32_t)(now - Sensor_Replay_Due(replay_index)) >= 0))
+    {
+        Sensor_Replay_Push(replay_trace[replay_index].value);
+        replay_index++;
+    }
+
+    if (replay_index < replay_length)
+    {
+        SW_Timer_Start(&replay_timer, Sensor_Replay_Due(replay_index) - now, 0,
+                       Sensor_Replay_Timer_Callback, NULL);
+    }
+    else
+    {
+        Power_Governor_Release(POWER_GOVERNOR_HOLD_SENSOR_REPLAY);
+    }
+}
+
+void Sensor_Replay_Start(const sensor_sample_t *trace, uint32_t length)
+{
+    replay_trace = trace;
+    replay_length = length;
+    replay_index = 0;
+    replay_level = 0;
+    replay_fifo_dropped = 0;
+    replay_fifo_wakeups = 0;
+    replay_threshold_wakeups = 0;
+    replay_buffer_dropped = Sample_Buffer_Dropped();
+#if APP_METRICS_EN
+    replay_run_cycles = app_metrics.run_cycles + METRICS_CYCLES();
+#endif    /* if APP_METRICS_EN */
+
+    /* The replay state is not retained through a reset */
+    Power_Governor_Hold(POWER_GOVERNOR_HOLD_SENSOR_REPLAY);
+
+    replay_start = SW_Timer_Now();
+    if (length > 0)
+    {
+        SW_Timer_Start(&replay_timer, 0, 0, Sensor_Replay_Timer_Callback, NULL);
+    }
+    else
+    {
+        Power_Governor_Release(POWER_GOVERNOR_HOLD_SENSOR_REPLAY);
+    }
+}
+
+uint32_t Sensor_Replay_ADC_Data(uint32_t index)
+{
+    /* Like the registers, the FIFO keeps its last samples once reset */
+    uint32_t value = (index < ADC_DATA_LENGTH) ? replay_fifo[index] : 0;
+
+    if (index == 0)
+    {
+        replay_level = 0;
+    }
+
+    return value;
+}
+
+uint8_t Sensor_Replay_FIFO_Level(uint32_t *value)
+{
+    *value = replay_level;
+
+    return ASYNC_READ_NO_ERROR;
+}
+
+void Sensor_Replay_Report(sensor_replay_report_t *report)
+{
+    report->samples = replay_index;
+    report->done = (replay_index == replay_length);
+    report->dropped = replay_fifo_dropped + (Sample_Buffer_Dropped() - replay_buffer_dropped);
+    report->fifo_wakeups = replay_fifo_wakeups;
+    report->threshold_wakeups = replay_threshold_wakeups;
+
+    /* Samples still in the FIFO are neither captured nor dropped yet */
+    report->captured = 0;
+    if (((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_FIFO) & WAKEUP_SRC_EN_MSK) &&
+        (replay_index >= (report->dropped + replay_level)))
+    {
+        report->captured = replay_index - report->dropped - replay_level;
+    }
+
+#if APP_METRICS_EN
+    report->run_cycles = app_metrics.run_cycles + METRICS_CYCLES() - replay_run_cycles;
+#else    /* if APP_METRICS_EN */
+    report->run_cycles = 0;
+#endif    /* if APP_METRICS_EN */
+}
+
+#endif    /* if SENSOR_REPLAY_EN */
@@ -0,0 +1,306 @@
+/**
+ * @file sw_timer.c
+ * @brief Software timers multiplexed on the RTC alarm
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "sw_timer.h"
+
+/* True if time a is before time b; times wrap at 32 bits and are compared
+ * relative to each other, so they must be less than 2^31 cycles apart */
+#define SW_TIMER_BEFORE(a, b)           ((int32_t)((a) - (b)) < 0)
+
+typedef struct
+{
+    uint32_t magic;
+
+    /* Running timers, ordered as a binary min-heap on their expiry time */
+    sw_timer_t *heap[SW_TIMER_MAX];
+    uint32_t count;
+
+    /* Expiry time the RTC alarm was last programmed with */
+    uint32_t armed_expiry;
+    uint8_t armed;
+} sw_timer_heap_t;
+
+/* Timer heap, kept in the non-initialized section so that the running
+ * timers survive the reset following a wakeup from sleep without retention;
+ * expiry times are absolute timebase ticks, which are retained as well */
+static sw_timer_heap_t sw_timers __attribute__ ((section(".noinit")));
+
+/* Bounds of the non-initialized section, from the linker script; running
+ * timers are placed there (see sw_timer_t) */
+extern uint8_t __noinit_start__[];
+extern uint8_t __noinit_end__[];
+
+/**
+ * @brief      Move a timer towards the root until the heap is ordered
+ * @param [in] i  Heap position of the timer
+ */
+static void SW_Timer_SiftUp(uint32_t i)
+{
+    sw_timer_t *timer = sw_timers.heap[i];
+
+    while (i > 0)
+    {
+        uint32_t parent = (i - 1) / 2;
+
+        if (!SW_TIMER_BEFORE(timer->expiry, sw_timers.heap[parent]->expiry))
+        {
+            break;
+        }
+
+        sw_timers.heap[i] = sw_timers.heap[parent];
+        sw_timers.heap[i]->index = (uint8_t)i;
+        i = parent;
+    }
+
+    sw_timers.heap[i] = timer;
+    timer->index = (uint8_t)i;
+}
+
+/**
+ * @brief      Move a timer towards the leaves until the heap is ordered
+ * @param [in] i  Heap position of the timer
+ */
+static void SW_Timer_SiftDown(uint32_t i)
+{
+    sw_timer_t *timer = sw_timers.heap[i];
+
+    while (1)
+    {
+        uint32_t child = (2 * i) + 1;
+
+        if (child >= sw_timers.count)
+        {
+            break;
+        }
+
+        if (((child + 1) < sw_timers.count) &&
+            SW_TIMER_BEFORE(sw_timers.heap[child + 1]->expiry, sw_timers.heap[child]->expiry))
+        {
+            child++;
+        }
+
+        if (!SW_TIMER_BEFORE(sw_timers.heap[child]->expiry, timer->expiry))
+        {
+            break;
+        }
+
+        sw_timers.heap[i] = sw_timers.heap[child];
+        sw_timers.heap[i]->index = (uint8_t)i;
+        i = child;
+    }
+
+    sw_timers.heap[i] = timer;
+    timer->index = (uint8_t)i;
+}
+
+/**
+ * @brief      Remove a running timer from the heap
+ * @param [in] timer  Timer to remove
+ * @assumptions Called with interrupts disabled
+ */
+static void SW_Timer_Remove(sw_timer_t *timer)
+{
+    uint32_t i = timer->index;
+
+    timer->index = SW_TIMER_STOPPED;
+    sw_timers.count--;
+
+    if (i < sw_timers.count)
+    {
+        /* Fill the hole with the last timer and restore the order */
+        sw_timers.heap[i] = sw_timers.heap[sw_timers.count];
+        SW_Timer_SiftUp(i);
+        SW_Timer_SiftDown(sw_timers.heap[i]->index);
+    }
+}
+
+/**
+ * @brief Program the RTC alarm with the earliest expiry
+ */
+static void SW_Timer_Arm(void)
+{
+    uint32_t now = SW_Timer_Now();
+    uint32_t ticks = SW_TIMER_MAX_TICKS;
+
+    GLOBAL_INT_DISABLE();
+    if (sw_timers.count > 0)
+    {
+        int32_t remaining = (int32_t)(sw_timers.heap[0]->expiry - now);
+
+        ticks = (remaining < (int32_t)SW_TIMER_MIN_TICKS) ? SW_TIMER_MIN_TICKS : (uint32_t)remaining;
+    }
+    GLOBAL_INT_RESTORE();
+
+    /* The new count is loaded asynchronously, within two RTC clock cycles */
+    RTC_ALARM_Reconfig(Timebase_ToRTC(ticks));
+
+    sw_timers.armed_expiry = now + ticks;
+    sw_timers.armed = true;
+}
+
+/**
+ * @brief      Check that a retained heap entry can point at a timer
+ * @param [in] timer  Heap entry
+ * @return     true if the entry is an aligned address in the non-initialized
+ *             section
+ */
+static uint8_t SW_Timer_Valid(const sw_timer_t *timer)
+{
+    uintptr_t address = (uintptr_t)timer;
+
+    return (address >= (uintptr_t)__noinit_start__) &&
+           (address <= ((uintptr_t)__noinit_end__ - sizeof(sw_timer_t))) &&
+           ((address % __alignof__(sw_timer_t)) == 0);
+}
+
+void SW_Timer_Init(void)
+{
+    /* The heap entries left by a previous run are not followed: a timer is
+     * only taken as running if the heap position it records points back at
+     * it (see SW_Timer_Start()) */
+    sw_timers.count = 0;
+    sw_timers.armed = false;
+    sw_timers.magic = SW_TIMER_MAGIC;
+}
+
+uint8_t SW_Timer_Restore(void)
+{
+    uint8_t valid = (sw_timers.magic == SW_TIMER_MAGIC) && (sw_timers.count <= SW_TIMER_MAX);
+
+    /* Each running timer must be retained and still point back at its heap
+     * position */
+    for (uint32_t i = 0; valid && (i < sw_timers.count); i++)
+    {
+        valid = SW_Timer_Valid(sw_timers.heap[i]) && (sw_timers.heap[i]->index == i) &&
+                (sw_timers.heap[i]->callback != NULL);
+    }
+
+    if (!valid)
+    {
+        SW_Timer_Init();
+    }
+
+    return valid;
+}
+
+uint32_t SW_Timer_Now(void)
+{
+    return (uint32_t)Timebase_Ticks();
+}
+
+uint8_t SW_Timer_Start(sw_timer_t *timer, uint32_t ticks, uint32_t period,
+                       void (*callback)(void *arg), void *arg)
+{
+    uint8_t status = SW_TIMER_NO_ERROR;
+    uint8_t rearm = false;
+
+    if ((callback == NULL) || (ticks > SW_TIMER_MAX_TICKS) || (period > SW_TIMER_MAX_TICKS))
+    {
+        return SW_TIMER_INVALID;
+    }
+
+    GLOBAL_INT_DISABLE();
+    if (timer->index < sw_timers.count && sw_timers.heap[timer->index] == timer)
+    {
+        SW_Timer_Remove(timer);
+    }
+
+    if (sw_timers.count < SW_TIMER_MAX)
+    {
+        timer->expiry = SW_Timer_Now() + ticks;
+        timer->period = period;
+        timer->callback = callback;
+        timer->arg = arg;
+
+        sw_timers.heap[sw_timers.count] = timer;
+        sw_timers.count++;
+        SW_Timer_SiftUp(sw_timers.count - 1);
+
+        /* Bring the alarm forward if this timer is now the earliest */
+        rearm = (sw_timers.heap[0] == timer) &&
+                (!sw_timers.armed || SW_TIMER_BEFORE(timer->expiry, sw_timers.armed_expiry));
+    }
+    else
+    {
+        timer->index = SW_TIMER_STOPPED;
+        status = SW_TIMER_FULL;
+    }
+    GLOBAL_INT_RESTORE();
+
+    if (rearm)
+    {
+        SW_Timer_Arm();
+    }
+
+    return status;
+}
+
+void SW_Timer_Stop(sw_timer_t *timer)
+{
+    GLOBAL_INT_DISABLE();
+    if (timer->index < sw_timers.count && sw_timers.heap[timer->index] == timer)
+    {
+        /* The alarm is left as is; an early wakeup only re-arms it */
+        SW_Timer_Remove(timer);
+    }
+    GLOBAL_INT_RESTORE();
+}
+
+void SW_Timer_Process(void)
+{
+    /* Everything due before the end of the slack window runs now, so that
+     * timers with nearby expiry times share one wakeup */
+    uint32_t limit = SW_Timer_Now() + SW_TIMER_SLACK_TICKS;
+
+    while (1)
+    {
+        sw_timer_t *timer = NULL;
+
+        GLOBAL_INT_DISABLE();
+        if ((sw_timers.count > 0) && !SW_TIMER_BEFORE(limit, sw_timers.heap[0]->expiry))
+        {
+            timer = sw_timers.heap[0];
+            SW_Timer_Remove(timer);
+
+            if (timer->period != 0)
+            {
+                /* Keep the phase of periodic timers, skipping the periods
+                 * missed if the wakeup came late */
+                do
+                {
+                    timer->expiry += timer->period;
+                }
+                while (!SW_TIMER_BEFORE(limit, timer->expiry));
+
+                sw_timers.heap[sw_timers.count] = timer;
+                sw_timers.count++;
+                SW_Timer_SiftUp(sw_timers.count - 1);
+            }
+        }
+        GLOBAL_INT_RESTORE();
+
+        if (timer == NULL)
+        {
+            break;
+        }
+
+        timer->callback(timer->arg);
+    }
+
+    SW_Timer_Arm();
+}
@@ -0,0 +1,231 @@
+/**
+ * @file threshold_manager.c
+ * @brief ADC threshold tracking
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "threshold_manager.h"
+
+/* Largest threshold the sensor accepts, used to disarm the threshold */
+#define THRESHOLD_MAX                   (SENSOR_PROCESSING_THRESHOLD_Mask >> SENSOR_PROCESSING_THRESHOLD_Pos)
+
+/* Holdoff limits in ticks */
+#define THRESHOLD_HOLDOFF_MIN           TIMEBASE_MS_TO_TICKS(THRESHOLD_MANAGER_HOLDOFF_MIN_MS)
+#define THRESHOLD_HOLDOFF_MAX           TIMEBASE_MS_TO_TICKS(THRESHOLD_MANAGER_HOLDOFF_MAX_MS)
+
+/* Baseline samples and holdoff expiry */
+static sw_timer_t threshold_timer __attribute__ ((section(".noinit")));
+
+typedef struct
+{
+    uint32_t magic;
+
+    /* Threshold programmed while armed, and its state */
+    uint32_t threshold;
+    volatile uint8_t armed;
+
+    /* Baseline with THRESHOLD_MANAGER_BASELINE_SHIFT fractional bits */
+    uint8_t baseline_valid;
+    uint32_t baseline;
+    uint32_t last_value;
+
+    /* Time the threshold was last armed and last triggered, current holdoff */
+    uint32_t armed_time;
+    uint32_t trigger_time;
+    uint32_t holdoff;
+
+    uint32_t triggers;
+} threshold_manager_t;
+
+/* Manager state, kept in the non-initialized section with its timer so that
+ * a holdoff in progress survives the reset following a wakeup from sleep
+ * without retention */
+static threshold_manager_t threshold_manager __attribute__ ((section(".noinit")));
+
+/**
+ * @brief      Program the sensor threshold
+ * @param [in] value  Threshold in ADC LSBs
+ * @assumptions Called with interrupts masked, or from the wakeup handlers:
+ *              PROCESSING is also written by Threshold_Manager_Trigger()
+ */
+static void Threshold_Program(uint32_t value)
+{
+    SENSOR->PROCESSING = (SENSOR->PROCESSING & ~SENSOR_PROCESSING_THRESHOLD_Mask) |
+                         ((value << SENSOR_PROCESSING_THRESHOLD_Pos) & SENSOR_PROCESSING_THRESHOLD_Mask);
+    Metrics_RegAccess(2);
+}
+
+/**
+ * @brief      Take a baseline sample and update the threshold
+ * @param [in] arg  Unused
+ */
+static void Threshold_Timer_Callback(void *arg)
+{
+    (void)arg;
+
+    /* Reading the sample resets the FIFO: with the FIFO wakeup source
+     * enabled, the baseline follows the samples drained from it instead */
+    if (!((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_FIFO) & WAKEUP_SRC_EN_MSK))
+    {
+        Threshold_Manager_Sample(SENSOR_ADC_DATA(0));
+    }
+    Threshold_Manager_Update();
+}
+
+void Threshold_Manager_Init(void)
+{
+    const sensor_profile_t *profile = Sensor_Profile_Get(Sensor_Profile_Current());
+
+    GLOBAL_INT_DISABLE();
+    threshold_manager.threshold = (profile->threshold & SENSOR_PROCESSING_THRESHOLD_Mask) >> SENSOR_PROCESSING_THRESHOLD_Pos;
+    threshold_manager.baseline_valid = 0;
+    threshold_manager.holdoff = THRESHOLD_HOLDOFF_MIN;
+    threshold_manager.triggers = 0;
+    threshold_manager.armed_time = SW_Timer_Now();
+    threshold_manager.armed = 1;
+    threshold_manager.magic = THRESHOLD_MANAGER_MAGIC;
+
+    Threshold_Program(threshold_manager.threshold);
+    GLOBAL_INT_RESTORE();
+
+    SW_Timer_Start(&threshold_timer, TIMEBASE_MS_TO_TICKS(THRESHOLD_MANAGER_PERIOD_MS), 0,
+                   Threshold_Timer_Callback, NULL);
+}
+
+uint8_t Threshold_Manager_Restore(void)
+{
+    uint8_t valid = (threshold_manager.magic == THRESHOLD_MANAGER_MAGIC) &&
+                    (threshold_manager.threshold <= THRESHOLD_MAX) &&
+                    (threshold_manager.holdoff >= THRESHOLD_HOLDOFF_MIN) &&
+                    (threshold_manager.holdoff <= THRESHOLD_HOLDOFF_MAX);
+
+    if (!valid)
+    {
+        Threshold_Manager_Init();
+        return valid;
+    }
+
+    /* The sensor may have been configured again from its profile: program
+     * the threshold the manager left, or keep it disarmed */
+    GLOBAL_INT_DISABLE();
+    Threshold_Program(threshold_manager.armed ? threshold_manager.threshold : THRESHOLD_MAX);
+    GLOBAL_INT_RESTORE();
+
+    return valid;
+}
+
+void Threshold_Manager_Trigger(void)
+{
+    uint32_t now = SW_Timer_Now();
+
+    if (!threshold_manager.armed)
+    {
+        return;
+    }
+
+    /* Triggered again soon after being armed: the signal hovers around the
+     * threshold, so wait longer before arming it again */
+    if ((now - threshold_manager.armed_time) < (2 * threshold_manager.holdoff))
+    {
+        threshold_manager.holdoff = ((2 * threshold_manager.holdoff) < THRESHOLD_HOLDOFF_MAX) ?
+                                    (2 * threshold_manager.holdoff) : THRESHOLD_HOLDOFF_MAX;
+    }
+    else
+    {
+        threshold_manager.holdoff = THRESHOLD_HOLDOFF_MIN;
+    }
+
+    Threshold_Program(THRESHOLD_MAX);
+    threshold_manager.armed = 0;
+    threshold_manager.trigger_time = now;
+    threshold_manager.triggers++;
+}
+
+void Threshold_Manager_Sample(uint32_t value)
+{
+    uint32_t scaled = value << THRESHOLD_MANAGER_BASELINE_SHIFT;
+
+    threshold_manager.last_value = value;
+
+    if (!threshold_manager.baseline_valid)
+    {
+        threshold_manager.baseline = scaled;
+        threshold_manager.baseline_valid = 1;
+    }
+    else if (scaled > threshold_manager.baseline)
+    {
+        threshold_manager.baseline += (scaled - threshold_manager.baseline) >> THRESHOLD_MANAGER_BASELINE_SHIFT;
+    }
+    else
+    {
+        threshold_manager.baseline -= (threshold_manager.baseline - scaled) >> THRESHOLD_MANAGER_BASELINE_SHIFT;
+    }
+}
+
+void Threshold_Manager_Update(void)
+{
+    uint32_t now = SW_Timer_Now();
+    uint32_t delay = TIMEBASE_MS_TO_TICKS(THRESHOLD_MANAGER_PERIOD_MS);
+
+    /* Threshold_Manager_Trigger() disarms the threshold from the wakeup
+     * interrupt: decide and program with interrupts masked, so that a
+     * trigger is not lost or followed by arming again */
+    GLOBAL_INT_DISABLE();
+
+    /* Follow the baseline */
+    if (threshold_manager.baseline_valid)
+    {
+        threshold_manager.threshold = (threshold_manager.baseline >> THRESHOLD_MANAGER_BASELINE_SHIFT) +
+                                      THRESHOLD_MANAGER_BAND;
+        if (threshold_manager.threshold > THRESHOLD_MAX)
+        {
+            threshold_manager.threshold = THRESHOLD_MAX;
+        }
+    }
+
+    if (threshold_manager.armed)
+    {
+        Threshold_Program(threshold_manager.threshold);
+    }
+    else if ((now - threshold_manager.trigger_time) < threshold_manager.holdoff)
+    {
+        delay = threshold_manager.holdoff - (now - threshold_manager.trigger_time);
+    }
+    else if ((threshold_manager.last_value + THRESHOLD_MANAGER_HYSTERESIS) >= threshold_manager.threshold)
+    {
+        /* Still above the release level: check again after a holdoff */
+        delay = threshold_manager.holdoff;
+    }
+    else
+    {
+        threshold_manager.armed_time = now;
+        threshold_manager.armed = 1;
+        Threshold_Program(threshold_manager.threshold);
+    }
+
+    GLOBAL_INT_RESTORE();
+
+    SW_Timer_Start(&threshold_timer, delay, 0, Threshold_Timer_Callback, NULL);
+}
+
+uint32_t Threshold_Manager_Threshold(void)
+{
+    return threshold_manager.armed ? threshold_manager.threshold : THRESHOLD_MAX;
+}
+
+uint32_t Threshold_Manager_Triggers(void)
+{
+    return threshold_manager.triggers;
+}
@@ -0,0 +1,237 @@
+/**
+ * @file timebase.c
+ * @brief Monotonic timebase kept across power modes
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "timebase.h"
+
+/* Timebase, kept in the non-initialized section so that it survives the
+ * reset following a wakeup from sleep without retention */
+timebase_t timebase __attribute__ ((section(".noinit")));
+
+/**
+ * @brief       Wait for the next edge of the RTC clock
+ * @param [out] time    RTC_ALARM_Time() at the edge
+ * @param [out] cycles  Value of the cycle counter at the edge
+ * @return      TIMEBASE_NO_ERROR, or TIMEBASE_TIMEOUT if no edge could be
+ *              dated within TIMEBASE_EDGE_TIMEOUT_PERIODS RTC clock periods
+ */
+static uint8_t Timebase_WaitEdge(uint32_t *time, uint32_t *cycles)
+{
+    uint32_t timeout = (SystemCoreClock / TIMEBASE_TICKS_HZ) * TIMEBASE_EDGE_TIMEOUT_PERIODS;
+    uint32_t first = DWT->CYCCNT;
+    uint32_t start;
+    uint32_t count;
+    uint32_t now;
+    uint32_t last = first;
+    uint8_t stable;
+
+    Async_Read_RTC_Count(&start);
+
+    while (1)
+    {
+        /* Poll the register directly rather than through Async_Read(): a
+         * sample only counts once two consecutive reads agree. Only the
+         * sampling is masked, so that GPIO3_IRQHandler keeps its half RTC
+         * clock cycle deadline */
+        GLOBAL_INT_DISABLE();
+        count = ACS->RTC_COUNT;
+        now = DWT->CYCCNT;
+        stable = (ACS->RTC_COUNT == count);
+        GLOBAL_INT_RESTORE();
+
+        if (stable && (count != start))
+        {
+            /* The edge is only dated accurately if the previous sample was
+             * taken just before it; otherwise an interrupt ran in between,
+             * so wait for the next edge */
+            if ((now - last) <= TIMEBASE_EDGE_POLL_CYCLES)
+            {
+                *time = RTC_ALARM_Time();
+
+                /* The time must be read before the following edge */
+                if (ACS->RTC_COUNT == count)
+                {
+                    *cycles = now;
+                    return TIMEBASE_NO_ERROR;
+                }
+            }
+
+            start = count;
+        }
+
+        /* The RTC may be stopped, or not clocked */
+        if ((now - first) > timeout)
+        {
+            return TIMEBASE_TIMEOUT;
+        }
+
+        last = now;
+    }
+}
+
+void Timebase_Init(void)
+{
+    if (timebase.magic != TIMEBASE_MAGIC)
+    {
+        timebase.ppm = 0;
+    }
+
+    timebase.ticks = 0;
+    timebase.rtc_time = RTC_ALARM_Time();
+    timebase.remainder = 0;
+    timebase.magic = TIMEBASE_MAGIC;
+}
+
+void Timebase_Update(void)
+{
+    GLOBAL_INT_DISABLE();
+
+    uint32_t rtc_time = RTC_ALARM_Time();
+    uint32_t elapsed = rtc_time - timebase.rtc_time;
+
+    timebase.rtc_time = rtc_time;
+
+    if (timebase.ppm == 0)
+    {
+        timebase.ticks += elapsed;
+    }
+    else
+    {
+        /* ticks = elapsed * 10^6 / (10^6 + ppm), carrying the remainder
+         * over to the next update */
+        uint64_t scaled = ((uint64_t)elapsed * 1000000) + timebase.remainder;
+        uint32_t rate = (uint32_t)(1000000 + timebase.ppm);
+
+        timebase.ticks += scaled / rate;
+        timebase.remainder = (uint32_t)(scaled % rate);
+    }
+
+    GLOBAL_INT_RESTORE();
+}
+
+uint64_t Timebase_Ticks(void)
+{
+    Timebase_Update();
+
+    return timebase.ticks;
+}
+
+uint64_t Timebase_Now_us(void)
+{
+    return TIMEBASE_TICKS_TO_US(Timebase_Ticks());
+}
+
+uint32_t Timebase_ToRTC(uint32_t ticks)
+{
+    if (timebase.ppm == 0)
+    {
+        return ticks;
+    }
+
+    return (uint32_t)((((uint64_t)ticks * (uint32_t)(1000000 + timebase.ppm)) + 500000) / 1000000);
+}
+
+uint8_t Timebase_Calibrate(void)
+{
+    uint32_t start_cycles;
+    uint32_t end_cycles;
+    uint32_t start;
+    uint32_t end;
+    uint32_t elapsed;
+    uint32_t timeout;
+    int64_t error;
+    int32_t ppm;
+
+    if (RTC_CLK_SRC != RTC_CLK_SRC_RC_OSC)
+    {
+        return TIMEBASE_NO_ERROR;
+    }
+
+    /* The measurement uses the cycle counter of the DWT unit */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* The RTC must not be reloaded during the measurement */
+    RTC_ALARM_Reconfig_Wait();
+
+    if (Timebase_WaitEdge(&start, &start_cycles) != TIMEBASE_NO_ERROR)
+    {
+        return TIMEBASE_TIMEOUT;
+    }
+
+    /* Allow twice the nominal duration, well beyond TIMEBASE_PPM_MAX */
+    timeout = (SystemCoreClock / TIMEBASE_TICKS_HZ) * TIMEBASE_CALIBRATION_TICKS * 2;
+    while ((RTC_ALARM_Time() - start) < (TIMEBASE_CALIBRATION_TICKS - 1))
+    {
+        SYS_WATCHDOG_REFRESH();
+
+        if ((DWT->CYCCNT - start_cycles) > timeout)
+        {
+            return TIMEBASE_TIMEOUT;
+        }
+    }
+
+    if (Timebase_WaitEdge(&end, &end_cycles) != TIMEBASE_NO_ERROR)
+    {
+        return TIMEBASE_TIMEOUT;
+    }
+    elapsed = end - start;
+
+    /* Frequency error of the RTC clock, taking the system clock as reference:
+     * ppm = (elapsed * SystemCoreClock / cycles - 32768) * 10^6 / 32768 */
+    error = ((int64_t)elapsed * SystemCoreClock) -
+            ((int64_t)TIMEBASE_TICKS_HZ * (uint32_t)(end_cycles - start_cycles));
+    ppm = (int32_t)((error * 1000000) /
+                    ((int64_t)TIMEBASE_TICKS_HZ * (uint32_t)(end_cycles - start_cycles)));
+
+    /* Bring the time up to date with the previous error before changing it */
+    Timebase_Update();
+
+    /* Smooth out the measurement noise once a first estimate is known */
+    if (timebase.ppm != 0)
+    {
+        ppm = timebase.ppm + ((ppm - timebase.ppm) / 4);
+    }
+
+    Timebase_SetPPM(ppm);
+
+    return TIMEBASE_NO_ERROR;
+}
+
+void Timebase_SetPPM(int32_t ppm)
+{
+    if (ppm > TIMEBASE_PPM_MAX)
+    {
+        ppm = TIMEBASE_PPM_MAX;
+    }
+    else if (ppm < -TIMEBASE_PPM_MAX)
+    {
+        ppm = -TIMEBASE_PPM_MAX;
+    }
+
+    Timebase_Update();
+
+    GLOBAL_INT_DISABLE();
+    timebase.ppm = ppm;
+    timebase.remainder = 0;
+    GLOBAL_INT_RESTORE();
+}
+
+int32_t Timebase_PPM(void)
+{
+    return timebase.ppm;
+}
@@ -20,19 +20,33 @@
 #include "sensor.h"
 
 unsigned int reset_fifo_level;
-unsigned int fifo_size = FIFO_SIZE_VALUE;
-unsigned int number_of_samples = NBR_SAMPLES_VALUE;
 
-#if SENSOR_NORMAL == 1
-unsigned int adc_threshold = ADC_THRESHOLD_VALUE_1NA;
-unsigned int diff_mode = SENSOR_DIFF_MODE_DISABLED;
-#elif SENSOR_IMPEDANCE == 1
-unsigned int adc_threshold = ADC_THRESHOLD_VALUE_77P75NA;
-unsigned int diff_mode = SENSOR_DIFF_MODE_ENABLED;
-#endif
+/* FIFO depth programmed in the sensor, which keeps it through a wakeup from
+ * sleep without retention; kept in the non-initialized section as well and
+ * set by Wakeup_Source_Config() on a cold boot */
+static uint32_t fifo_size __attribute__ ((section(".noinit")));
+
+unsigned int number_of_samples = NBR_SAMPLES_VALUE;
 
 uint8_t RAW_ARRAY[64] = {};
 
+/* States of the RTC_ALARM_Reconfig() sequence */
+#define RTC_RECONFIG_IDLE               0
+#define RTC_RECONFIG_WAIT_RISING        1
+#define RTC_RECONFIG_WAIT_FALLING       2
+
+/* RTC_ALARM_Reconfig() sequence, run by GPIO3_IRQHandler */
+static volatile uint8_t rtc_reconfig_state = RTC_RECONFIG_IDLE;
+static volatile uint8_t rtc_reconfig_restart;
+static uint32_t rtc_reconfig_counter;
+static uint32_t rtc_reconfig_next;
+
+/* RTC time and start value at the last load of the RTC timer counter, kept
+ * in the non-initialized section so that they survive the reset following a
+ * wakeup from sleep without retention */
+static uint32_t rtc_alarm_time __attribute__ ((section(".noinit")));
+static uint32_t rtc_alarm_ticks __attribute__ ((section(".noinit")));
+
 /* Define delay in run mode after wakeup from NFC in seconds */
 #define APP_DELAY_S                     3
 
@@ -41,7 +55,16 @@ uint8_t RAW_ARRAY[64] = {};
  */
 void Wakeup_Source_Config(void)
 {
-	if ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_RTC_ALARM) & WAKEUP_SRC_EN_MSK)
+    /* Start counting RTC_ALARM_Time() from the RTC reset */
+    rtc_alarm_time = 0;
+    rtc_alarm_ticks = 0;
+
+    /* Configure the sensor from scratch after a cold boot */
+    Sensor_Profile_Invalidate();
+    fifo_size = FIFO_SIZE_VALUE;
+
+	/* The replayed samples are timed with the RTC alarm */
+	if (((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_RTC_ALARM) & WAKEUP_SRC_EN_MSK) || SENSOR_REPLAY_EN)
 	{
 		/* Configure and enable RTC ALARM */
 		RTC_ALARM_Init();
@@ -49,6 +72,10 @@ void Wakeup_Source_Config(void)
 
     if ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_BB) & WAKEUP_SRC_EN_MSK)
     {
+        /* The BB timer counts the low power clock: start the RTC once here,
+         * since BB_Timer_Init() also runs on each BB timer wakeup */
+        RTC_Timebase_Start();
+
         /* Configure and enable BB Timer wakeup source */
         BB_Timer_Init();
     }
@@ -65,13 +92,15 @@ void Wakeup_Source_Config(void)
         NFC_Init();
     }
 
-    if ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_FIFO) & WAKEUP_SRC_EN_MSK)
+    /* When replaying a trace, the sensor is left unconfigured so that it
+     * does not wake the core */
+    if (((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_FIFO) & WAKEUP_SRC_EN_MSK) && !SENSOR_REPLAY_EN)
     {
         /* Configure and enable ADC FIFO, Wakeup when FIFO is full. */
         ADC_FIFO_Init();
     }
 
-    if ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_ADC) & WAKEUP_SRC_EN_MSK)
+    if (((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_ADC) & WAKEUP_SRC_EN_MSK) && !SENSOR_REPLAY_EN)
     {
         /* Configure and enable ADC threshold, Wakeup when ADC threshold limit is reached. */
         ADC_Threshold_Init();
@@ -88,11 +117,36 @@ void Wakeup_Source_Config(void)
 
     /* Clear NVIC WAKEUP_IRQn interrupt */
     NVIC_ClearPendingIRQ(WAKEUP_IRQn);
+    NVIC_SetPriority(WAKEUP_IRQn, APP_IRQ_PRIORITY_EVENT);
 
     /* Enable the Wakeup interrupt */
     NVIC_EnableIRQ(WAKEUP_IRQn);
 }
 
+void Wakeup_Source_Restore(void)
+{
+    /* The RTC keeps running; only its clock pads are set up again */
+    if (((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_RTC_ALARM) & WAKEUP_SRC_EN_MSK) || SENSOR_REPLAY_EN)
+    {
+        RTC_ClockSource_Init();
+    }
+
+    if ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_BB) & WAKEUP_SRC_EN_MSK)
+    {
+        NVIC_EnableIRQ(BLE_SLP_IRQn);
+    }
+
+    if ((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_GPIO) & WAKEUP_SRC_EN_MSK)
+    {
+        GPIO_Wakeup_Init();
+    }
+
+    /* The wakeup flags tell the handler what woke the core up: leave them
+     * set and pending */
+    NVIC_SetPriority(WAKEUP_IRQn, APP_IRQ_PRIORITY_EVENT);
+    NVIC_EnableIRQ(WAKEUP_IRQn);
+}
+
 /**
  * @brief       Configure and enable RTC ALARM event
  * @assumptions The following are pre-defined;
@@ -106,7 +160,7 @@ void RTC_ALARM_Init(void)
     /* Configure RTC with timercounter-1 as start value*/
     ACS->RTC_CTRL = RTC_DISABLE;
     ACS->RTC_CTRL = RTC_RESET;
-    ACS->RTC_CFG = 0xDEADBEEF;
+    ACS->RTC_CFG = RTC_CFG_RELOAD_VALUE;
     ACS->RTC_CTRL = RTC_ENABLE | RTC_CLK_SRC | RTC_ALARM_ZERO;
 
     /* Clear sticky wakeup RTC alarm flag */
@@ -135,83 +189,214 @@ void RTC_ClockSource_Init(void)
     }
 }
 
+void RTC_Timebase_Start(void)
+{
+    /* Configure and enable clock source for RTC */
+    RTC_ClockSource_Init();
+
+    /* Do not change RTC settings, if already configured by RTC_ALARM_Init().
+     * Otherwise start it without an alarm and without a reset: the timebase
+     * counts the RTC, and this also runs after a wakeup through reset */
+    if (!((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_RTC_ALARM) & WAKEUP_SRC_EN_MSK) && !SENSOR_REPLAY_EN)
+    {
+        ACS->RTC_CFG = RTC_CFG_RELOAD_VALUE;
+        ACS->RTC_CTRL = RTC_ENABLE | RTC_CLK_SRC | RTC_ALARM_DISABLE;
+    }
+}
+
+/**
+ * @brief Configure GPIO3 interrupt line on an edge of GPIO8 (standby clock)
+ * @param [in] edge GPIO_EVENT_RISING_EDGE, GPIO_EVENT_FALLING_EDGE or
+ *                  GPIO_EVENT_NONE to disable the interrupt line
+ */
+static void RTC_ALARM_Reconfig_Edge(uint32_t edge)
+{
+    Sys_GPIO_IntConfig(3, NS_CANNOT_ACCESS_GPIO_INT | GPIO_DEBOUNCE_DISABLE | edge | GPIO_SRC_GPIO_8,
+                       GPIO_DEBOUNCE_SLOWCLK_DIV32, 0);
+}
+
+/**
+ * @brief Start waiting for the rising edge of the RTC clock that precedes the
+ *        update of the RTC preload value
+ * @assumptions Called with interrupts disabled or from GPIO3_IRQHandler
+ */
+static void RTC_ALARM_Reconfig_Start(void)
+{
+    rtc_reconfig_counter = rtc_reconfig_next;
+    rtc_reconfig_restart = false;
+    rtc_reconfig_state = RTC_RECONFIG_WAIT_RISING;
+
+    /* Configure GPIO3 interrupt line to rising edge of GPIO8(standby clock) */
+    RTC_ALARM_Reconfig_Edge(GPIO_EVENT_NONE);
+    NVIC_ClearPendingIRQ(GPIO3_IRQn);
+    RTC_ALARM_Reconfig_Edge(GPIO_EVENT_RISING_EDGE);
+}
+
 /**
  * @brief Re-configure start value for the RTC timer counter
  * @param [in] timer_counter Start value(number of cycles)
  *             for RTC timer counter
+ * @note  The new value is loaded asynchronously by GPIO3_IRQHandler, on the
+ *        second edge of the RTC clock following this call; use
+ *        RTC_ALARM_Reconfig_Busy() or RTC_ALARM_Reconfig_Wait() to know when
+ *        it has been loaded. A call made while a previous value is being
+ *        loaded replaces that value.
  */
 void RTC_ALARM_Reconfig(uint32_t timer_counter)
 {
-	/* NVIC set enable registers */
-    uint32_t nvic_set_enable[2];
+    GLOBAL_INT_DISABLE();
 
-    /* Mask interrupts */
-	__disable_irq();
+    rtc_reconfig_next = timer_counter;
 
-   /* Backup NVIC set enable registers so that we can restore it later */
-	nvic_set_enable[0]=NVIC->ISER[0];
-	nvic_set_enable[1]=NVIC->ISER[1];
+    if (rtc_reconfig_state == RTC_RECONFIG_IDLE)
+    {
+        /* Configure GPIO8 as standby clock */
+        SYS_GPIO_CONFIG(8, GPIO_2X_DRIVE | GPIO_LPF_DISABLE | GPIO_NO_PULL | NS_CANNOT_USE_GPIO | GPIO_MODE_STANDBYCLK);
 
-   /* Set NVIC clear enable registers to clear interrupts */
-    NVIC->ICER[0] = 0xFFFFFFFFU;
-    NVIC->ICER[1] = 0xFFFFFFFFU;
+        /* The preload value must be written within half an RTC clock cycle of
+         * the rising edge: let the edge interrupt preempt the others */
+        NVIC_SetPriority(GPIO3_IRQn, APP_IRQ_PRIORITY_RTC_EDGE);
+        NVIC_EnableIRQ(GPIO3_IRQn);
 
-   /* Set wanted IRQ only (GPIO3) */
-   NVIC_EnableIRQ(GPIO3_IRQn);
+        RTC_ALARM_Reconfig_Start();
+    }
+    else if (rtc_reconfig_state == RTC_RECONFIG_WAIT_RISING)
+    {
+        /* The preload value has not been written yet */
+        rtc_reconfig_counter = timer_counter;
+    }
+    else
+    {
+        /* Load the previous value, then start again with the new one */
+        rtc_reconfig_restart = true;
+    }
 
-   /* Configure GPIO8 as standby clock */
-   SYS_GPIO_CONFIG(8, GPIO_2X_DRIVE | GPIO_LPF_DISABLE | GPIO_NO_PULL | NS_CANNOT_USE_GPIO | GPIO_MODE_STANDBYCLK);
+    GLOBAL_INT_RESTORE();
+}
 
-   /* Configure GPIO3 interrupt line to rising edge of GPIO8(standby clock) */
-   Sys_GPIO_IntConfig(3, NS_CANNOT_ACCESS_GPIO_INT | GPIO_DEBOUNCE_DISABLE | GPIO_EVENT_NONE | GPIO_SRC_GPIO_8,
-		   GPIO_DEBOUNCE_SLOWCLK_DIV32, 0);
-   Sys_GPIO_IntConfig(3, NS_CANNOT_ACCESS_GPIO_INT | GPIO_DEBOUNCE_DISABLE | GPIO_EVENT_RISING_EDGE | GPIO_SRC_GPIO_8,
-   		   GPIO_DEBOUNCE_SLOWCLK_DIV32, 0);
+uint8_t RTC_ALARM_Reconfig_Busy(void)
+{
+    return (rtc_reconfig_state != RTC_RECONFIG_IDLE);
+}
 
-   /* Wait for rising edge of RTC_CLOCK */
-   __WFI();
+void RTC_ALARM_Reconfig_Wait(void)
+{
+    uint32_t primask = __get_PRIMASK();
 
-   /* Clear the pending GPIO3 IRQ */
-   NVIC_ClearPendingIRQ(GPIO3_IRQn);
+    __disable_irq();
 
-   /* Configure RTC timer counter with timeout cycles */
-   ACS->RTC_CFG = timer_counter - 1;
+    while (rtc_reconfig_state != RTC_RECONFIG_IDLE)
+    {
+        /* The GPIO3 interrupt wakes up the core even while masked, and is
+         * taken as soon as interrupts are unmasked */
+        __WFI();
+        __enable_irq();
+        __disable_irq();
+    }
 
-   /* Configure GPIO3 interrupt line to falling edge of GPIO8(standby clock) */
-   Sys_GPIO_IntConfig(3, NS_CANNOT_ACCESS_GPIO_INT | GPIO_DEBOUNCE_DISABLE | GPIO_EVENT_FALLING_EDGE | GPIO_SRC_GPIO_8,
-		   GPIO_DEBOUNCE_SLOWCLK_DIV32, 0);
+    __set_PRIMASK(primask);
+}
 
-   /* Wait for falling edge of RTC_CLOCK */
-   __WFI();
+/**
+ * @brief      Convert an RTC count into RTC_ALARM_Time()
+ * @param [in] count  RTC count
+ * @return     Number of RTC clock cycles since RTC_ALARM_Init()
+ * @assumptions Called with interrupts disabled
+ */
+static uint32_t RTC_ALARM_Count_To_Time(uint32_t count)
+{
+    /* The RTC counts down from rtc_alarm_ticks - 1 to the alarm at zero,
+     * then reloads RTC_CFG_RELOAD_VALUE and keeps counting down */
+    if (count < rtc_alarm_ticks)
+    {
+        return rtc_alarm_time + (rtc_alarm_ticks - 1 - count);
+    }
+
+    return rtc_alarm_time + rtc_alarm_ticks + (RTC_CFG_RELOAD_VALUE - count);
+}
+
+uint32_t RTC_ALARM_Time(void)
+{
+    uint32_t count;
+    uint32_t time;
+
+    GLOBAL_INT_DISABLE();
+
+    Async_Read_RTC_Count(&count);
+    time = RTC_ALARM_Count_To_Time(count);
+
+    GLOBAL_INT_RESTORE();
 
-   /* Reset RTC to load new timer counter */
-   ACS->RTC_CTRL = (ACS->RTC_CTRL & ~ACS_RTC_CTRL_ALARM_CFG_Mask) | RTC_ALARM_DISABLE;
-   ACS->RTC_CTRL |= RTC_RESET;
-   ACS->RTC_CTRL |= RTC_FORCE_CLOCK;
-   ACS->RTC_CTRL = (ACS->RTC_CTRL & ~ACS_RTC_CTRL_ALARM_CFG_Mask) | RTC_ALARM_ZERO;
+    return time;
+}
+
+uint32_t RTC_ALARM_Time_Once(void)
+{
+    uint32_t time;
 
-   /* Clear sticky wakeup RTC alarm flag */
-   WAKEUP_RTC_ALARM_FLAG_CLEAR();
+    GLOBAL_INT_DISABLE();
 
-   /* Set RTC preload timer counter to DEADBEEF for next wake up */
-   ACS->RTC_CFG = 0xDEADBEEF;
+    time = RTC_ALARM_Count_To_Time(ACS->RTC_COUNT);
 
-   /* Clear the pending GPIO3_IRQ */
-   NVIC_ClearPendingIRQ(GPIO3_IRQn);
+    GLOBAL_INT_RESTORE();
 
-   /* Disable GPIO3 interrupt line */
-   Sys_GPIO_IntConfig(3, NS_CANNOT_ACCESS_GPIO_INT | GPIO_DEBOUNCE_DISABLE | GPIO_EVENT_NONE,
-   		   GPIO_DEBOUNCE_SLOWCLK_DIV32, 0);
+    return time;
+}
 
-   /* Reset GPIO8 */
-   SYS_GPIO_CONFIG(8, GPIO_2X_DRIVE | GPIO_LPF_DISABLE | GPIO_WEAK_PULL_UP | NS_CANNOT_USE_GPIO | GPIO_MODE_DISABLE);
+/**
+ * @brief GPIO3 interrupt handler, sequencing RTC_ALARM_Reconfig() on the
+ *        edges of the RTC clock
+ */
+void GPIO3_IRQHandler(void)
+{
+    if (rtc_reconfig_state == RTC_RECONFIG_WAIT_RISING)
+    {
+        /* Configure RTC timer counter with timeout cycles */
+        ACS->RTC_CFG = rtc_reconfig_counter - 1;
 
-   /* Restore NVIC set enable register */
-   NVIC->ISER[0] = nvic_set_enable[0];
-   NVIC->ISER[1] = nvic_set_enable[1];
+        /* Configure GPIO3 interrupt line to falling edge of GPIO8(standby clock) */
+        RTC_ALARM_Reconfig_Edge(GPIO_EVENT_FALLING_EDGE);
+        rtc_reconfig_state = RTC_RECONFIG_WAIT_FALLING;
+    }
+    else if (rtc_reconfig_state == RTC_RECONFIG_WAIT_FALLING)
+    {
+        /* Start the time of the new count where the previous one ends */
+        uint32_t now = RTC_ALARM_Time();
+
+        /* Reset RTC to load new timer counter */
+        ACS->RTC_CTRL = (ACS->RTC_CTRL & ~ACS_RTC_CTRL_ALARM_CFG_Mask) | RTC_ALARM_DISABLE;
+        ACS->RTC_CTRL |= RTC_RESET;
+        ACS->RTC_CTRL |= RTC_FORCE_CLOCK;
+        ACS->RTC_CTRL = (ACS->RTC_CTRL & ~ACS_RTC_CTRL_ALARM_CFG_Mask) | RTC_ALARM_ZERO;
+
+        rtc_alarm_time = now;
+        rtc_alarm_ticks = rtc_reconfig_counter;
+
+        /* Clear sticky wakeup RTC alarm flag */
+        WAKEUP_RTC_ALARM_FLAG_CLEAR();
+
+        /* Set RTC preload timer counter to DEADBEEF for next wake up */
+        ACS->RTC_CFG = RTC_CFG_RELOAD_VALUE;
+
+        if (rtc_reconfig_restart)
+        {
+            RTC_ALARM_Reconfig_Start();
+        }
+        else
+        {
+            /* Disable GPIO3 interrupt line */
+            RTC_ALARM_Reconfig_Edge(GPIO_EVENT_NONE);
+            NVIC_DisableIRQ(GPIO3_IRQn);
+
+            /* Reset GPIO8 */
+            SYS_GPIO_CONFIG(8, GPIO_2X_DRIVE | GPIO_LPF_DISABLE | GPIO_WEAK_PULL_UP | NS_CANNOT_USE_GPIO | GPIO_MODE_DISABLE);
+
+            rtc_reconfig_state = RTC_RECONFIG_IDLE;
+        }
+    }
 
-   /* Unmask interrupt */
-   __enable_irq();
+    /* Clear the pending GPIO3 IRQ */
+    NVIC_ClearPendingIRQ(GPIO3_IRQn);
 }
 
 /* Configure BB Timer */
@@ -227,19 +412,6 @@ void BB_Timer_Init()
     /* Reset the complete system at 0 */
     BB->RWBBCNTL = MASTER_SOFT_RST_1 | MASTER_TGSOFT_RST_1 | RADIOCNTL_SOFT_RST_1;
 
-    /* Do not change RTC settings, if already enabled*/
-    if(!((WAKEUP_SRC_FLAG_BIT_SET << WAKEUP_SRC_RTC_ALARM) & WAKEUP_SRC_EN_MSK))
-    {
-    	/* Disable RTC */
-    	ACS->RTC_CTRL = RTC_DISABLE;
-
-    	/* Reset RTC */
-    	ACS->RTC_CTRL = RTC_RESET;
-
-    	/* Enable RTC with XTAL32k as clk source */
-    	ACS->RTC_CTRL = RTC_ENABLE | RTC_CLK_SRC_XTAL32K;
-    }
-
     /* Set BB timer not reset bit */
     ACS->BB_TIMER_CTRL = BB_TIMER_NRESET;
 
@@ -283,43 +455,7 @@ void GPIO_Wakeup_Init(void)
 /* Configure and enable sensor interface and FIFO wake up source */
 void Sensor_Init(void)
 {
-
-    uint32_t sensor_if_cfg = SENSOR_ENABLED |
-    		                 SENSOR_RE_VSSA |
-#if SENSOR_CALIB == 1
-                          SENSOR_CALIB_ENABLED |
-#else
-                          SENSOR_CALIB_DISABLED |
-#endif
-#if SENSOR_NORMAL == 1
-						  SENSOR_IOFFSET_40NA |
-                          SENSOR_IRANGE_80NA |
-#elif SENSOR_IMPEDANCE == 1
-						  SENSOR_IOFFSET_40NA |
-                          SENSOR_IRANGE_240NA |
-#endif
-                          SENSOR_AMP_ENABLED |
-						  SENSOR_GUARD_ENABLED;
-
-    uint32_t sensor_timer_ctl = SENSOR_TIMER_ENABLED |
-        					    WAITSLEEP_ENABLED |
-#if SENSOR_NORMAL == 1
-								DLY1_WE_L_NOT_USED |
-								PULSE_CNT_NOT_USED |
-#elif SENSOR_IMPEDANCE == 1
-								DLY1_WE_L_USED |
-								PULSE_CNT_USED |
-#endif
-			                    DLY2_WE_L_NOT_USED |
-			                    DLY1_WE_H_NOT_USED |
-			                    DLY2_WE_H_NOT_USED |
-								IDLE_USED;
-
-    /* Configure and enable clock source for RTC */
-    RTC_ClockSource_Init();
-
-    /* Configure RTC */
-    ACS->RTC_CTRL = RTC_DISABLE | RTC_RESET | RTC_CLK_SRC | RTC_ALARM_DISABLE;
+    RTC_Timebase_Start();
 
     /* Disable the VDDIF regulator */
     ACS->VDDIF_CTRL &= ~VDDIF_ENABLE;
@@ -327,52 +463,41 @@ void Sensor_Init(void)
     /* Enable the sensor clock */
     CLK->DIV_CFG1 = SENSOR_CLK_ENABLE;
 
-#if SENSOR_NORMAL == 1
-    Sys_Sensor_ADCConfig(sensor_if_cfg, SENSOR_WEDAC_HIGH_0600, SENSOR_WEDAC_LOW_0600,
-                         SENSOR_CLK_SRC);
-#elif SENSOR_IMPEDANCE == 1
-    Sys_Sensor_ADCConfig(sensor_if_cfg, SENSOR_WEDAC_HIGH_0616, SENSOR_WEDAC_LOW_0600,
-                         SENSOR_CLK_SRC);
-#endif
-    /* Reset the sensor timer */
-    Sys_Sensor_TimerReset();
-
-    /* Configure sensor timer and specify which state(s) will be used */
-#if SENSOR_WUT == 1
-    Sys_Sensor_TimerConfig(sensor_timer_ctl, RE_DISCONNECTED_BYTE);
-#else
-    Sys_Sensor_TimerConfig(sensor_timer_ctl, RE_CONNECTED_BYTE);
-#endif
-
-    /* Configure length of pre integration state */
-#if SENSOR_NORMAL == 1
-    SENSOR->INT_CFG = PRE_COUNT_INT_VALUE_2S;
-#elif SENSOR_IMPEDANCE == 1
-    SENSOR->INT_CFG = PRE_COUNT_INT_VALUE_3P9MS;
-#endif
-
-    /* Configure length of delay state */
-#if SENSOR_NORMAL == 1
-    SENSOR_DELAY_L_CFG->DLY1_WE_L_SHORT = DLY1_WE_L_DIV_ENABLED_SHORT | DLY1_WE_L_VALUE_1S;
-#elif SENSOR_IMPEDANCE == 1
-    SENSOR_DELAY_L_CFG->DLY1_WE_L_SHORT = DLY1_WE_L_DIV_ENABLED_SHORT | DLY1_WE_L_VALUE_117P19MS;
-#endif
-
-    /* Configure length of idle state */
-#if SENSOR_NORMAL == 1
-    Sys_Sensor_IdleConfig(IDLE_TIME_VALUE_27S);
-#elif SENSOR_IMPEDANCE == 1
-    Sys_Sensor_IdleConfig(IDLE_TIME_VALUE_29P875S);
-#endif
-
-    /* Read position 0 of ADC data to reset the FIFO */
-    SensorFIFO_Reset();
-
-    /* Configure sample storage FIFO
-     * Set ADC threshold and number of samples */
-    Sys_Sensor_StorageConfig(diff_mode, SENSOR_SUMMATION_DISABLED,
-                             number_of_samples, adc_threshold,
-                             SENSOR_FIFO_STORE_ENABLED, fifo_size);
+    /* Configure the sensor interface, timer states and sample storage; other
+     * profiles can be applied at runtime with Sensor_Profile_Apply() */
+    Sensor_Profile_Apply(SENSOR_PROFILE_DEFAULT);
+
+    /* Start from the threshold of the profile; Sensor_FIFO_Resize() keeps
+     * the threshold programmed at runtime */
+    SENSOR->PROCESSING = (SENSOR->PROCESSING & ~SENSOR_PROCESSING_THRESHOLD_Mask) |
+                         (Sensor_Profile_Get(SENSOR_PROFILE_DEFAULT)->threshold & SENSOR_PROCESSING_THRESHOLD_Mask);
+}
+
+uint8_t Sensor_Restore(void)
+{
+    uint32_t start __attribute__ ((unused)) = METRICS_CYCLES();
+    uint8_t result;
+
+    if (!Sensor_Profile_Valid())
+    {
+        Sensor_Init();
+        result = SENSOR_RESTORE_COLD;
+    }
+    else if (Sensor_Profile_Check())
+    {
+        result = SENSOR_RESTORE_RETAINED;
+    }
+    else
+    {
+        /* The RTC keeps running: only the sensor clock and profile are lost */
+        CLK->DIV_CFG1 = SENSOR_CLK_ENABLE;
+        Sensor_Profile_Apply(Sensor_Profile_Current());
+        result = SENSOR_RESTORE_REAPPLIED;
+    }
+
+    Metrics_SensorRestore(start, result);
+
+    return result;
 }
 
 /* Configure NFC Interrupts */
@@ -409,6 +534,9 @@ void NFC_Init(void)
     /* Enable interrupts for NFC*/
     _isohf_enableEndOfComIt(HFCTRL_IP);
 
+    /* Serve the frames from the NFC interrupt */
+    NFC_Engine_Init();
+
     /* Setup anti collision response */
     Layer3Source[0] = 0x44;             /* ATQA first byte */
     Layer3Source[1] = 0x00;             /* ATQA second byte */
@@ -423,9 +551,8 @@ void NFC_Init(void)
     Layer3Source[10] = RAW_ARRAY[8];    /* UID8 */
     Layer3Source[11] = RAW_ARRAY[9];    /* UID9 */
     Layer3Source[12] = 0x0F;            /* SAK NOT COMP */
-    Layer3Source[13] = 0x00;            /* SAK OK (This byte indicates if compatible or not with ISO 14443-4, in this
-                                         * case
-                                         * not compatible) */
+    Layer3Source[13] = NFC_ISO4_SAK;    /* SAK OK (This byte indicates if compatible or not with ISO 14443-4,
+                                         * compatible when NFC_ISO4_EN is set) */
 
     /* Waiting for the end of the boot if the boot triggers the HF */
     _isohf_setProtocolUID(HFCTRL_IP, 1);
@@ -437,8 +564,8 @@ void NFC_Init(void)
 /* Configure ADC Threshold Interrupts */
 void ADC_Threshold_Init(void)
 {
-    /* Configure sensor interface */
-    Sensor_Init();
+    /* Configure sensor interface, if not done already */
+    Sensor_Restore();
 
     /* Clear sticky wake up THRESHOLD FULL flag */
     WAKEUP_THRESHOLD_FULL_FLAG_CLEAR();
@@ -447,8 +574,8 @@ void ADC_Threshold_Init(void)
 /* Configure ADC FIFO Interrupts */
 void ADC_FIFO_Init(void)
 {
-    /* Configure sensor interface */
-    Sensor_Init();
+    /* Configure sensor interface, if not done already */
+    Sensor_Restore();
 
     /* Clear sticky wake up FIFO FULL flag */
     WAKEUP_FIFO_FULL_FLAG_CLEAR();
@@ -485,5 +612,27 @@ void SENSOR_DET_Init(void)
 /* Reset FIFO */
 void SensorFIFO_Reset(void)
 {
-    reset_fifo_level = SENSOR->ADC_DATA[0];
+    reset_fifo_level = SENSOR_ADC_DATA(0);
+}
+
+void Sensor_FIFO_Resize(uint32_t size)
+{
+    const sensor_profile_t *profile = Sensor_Profile_Get(Sensor_Profile_Current());
+    uint32_t threshold;
+
+    fifo_size = size;
+
+    /* Keep the threshold programmed at runtime, possibly moved or disarmed
+     * by the threshold manager from the wakeup interrupt */
+    GLOBAL_INT_DISABLE();
+    threshold = SENSOR->PROCESSING & SENSOR_PROCESSING_THRESHOLD_Mask;
+    Sys_Sensor_StorageConfig(profile->diff_mode, SENSOR_SUMMATION_DISABLED,
+                             number_of_samples, threshold,
+                             SENSOR_FIFO_STORE_ENABLED, fifo_size);
+    GLOBAL_INT_RESTORE();
+}
+
+uint32_t Sensor_FIFO_Size(void)
+{
+    return fifo_size;
 }
@@ -0,0 +1,39 @@
+/**
+ * @file wakeup_trace.c
+ * @brief Retained wakeup trace
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include "app.h"
+#include "wakeup_trace.h"
+
+#if WAKEUP_TRACE_EN
+
+wakeup_trace_t wakeup_trace __attribute__ ((section(".noinit")));
+
+void Wakeup_Trace_Init(void)
+{
+    if (wakeup_trace.magic != WAKEUP_TRACE_MAGIC)
+    {
+        memset(&wakeup_trace, 0, sizeof(wakeup_trace));
+        wakeup_trace.cycle_shift = WAKEUP_TRACE_CYCLE_SHIFT;
+        wakeup_trace.length_log2 = (uint8_t)__builtin_ctz(WAKEUP_TRACE_LENGTH);
+        wakeup_trace.magic = WAKEUP_TRACE_MAGIC;
+    }
+
+    /* The system clock may differ from the previous run */
+    wakeup_trace.core_clock = SystemCoreClock;
+}
+
+#endif    /* if WAKEUP_TRACE_EN */
@@ -102,6 +102,23 @@ void _LLHW_isohf_launchTx(HFCTRL isohf,
                           uint32_t tx_frame_size,
                           uint32_t end_of_transaction);
 
+/**
+ * Configures and controls the HF Subsystem for launching a Tx frame of any
+ * number of bits
+ *
+ * Same as _LLHW_isohf_launchTx(), with the frame size given in bits so that
+ * short frames such as the 4-bit ACK/NAK can be sent. The last byte of the
+ * frame holds the remaining bits, right aligned.
+ *
+ * @param[in] tx_frame_bits       Defines the Tx frame size in bits
+ *                                1 to 0x2000 - no check on the value
+ */
+void _LLHW_isohf_launchTxBits(HFCTRL isohf,
+                              uint32_t back_to_halt,
+                              uint32_t silent_time,
+                              uint32_t tx_frame_bits,
+                              uint32_t end_of_transaction);
+
 /**
  * Get the Silent Time Ts depending on current slot timer read value
  *
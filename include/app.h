@@ -22,6 +22,25 @@
  * --------------------------------------------------------------------------*/
 #include "app_init.h"
 #include "wakeup_source_config.h"
+#include "power_governor.h"
+#include "app_metrics.h"
+#include "app_benchmark.h"
+#include "async_read.h"
+#include "wakeup_trace.h"
+#include "sw_timer.h"
+#include "timebase.h"
+#include "event_queue.h"
+#include "sample_buffer.h"
+#include "sample_log.h"
+#include "sensor_dsp.h"
+#include "sensor_profile.h"
+#include "threshold_manager.h"
+#include "sensor_replay.h"
+#include "impedance.h"
+#include "fifo_controller.h"
+#include "nfc_engine.h"
+#include "nfc_type2.h"
+#include "nfc_iso4.h"
 #include "flash_rom.h"
 #include <calibration.h>
 
@@ -41,6 +60,7 @@ extern sleep_mode_cfg app_sleep_mode_cfg;
 #define SLEEP_MODE_TEST_MEMORY_RETENTION           1
 #define SLEEP_MODE_TEST_CORE_RETENTION             2
 #define DEEP_SLEEP_TEST                            3
+#define SLEEP_MODE_TEST_GOVERNOR                   4
 
 /** @brief Disable interrupts globally in the system.
  * This macro must be used in conjunction with the @ref GLOBAL_INT_RESTORE macro since this
@@ -62,6 +82,8 @@ extern sleep_mode_cfg app_sleep_mode_cfg;
  *   - SLEEP_MODE_TEST_NO_RETENTION
  *   - SLEEP_MODE_TEST_CORE_RETENTION
  *   - DEEP_SLEEP_TEST
+ *   - SLEEP_MODE_TEST_GOVERNOR: select one of the above before every sleep
+ *     from the time until the next deadline (see power_governor.h)
  */
 #define SLEEP_MODE_TEST                 SLEEP_MODE_TEST_CORE_RETENTION
 
@@ -83,6 +105,19 @@ extern sleep_mode_cfg app_sleep_mode_cfg;
 #define SENSOR_IMPEDANCE    0
 #define SENSOR_WUT          0
 
+/* Measurement profile applied by Sensor_Init(); one firmware can switch
+ * between profiles at runtime with Sensor_Profile_Apply() */
+#if SENSOR_IMPEDANCE == 1
+#define SENSOR_PROFILE_DEFAULT          SENSOR_PROFILE_IMPEDANCE
+#else    /* if SENSOR_IMPEDANCE == 1 */
+#define SENSOR_PROFILE_DEFAULT          SENSOR_PROFILE_NORMAL
+#endif    /* if SENSOR_IMPEDANCE == 1 */
+
+/* Apply the impedance profile for one FIFO wakeup out of every
+ * SENSOR_IMPEDANCE_CHECK_PERIOD, and the default profile otherwise
+ * (0: always use the default profile) */
+#define SENSOR_IMPEDANCE_CHECK_PERIOD   0
+
 /* Enable Wakeup Sources for the application */
 #define WAKEUP_SRC_RTC_ALARM_EN            0
 #define WAKEUP_SRC_BB_EN                   0
@@ -184,19 +219,42 @@ extern sleep_mode_cfg app_sleep_mode_cfg;
 /* Sensor Calibration mode */
 #define SENSOR_CALIB                    0
 
-/* Convert time(ms) to RTC timer counter value */
-#define CONVERT_TO_RTC_TIMER_COUNTER(x) 	(x * 32.768)
+/* Convert time(ms) to RTC timer counter value (integer only, see timebase.h) */
+#define CONVERT_TO_RTC_TIMER_COUNTER(x) 	TIMEBASE_MS_TO_TICKS(x)
+
+/* Maximum number of wakeup event handlers */
+#define WAKEUP_HANDLER_MAX              12
 
-/* Flag to check if wakeup happened due to RTC */
-extern uint8_t wakeup_due_to_RTC;
+/* Number of wakeup event handlers registered by default */
+#define WAKEUP_HANDLER_DEFAULT_COUNT    7
+
+/* Maximum number of times WAKEUP_IRQHandler re-latches the wakeup flags
+ * before leaving the remaining events to the next interrupt */
+#define WAKEUP_DISPATCH_MAX_PASS        4
+
+/* Wakeup_Handler_Register() return values */
+#define WAKEUP_HANDLER_NO_ERROR         (uint8_t)(0x0)
+#define WAKEUP_HANDLER_TABLE_FULL       (uint8_t)(0x1)
+
+/* Wakeup event handler registration */
+typedef struct
+{
+    uint32_t event;             /* Event flag in ACS->WAKEUP_CTRL (one bit) */
+    uint32_t clear;             /* Bits written to ACS->WAKEUP_CTRL to clear the
+                                 * flag, 0 if the handler clears it itself */
+    uint32_t src;               /* Wakeup source (WAKEUP_SRC_*) for metrics and trace */
+    void (*handler)(void);
+} wakeup_handler_t;
 
 /* ---------------------------------------------------------------------------
 * Function prototypes
 * --------------------------------------------------------------------------*/
 /**
- * @brief Performs application operations and enters power modes
+ * @brief      Performs application operations and enters power modes
+ * @param [in] cold_boot  true after a cold boot, false after a wakeup through
+ *                        reset, where the retained state is kept
  */
-void Main_Loop(void);
+void Main_Loop(uint8_t cold_boot);
 
 void SoC_Sleep(void);
 
@@ -214,6 +272,22 @@ void Threshold_Wakeup_Process_Handler(void);
 
 void Sensor_Detection_Wakeup_Process_Handler(void);
 
+void BB_Timer_Wakeup_Process_Handler(void);
+
+/**
+ * @brief      Register the handler called by WAKEUP_IRQHandler for a wakeup
+ *             event, replacing any handler registered for the same event
+ * @param [in] event    Event flag in ACS->WAKEUP_CTRL (one bit)
+ * @param [in] clear    Bits written to ACS->WAKEUP_CTRL to clear the flag
+ *                      before the handler is called, 0 if the handler clears it
+ * @param [in] src      Wakeup source (WAKEUP_SRC_*) for metrics and trace
+ * @param [in] handler  Handler to call; NULL removes the handler registered
+ *                      for the event, which is then no longer dispatched
+ * @return     WAKEUP_HANDLER_NO_ERROR, or WAKEUP_HANDLER_TABLE_FULL
+ */
+uint8_t Wakeup_Handler_Register(uint32_t event, uint32_t clear, uint32_t src,
+                                void (*handler)(void));
+
 /* ----------------------------------------------------------------------------
  * Close the 'extern "C"' block
  * ------------------------------------------------------------------------- */
@@ -0,0 +1,156 @@
+/**
+ * @file app_benchmark.h
+ * @brief Scripted wakeup scenarios measuring the cost of each wakeup source
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#ifndef APP_BENCHMARK_H_
+#define APP_BENCHMARK_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Set this to 1 to run the benchmark scenarios after a cold boot: wakeup
+ * events are injected into WAKEUP_IRQHandler() at scripted times, and the
+ * metrics collected over each scenario are kept in app_benchmark.
+ * note: Needs APP_METRICS_EN; the injected events run the real handlers
+ *       and Main_Loop() on top of the normal wakeup sources */
+#ifndef APP_BENCHMARK_EN
+#define APP_BENCHMARK_EN                0
+#endif    /* ifndef APP_BENCHMARK_EN */
+
+/* Number of scenarios in the script */
+#define BENCHMARK_SCENARIO_COUNT        6
+
+/* Marker used to detect a valid benchmark state after a reset */
+#define BENCHMARK_MAGIC                 (uint32_t)(0x42454E45)
+
+/* Scenario: count wakeups raising the events, one every period_ms */
+typedef struct
+{
+    /* Flags injected in ACS->WAKEUP_CTRL (WAKEUP_*_EVENT_SET), 0 for a
+     * reference with only the benchmark timer waking up the core */
+    uint32_t events;
+    uint32_t count;
+    uint32_t period_ms;
+
+    /* Set to 1 to configure the sensor with Sensor_Restore() at each wakeup
+     * instead, taking in turn the cold init, profile applied again and
+     * configuration kept paths */
+    uint8_t sensor_restore;
+} benchmark_scenario_t;
+
+/* Metrics collected over one scenario */
+typedef struct
+{
+    /* Wakeups dispatched by WAKEUP_IRQHandler(), all sources */
+    uint32_t wakeups;
+
+    /* System clock cycles in run mode and inside WAKEUP_IRQHandler() */
+    uint64_t run_cycles;
+    uint64_t wakeup_irq_cycles;
+
+    /* Peripheral register accesses on the wakeup path */
+    uint32_t reg_accesses;
+
+    /* System clock cycles spent compressing samples into the sample log,
+     * and number of samples compressed */
+    uint64_t sample_log_cycles;
+    uint32_t sample_log_samples;
+
+    /* Sensor configurations and system clock cycles spent in them, per path
+     * (SENSOR_RESTORE_*) */
+    uint32_t sensor_restores[METRICS_SENSOR_PATH_COUNT];
+    uint64_t sensor_restore_cycles[METRICS_SENSOR_PATH_COUNT];
+
+    /* RTC clock cycles asleep, all power modes */
+    uint64_t sleep_ticks;
+
+    /* Estimated charge in nC, from the METRICS_CURRENT_* table */
+    uint64_t charge_nc;
+} benchmark_result_t;
+
+/* Benchmark state and results, kept in the non-initialized section so that
+ * a run survives the reset following a wakeup from sleep without retention */
+typedef struct
+{
+    uint32_t magic;
+
+    /* Scenario running, BENCHMARK_SCENARIO_COUNT once all are done, and
+     * wakeups injected so far */
+    uint32_t scenario;
+    uint32_t injected;
+
+    /* Metrics at the start of the running scenario */
+    benchmark_result_t start;
+
+    benchmark_result_t results[BENCHMARK_SCENARIO_COUNT];
+} app_benchmark_t;
+
+#if APP_BENCHMARK_EN
+
+/* Benchmark state; read the results with the debugger */
+extern app_benchmark_t app_benchmark;
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Clear the results and start the first scenario
+ * @assumptions Called after SW_Timer_Init() or SW_Timer_Restore()
+ */
+void Benchmark_Start(void);
+
+/**
+ * @brief  Keep the run in progress through a wakeup through reset
+ * @return true if the retained state is valid, false if the run must be
+ *         started again
+ */
+uint8_t Benchmark_Restore(void);
+
+/**
+ * @brief  Take the events injected since the last call
+ * @return WAKEUP_*_EVENT_SET flags to handle as if read from
+ *         ACS->WAKEUP_CTRL
+ * @assumptions Called from WAKEUP_IRQHandler()
+ */
+uint32_t Benchmark_Take_Events(void);
+
+#else    /* if APP_BENCHMARK_EN */
+
+#define Benchmark_Start()
+#define Benchmark_Restore()             1
+#define Benchmark_Take_Events()         0
+
+#endif    /* if APP_BENCHMARK_EN */
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_BENCHMARK_H_ */
@@ -0,0 +1,226 @@
+/**
+ * @file app_metrics.h
+ * @brief Run mode and energy metrics header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef APP_METRICS_H_
+#define APP_METRICS_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "power_governor.h"
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Set this to 1 to collect run mode and energy metrics.
+ * note: Cycle counts use the DWT unit, so POWER_DOWN_DBG must be left 0 */
+#ifndef APP_METRICS_EN
+#define APP_METRICS_EN                  1
+#endif    /* ifndef APP_METRICS_EN */
+
+/* Current drawn in each state, used to estimate the charge consumed.
+ * PLACEHOLDERS: these values are not taken from the datasheet or from a
+ * measurement; replace them with the currents measured on the target board
+ * (VCC_LDO, SYSTEM_CLK = 8 MHz) before relying on the charge estimate. Run
+ * time comparisons between builds do not depend on them.
+ *   - Run mode in uA
+ *   - Sleep modes in nA */
+#define METRICS_CURRENT_RUN_UA                  (uint32_t)(1100)
+#define METRICS_CURRENT_CORE_RETENTION_NA       (uint32_t)(1400)
+#define METRICS_CURRENT_NO_RETENTION_NA         (uint32_t)(600)
+#define METRICS_CURRENT_DEEP_SLEEP_NA           (uint32_t)(90)
+
+/* Number of wakeup source counters (indexed by WAKEUP_SRC_*) */
+#define METRICS_WAKEUP_SRC_COUNT        8
+
+/* Number of sensor configuration paths (indexed by SENSOR_RESTORE_*) */
+#define METRICS_SENSOR_PATH_COUNT       3
+
+/* Number of asynchronous registers (indexed by ASYNC_REG_*) */
+#define METRICS_ASYNC_REG_COUNT         2
+
+/* Marker used to detect a valid metrics block after a reset */
+#define METRICS_MAGIC                   (uint32_t)(0x4D455457)
+
+typedef struct
+{
+    uint32_t magic;
+
+    /* Number of wakeups per source */
+    uint32_t wakeups[METRICS_WAKEUP_SRC_COUNT];
+
+    /* Number of sleeps and time asleep (RTC clock cycles) per power mode */
+    uint32_t sleeps[POWER_MODE_COUNT];
+    uint64_t sleep_ticks[POWER_MODE_COUNT];
+
+    /* System clock cycles spent in run mode */
+    uint64_t run_cycles;
+
+    /* System clock cycles spent inside WAKEUP_IRQHandler */
+    uint64_t wakeup_irq_cycles;
+    uint32_t wakeup_irq_max_cycles;
+
+    /* System clock cycles spent compressing samples into the sample log,
+     * and number of samples compressed */
+    uint64_t sample_log_cycles;
+    uint32_t sample_log_samples;
+
+    /* Number of sensor configurations and system clock cycles spent in
+     * them, per path: cold init, profile applied again, or kept */
+    uint32_t sensor_restores[METRICS_SENSOR_PATH_COUNT];
+    uint64_t sensor_restore_cycles[METRICS_SENSOR_PATH_COUNT];
+
+    /* System clock cycles from the start of main() to the end of the set up
+     * after a wakeup through reset: last and largest */
+    uint32_t reset_path_cycles;
+    uint32_t reset_path_max_cycles;
+
+    /* Consistent reads of asynchronous registers: number of reads, extra
+     * reads needed for two consecutive reads to agree, and reads that never
+     * agreed */
+    uint32_t async_reads[METRICS_ASYNC_REG_COUNT];
+    uint32_t async_retries[METRICS_ASYNC_REG_COUNT];
+    uint32_t async_unstable[METRICS_ASYNC_REG_COUNT];
+
+    /* Peripheral register reads and writes on the wakeup path: the wakeup
+     * flags, the sensor FIFO and threshold, and the asynchronous registers */
+    uint32_t reg_accesses;
+
+    /* Sleep in progress: power mode and RTC_ALARM_Time() at sleep entry */
+    uint32_t sleep_mode;
+    uint32_t sleep_rtc_time;
+} app_metrics_t;
+
+#if APP_METRICS_EN
+
+/* Metrics block, kept in the non-initialized section so that it survives
+ * the reset following a wakeup from sleep without retention */
+extern app_metrics_t app_metrics;
+
+/* Read the free-running cycle counter */
+#define METRICS_CYCLES()                (DWT->CYCCNT)
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Enable the cycle counter and validate the metrics block
+ */
+void Metrics_Init(void);
+
+/**
+ * @brief      Close the current run period before entering a power mode
+ * @param [in] mode  Power mode about to be entered
+ */
+void Metrics_SleepEnter(power_mode_t mode);
+
+/**
+ * @brief Account for the time asleep and open a new run period; call as
+ *        soon as execution resumes after a sleep
+ */
+void Metrics_SleepExit(void);
+
+/**
+ * @brief      Count a wakeup event
+ * @param [in] src  Wakeup source (WAKEUP_SRC_*)
+ */
+void Metrics_Wakeup(uint32_t src);
+
+/**
+ * @brief      Account for one execution of WAKEUP_IRQHandler
+ * @param [in] start  Value of METRICS_CYCLES() on handler entry
+ */
+void Metrics_WakeupIRQ(uint32_t start);
+
+/**
+ * @brief      Account for one write to the sample log
+ * @param [in] start    Value of METRICS_CYCLES() before the write
+ * @param [in] samples  Number of samples compressed
+ */
+void Metrics_SampleLog(uint32_t start, uint32_t samples);
+
+/**
+ * @brief      Account for one configuration of the sensor
+ * @param [in] start  Value of METRICS_CYCLES() before the configuration
+ * @param [in] path   Path taken (SENSOR_RESTORE_*)
+ */
+void Metrics_SensorRestore(uint32_t start, uint32_t path);
+
+/**
+ * @brief Account for the set up after a wakeup through reset; call once the
+ *        application interrupts are enabled, before Main_Loop()
+ */
+void Metrics_ResetPath(void);
+
+/**
+ * @brief      Account for one consistent read of an asynchronous register
+ * @param [in] reg      Register (ASYNC_REG_*)
+ * @param [in] retries  Number of extra reads
+ * @param [in] status   Result of the read (ASYNC_READ_*)
+ */
+void Metrics_AsyncRead(uint32_t reg, uint32_t retries, uint32_t status);
+
+/**
+ * @brief      Count peripheral register accesses
+ * @param [in] count  Number of reads and writes
+ */
+void Metrics_RegAccess(uint32_t count);
+
+/**
+ * @brief  Estimate the charge consumed since the metrics were cleared
+ * @return Charge in nC, from the time spent in each state and the
+ *         METRICS_CURRENT_* table
+ */
+uint64_t Metrics_Charge_nC(void);
+
+/**
+ * @brief Clear all counters, e.g. at the start of a benchmark scenario
+ */
+void Metrics_Clear(void);
+
+#else    /* if APP_METRICS_EN */
+
+#define METRICS_CYCLES()                0
+#define Metrics_Init()
+#define Metrics_SleepEnter(mode)
+#define Metrics_SleepExit()
+#define Metrics_Wakeup(src)
+#define Metrics_WakeupIRQ(start)
+#define Metrics_SampleLog(start, samples)
+#define Metrics_SensorRestore(start, path)
+#define Metrics_ResetPath()
+#define Metrics_AsyncRead(reg, retries, status)
+#define Metrics_RegAccess(count)
+#define Metrics_Charge_nC()             0
+#define Metrics_Clear()
+
+#endif    /* if APP_METRICS_EN */
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_METRICS_H_ */
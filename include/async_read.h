@@ -0,0 +1,97 @@
+/**
+ * @file async_read.h
+ * @brief Consistent reads of asynchronous registers header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef ASYNC_READ_H_
+#define ASYNC_READ_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "montana.h"
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Largest number of reads of a register before giving up on two consecutive
+ * reads agreeing */
+#define ASYNC_READ_MAX_TRIES            10
+
+/* Async_Read() return codes */
+#define ASYNC_READ_NO_ERROR             (uint8_t)(0x00)
+#define ASYNC_READ_UNSTABLE             (uint8_t)(0x01)    /* value of the last read returned */
+
+/* Registers updated from another clock domain, used to index the metrics */
+typedef enum
+{
+    ASYNC_REG_RTC_COUNT  = 0,    /* ACS->RTC_COUNT, RTC clock */
+    ASYNC_REG_FIFO_LEVEL = 1,    /* FIFO_LEVEL of SENSOR->FIFO_CFG, sensor clock */
+    ASYNC_REG_COUNT      = 2
+} async_reg_t;
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief       Read a register until two consecutive reads agree
+ * @param [in]  reg    Register to read
+ * @param [in]  mask   Bits of the register to compare and return
+ * @param [in]  id     Register, for the metrics
+ * @param [out] value  Register value, masked
+ * @return      ASYNC_READ_NO_ERROR, or ASYNC_READ_UNSTABLE if no two
+ *              consecutive reads agreed within ASYNC_READ_MAX_TRIES reads
+ */
+uint8_t Async_Read(const volatile uint32_t *reg, uint32_t mask, async_reg_t id, uint32_t *value);
+
+/**
+ * @brief       Read the RTC count
+ * @param [out] value  RTC count
+ * @return      ASYNC_READ_NO_ERROR or ASYNC_READ_UNSTABLE
+ */
+static inline uint8_t Async_Read_RTC_Count(uint32_t *value)
+{
+    return Async_Read(&ACS->RTC_COUNT, 0xFFFFFFFF, ASYNC_REG_RTC_COUNT, value);
+}
+
+/**
+ * @brief       Read the number of samples in the sensor FIFO
+ * @param [out] value  FIFO level
+ * @return      ASYNC_READ_NO_ERROR or ASYNC_READ_UNSTABLE
+ */
+static inline uint8_t Async_Read_FIFO_Level(uint32_t *value)
+{
+    uint8_t status = Async_Read(&SENSOR->FIFO_CFG, SENSOR_FIFO_CFG_FIFO_LEVEL_Mask,
+                                ASYNC_REG_FIFO_LEVEL, value);
+
+    *value >>= SENSOR_FIFO_CFG_FIFO_LEVEL_Pos;
+
+    return status;
+}
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* ASYNC_READ_H_ */
@@ -0,0 +1,113 @@
+/**
+ * @file event_queue.h
+ * @brief Deferred event queue header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef EVENT_QUEUE_H_
+#define EVENT_QUEUE_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Number of events the queue can hold (power of 2) */
+#ifndef EVENT_QUEUE_LENGTH
+#define EVENT_QUEUE_LENGTH              16
+#endif    /* ifndef EVENT_QUEUE_LENGTH */
+
+/* Number of wakeup sources that can be signaled with Event_Signal() */
+#define EVENT_SIGNAL_COUNT              32
+
+/* Event types */
+#define EVENT_WAKEUP                    1    /* arg: WAKEUP_SRC_*, data: source specific */
+#define EVENT_NFC                       2    /* arg: NFC_ENGINE_EVENT_*, data: event specific */
+
+/* Event posted by an interrupt handler for the main loop */
+typedef struct
+{
+    uint8_t type;
+    uint8_t arg;
+    uint16_t data;
+    uint32_t value;
+} app_event_t;
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief      Post an event to the main loop
+ * @param [in] type   Event type (EVENT_*)
+ * @param [in] arg    Event argument
+ * @param [in] data   Event data
+ * @param [in] value  Event value
+ * @return     1 if the event was queued, 0 if the queue was full and the
+ *             event was dropped
+ * @assumptions Single producer: only called from interrupt handlers that
+ *              cannot preempt each other (same priority), or with the
+ *              execution priority raised to theirs
+ */
+uint8_t Event_Post(uint32_t type, uint32_t arg, uint32_t data, uint32_t value);
+
+/**
+ * @brief      Signal a wakeup source to the main loop. Unlike a posted
+ *             event, a signal is never dropped: the signals of a source not
+ *             yet taken by Event_Get() are merged into one, which carries the
+ *             value of the last of them
+ * @param [in] src    Wakeup source (WAKEUP_SRC_*, below EVENT_SIGNAL_COUNT)
+ * @param [in] value  Event value
+ * @assumptions Same producers as Event_Post()
+ */
+void Event_Signal(uint32_t src, uint32_t value);
+
+/**
+ * @brief       Take the next event: the signaled wakeup sources first, lowest
+ *              source first, as EVENT_WAKEUP events, then the oldest event
+ *              of the queue
+ * @param [out] event  Event taken
+ * @return      1 if an event was taken, 0 if the queue is empty
+ * @assumptions Single consumer: only called from the main loop
+ */
+uint8_t Event_Get(app_event_t *event);
+
+/**
+ * @brief  Check if the queue is empty and no wakeup source is signaled; call
+ *         with interrupts disabled before entering a power mode
+ * @return 1 if no event is waiting, 0 otherwise
+ */
+uint8_t Event_Queue_Empty(void);
+
+/**
+ * @brief  Number of events dropped because the queue was full
+ * @return Number of dropped events
+ */
+uint32_t Event_Queue_Dropped(void);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* EVENT_QUEUE_H_ */
@@ -0,0 +1,90 @@
+/**
+ * @file fifo_controller.h
+ * @brief Adaptive sensor FIFO depth controller header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef FIFO_CONTROLLER_H_
+#define FIFO_CONTROLLER_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Largest step between two consecutive samples (ADC LSBs) above which the
+ * signal is considered active: the FIFO depth is halved */
+#define FIFO_CONTROLLER_ACTIVITY_HIGH   (uint32_t)(0x200)
+
+/* Largest step between two consecutive samples (ADC LSBs) below which the
+ * signal is considered quiet: the FIFO depth is doubled */
+#define FIFO_CONTROLLER_ACTIVITY_LOW    (uint32_t)(0x40)
+
+/* Longest time a sample may wait in the FIFO before being processed */
+#define FIFO_CONTROLLER_MAX_LATENCY_MS  (uint32_t)(300000)
+
+/* Marker used to detect a valid controller state after a reset */
+#define FIFO_CONTROLLER_MAGIC           (uint32_t)(0x46494632)
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Start from the FIFO depth configured by Sensor_Init(); call on a
+ *        cold boot
+ */
+void FIFO_Controller_Init(void);
+
+/**
+ * @brief  Keep the FIFO depth chosen before a wakeup through reset
+ * @return true if the retained state was valid, false if it was lost and
+ *         the controller started again with FIFO_Controller_Init()
+ */
+uint8_t FIFO_Controller_Restore(void);
+
+/**
+ * @brief      Account for a sample taken from the sample buffer
+ * @param [in] value  Sample value
+ */
+void FIFO_Controller_Sample(uint32_t value);
+
+/**
+ * @brief Choose the FIFO depth from the samples seen since the last update;
+ *        call after processing the samples of a FIFO wakeup
+ */
+void FIFO_Controller_Update(void);
+
+/**
+ * @brief Program the FIFO depth chosen by FIFO_Controller_Update()
+ * @assumptions Called from the FIFO wakeup handler, right after the FIFO has
+ *              been emptied
+ */
+void FIFO_Controller_Apply(void);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* FIFO_CONTROLLER_H_ */
@@ -0,0 +1,135 @@
+/**
+ * @file impedance.h
+ * @brief Impedance measurement header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef IMPEDANCE_H_
+#define IMPEDANCE_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "sample_buffer.h"
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Voltage step applied by the impedance profile in uV (WEDAC high 616 mV,
+ * WEDAC low 600 mV) */
+#define IMPEDANCE_STEP_UV               (uint32_t)(16000)
+
+/* Current of one ADC LSB in pA with the 240 nA range of the impedance
+ * profile; typical value, to be replaced with the value measured on the
+ * target board */
+#define IMPEDANCE_PA_PER_LSB            (uint32_t)(15)
+
+/* Number of differential pairs (WEDAC high sample, WEDAC low sample) in one
+ * measurement cycle */
+#define IMPEDANCE_PAIRS_PER_CYCLE       2
+
+/* Number of samples in one measurement cycle */
+#define IMPEDANCE_CYCLE_SAMPLES         (2 * IMPEDANCE_PAIRS_PER_CYCLE)
+
+/* Largest number of points of the calibration curve */
+#define IMPEDANCE_CAL_POINTS_MAX        8
+
+/* Marker used to detect a valid calibration curve after a reset */
+#define IMPEDANCE_CAL_MAGIC             (uint32_t)(0x494D5043)
+
+/* Impedance_Measure() and Impedance_Calibration_Set() return codes */
+#define IMPEDANCE_NO_ERROR              (uint8_t)(0x00)
+#define IMPEDANCE_NO_SIGNAL             (uint8_t)(0x01)    /* no current step measured */
+#define IMPEDANCE_INVALID               (uint8_t)(0x02)
+
+/* One point of the calibration curve: the raw estimate for a reference
+ * impedance, and the phase error at that point */
+typedef struct
+{
+    uint32_t raw_ohm;
+    uint32_t ohm;
+    int16_t phase_offset_cdeg;
+} impedance_cal_point_t;
+
+/* Result of one measurement cycle */
+typedef struct
+{
+    /* Time of the first sample of the cycle, in timebase ticks */
+    uint32_t time;
+
+    /* Calibrated impedance magnitude in ohms */
+    uint32_t ohm;
+
+    /* Phase in hundredths of a degree: 0 for a resistive load, -9000 for a
+     * capacitive one */
+    int16_t phase_cdeg;
+} impedance_result_t;
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Load the identity calibration curve; call on a cold boot
+ */
+void Impedance_Init(void);
+
+/**
+ * @brief  Keep the calibration curve set before a wakeup through reset
+ * @return true if the retained curve was valid, false if it was lost and the
+ *         identity curve loaded with Impedance_Init()
+ */
+uint8_t Impedance_Restore(void);
+
+/**
+ * @brief      Estimate the impedance from one measurement cycle. The
+ *             magnitude is the voltage step over the current step of the last
+ *             pair, once settled; the phase comes from the part of the current
+ *             step of the first pair that has decayed by the last pair.
+ * @param [in] samples  IMPEDANCE_CYCLE_SAMPLES samples, oldest first, as pairs
+ *                      of WEDAC high and WEDAC low samples
+ * @param [out] result  Impedance estimate
+ * @return     IMPEDANCE_NO_ERROR, or IMPEDANCE_NO_SIGNAL if the current step
+ *             of the last pair is not positive
+ */
+uint8_t Impedance_Measure(const sensor_sample_t *samples, impedance_result_t *result);
+
+/**
+ * @brief      Replace the calibration curve; the curve is retained through a
+ *             wakeup through reset, but must be set again after a cold boot
+ * @param [in] points  Points sorted by increasing raw_ohm; copied
+ * @param [in] count   Number of points, 2 to IMPEDANCE_CAL_POINTS_MAX
+ * @return     IMPEDANCE_NO_ERROR or IMPEDANCE_INVALID
+ */
+uint8_t Impedance_Calibration_Set(const impedance_cal_point_t *points, uint32_t count);
+
+/**
+ * @brief  Last measurement
+ * @return Result of the last successful Impedance_Measure()
+ */
+const impedance_result_t *Impedance_Last(void);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* IMPEDANCE_H_ */
@@ -21,8 +21,8 @@ uint32_t _LLHW_isohf_compareIORAM2Mem_local(HFCTRL isohf,  uint8_t *pComp, uint3
 
 void _LLHW_isohf_copyMem2IORAM_local(HFCTRL isohf, uint8_t *pSource, uint8_t offset, uint32_t bytesLength);
 
+void _LLHW_isohf_copyIORAM2Mem_local(HFCTRL isohf, uint8_t *pDest, uint8_t offset, uint32_t bytesLength);
+
 void _LLHW_isohf_configIORAM4TypeALayer3_local(HFCTRL isohf, uint8_t *Layer3Source);
 
 void _isohf_configTypeALayer3BootAndWait_local(HFCTRL isohf, uint8_t *Layer3Source);
-
-uint8_t read_block(uint8_t *ptr_resp, uint8_t *ptr_data);
@@ -0,0 +1,157 @@
+/**
+ * @file nfc_engine.h
+ * @brief Interrupt driven NFC transaction engine header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef NFC_ENGINE_H_
+#define NFC_ENGINE_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "event_queue.h"
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Set this to 1 to serve NFC frames from the NFC interrupt, with the core
+ * sleeping between frames, instead of staying awake for APP_DELAY_S after an
+ * NFC field wakeup */
+#ifndef NFC_ENGINE_EN
+#define NFC_ENGINE_EN                   1
+#endif    /* ifndef NFC_ENGINE_EN */
+
+/* Largest frame received or sent, in bytes; the frames are exchanged at the
+ * start of the IO RAM and the responses are built there in place. Until the
+ * controller is switched to ISO/IEC 14443-4, frames are limited to
+ * NFC_ENGINE_L3_FRAME_MAX bytes, below the Layer 3 configuration */
+#define NFC_ENGINE_FRAME_MAX            256
+#define NFC_ENGINE_L3_FRAME_MAX         64
+
+/* Minimum frame delay, in slots, passed to _LLHW_isohf_getSilentTime() */
+#define NFC_ENGINE_MIN_SLOTS            9
+
+/* Time without any frame after which the field is considered gone, in case
+ * the RF OFF interrupt was missed */
+#define NFC_ENGINE_IDLE_TIMEOUT_MS      1000
+
+/* Events posted with EVENT_NFC (arg) */
+#define NFC_ENGINE_EVENT_FIELD_ON       1
+#define NFC_ENGINE_EVENT_FIELD_OFF      2
+#define NFC_ENGINE_EVENT_RX             3    /* data: frame size, value: HF_STATUS_ERR_RX bits */
+
+/* Engine states */
+#define NFC_ENGINE_STATE_OFF            0    /* no field */
+#define NFC_ENGINE_STATE_RX             1    /* waiting for a frame */
+#define NFC_ENGINE_STATE_EXEC           2    /* frame received, response being prepared */
+#define NFC_ENGINE_STATE_TX             3    /* response being sent */
+
+/**
+ * @brief          Prepare the response to a received frame
+ * @param [in,out] frame  Frame received, without CRC, in the IO RAM; the
+ *                        response, up to NFC_ENGINE_FRAME_MAX bytes, is
+ *                        written over it
+ * @param [in]     size   Frame size in bytes
+ * @return         Response size in bits (4 for an ACK or NAK), 0 to send no
+ *                 response
+ */
+typedef uint32_t (*nfc_engine_handler_t)(uint8_t *frame, uint32_t size);
+
+/**
+ * @brief Called from NFC_IRQHandler() once a response is sent, before the
+ *        controller waits for the next frame
+ */
+typedef void (*nfc_engine_sent_t)(void);
+
+#if NFC_ENGINE_EN
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Enable the end of communication, RF ON and RF OFF interrupts and
+ *        the NFC interrupt; call from NFC_Init() and after a wakeup through
+ *        reset
+ */
+void NFC_Engine_Init(void);
+
+/**
+ * @brief      Set the function that prepares the responses
+ * @param [in] handler  Frame handler; NULL restores the default handler,
+ *                      NFC_ISO4_Handler() or NFC_Type2_Handler()
+ */
+void NFC_Engine_Handler(nfc_engine_handler_t handler);
+
+/**
+ * @brief      Set how the response being prepared is sent; call from the
+ *             frame handler, the options only apply to that response
+ * @param [in] back_to_halt  HF_P_CTRL_BACK2HALT to go back to the HALT state
+ *                           once the response is sent, 0 otherwise
+ * @param [in] sent          Function called once the response is sent, e.g.
+ *                           to change the bit rate; NULL if not needed
+ */
+void NFC_Engine_Response_Options(uint32_t back_to_halt, nfc_engine_sent_t sent);
+
+/**
+ * @brief Note that a field is present, on an NFC field wakeup
+ */
+void NFC_Engine_FieldOn(void);
+
+/**
+ * @brief      Process an EVENT_NFC event: read the received frame, prepare
+ *             the response and send it, or wait for the next frame
+ * @param [in] event  Event posted by NFC_IRQHandler()
+ * @assumptions Called from the main loop
+ */
+void NFC_Engine_Process(const app_event_t *event);
+
+/**
+ * @brief  Check if a field is present; the core must then only be clock
+ *         gated between frames, so that the NFC interrupt can wake it up
+ * @return 1 if a field is present, 0 otherwise
+ */
+uint8_t NFC_Engine_Active(void);
+
+/**
+ * @brief NFC interrupt handler: acknowledge the interrupts and leave the
+ *        frame processing to the main loop
+ */
+void NFC_IRQHandler(void);
+
+#else    /* if NFC_ENGINE_EN */
+
+#define NFC_Engine_Init()
+#define NFC_Engine_Handler(handler)
+#define NFC_Engine_Response_Options(back_to_halt, sent)
+#define NFC_Engine_FieldOn()
+#define NFC_Engine_Process(event)
+#define NFC_Engine_Active()             0
+
+#endif    /* if NFC_ENGINE_EN */
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* NFC_ENGINE_H_ */
@@ -0,0 +1,172 @@
+/**
+ * @file nfc_iso4.h
+ * @brief ISO/IEC 14443-4 block transmission protocol header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef NFC_ISO4_H_
+#define NFC_ISO4_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "nfc_engine.h"
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Set this to 1 to advertise ISO/IEC 14443-4 compliance in the SAK and serve
+ * RATS, PPS and I-blocks; the Type 2 Tag commands are still served until a
+ * reader sends RATS.
+ * note: NFC Forum readers then look for a Type 4 Tag: the default APDU
+ *       handler presents the NDEF message of the Type 2 Tag memory as the
+ *       NDEF file of a Type 4 Tag; set this to 0 to present a Type 2 Tag
+ *       only */
+#ifndef NFC_ISO4_EN
+#define NFC_ISO4_EN                     NFC_ENGINE_EN
+#endif    /* ifndef NFC_ISO4_EN */
+
+/* Final SAK returned at the end of the anticollision */
+#if NFC_ISO4_EN
+#define NFC_ISO4_SAK                    0x20
+#else    /* if NFC_ISO4_EN */
+#define NFC_ISO4_SAK                    0x00
+#endif    /* if NFC_ISO4_EN */
+
+/* Highest bit rate accepted in PPS, in each direction: 0 = 106 kbit/s,
+ * 1 = 212 kbit/s, 2 = 424 kbit/s */
+#ifndef NFC_ISO4_BIT_RATE_MAX
+#define NFC_ISO4_BIT_RATE_MAX           2
+#endif    /* ifndef NFC_ISO4_BIT_RATE_MAX */
+
+/* ATS: maximum frame size accepted (FSCI 8 = NFC_ENGINE_FRAME_MAX bytes,
+ * CRC included), frame waiting time (FWI 7 = 38.7 ms), no start-up frame
+ * guard time, CID and NAD not supported */
+#define NFC_ISO4_FSCI                   8
+#define NFC_ISO4_FWI                    7
+#define NFC_ISO4_SFGI                   0
+#define NFC_ISO4_ATS_SIZE               5
+
+/* Largest command APDU reassembled from chained I-blocks (header, Lc, 255
+ * data bytes and Le) and largest response APDU (256 data bytes and the
+ * status word) */
+#define NFC_ISO4_COMMAND_MAX            261
+#define NFC_ISO4_RESPONSE_MAX           258
+
+/* Start bytes */
+#define NFC_ISO4_RATS                   0xE0
+#define NFC_ISO4_PPSS                   0xD0
+#define NFC_ISO4_PPSS_MASK              0xF0
+
+/* Block types: protocol control byte values and masks */
+#define NFC_ISO4_PCB_I_MASK             0xE2
+#define NFC_ISO4_PCB_I                  0x02
+#define NFC_ISO4_PCB_R_MASK             0xE6
+#define NFC_ISO4_PCB_R                  0xA2
+#define NFC_ISO4_PCB_S_MASK             0xF7
+#define NFC_ISO4_PCB_S_DESELECT         0xC2
+#define NFC_ISO4_PCB_BLOCK_NUM          0x01
+#define NFC_ISO4_PCB_NAD                0x04
+#define NFC_ISO4_PCB_CID                0x08
+#define NFC_ISO4_PCB_CHAINING           0x10    /* I-block */
+#define NFC_ISO4_PCB_NAK                0x10    /* R-block */
+
+/* Status words returned by the default APDU handler */
+#define NFC_ISO4_SW_OK                  0x9000
+#define NFC_ISO4_SW_END_OF_FILE         0x6282
+#define NFC_ISO4_SW_WRONG_LENGTH        0x6700
+#define NFC_ISO4_SW_NO_CURRENT_EF       0x6986
+#define NFC_ISO4_SW_FILE_NOT_FOUND      0x6A82
+#define NFC_ISO4_SW_WRONG_P1_P2         0x6A86
+#define NFC_ISO4_SW_WRONG_OFFSET        0x6B00
+#define NFC_ISO4_SW_INS_NOT_SUPPORTED   0x6D00
+#define NFC_ISO4_SW_CLA_NOT_SUPPORTED   0x6E00
+
+/* SELECT and READ BINARY instructions, served by the default APDU handler */
+#define NFC_ISO4_INS_SELECT             0xA4
+#define NFC_ISO4_INS_READ_BINARY        0xB0
+
+/* SELECT parameter P1: by file identifier, or by application name */
+#define NFC_ISO4_SELECT_BY_ID           0x00
+#define NFC_ISO4_SELECT_BY_NAME         0x04
+
+/* Files of the NFC Forum Type 4 Tag NDEF application served by the default
+ * APDU handler: capability container, NDEF file (the NDEF message of the
+ * Type 2 Tag memory) and a proprietary file holding the sample_log image */
+#define NFC_ISO4_FILE_NONE              0x0000
+#define NFC_ISO4_FILE_CC                0xE103
+#define NFC_ISO4_FILE_NDEF              0xE104
+#define NFC_ISO4_FILE_SAMPLE_LOG        0xE105
+
+/**
+ * @brief       Process a command APDU
+ * @param [in]  command   Command APDU, reassembled from chained I-blocks
+ * @param [in]  length    Command size in bytes
+ * @param [out] response  Response APDU, data then status word, up to
+ *                        NFC_ISO4_RESPONSE_MAX bytes
+ * @return      Response size in bytes
+ * @assumptions Called from the main loop
+ */
+typedef uint32_t (*nfc_iso4_apdu_handler_t)(const uint8_t *command, uint32_t length, uint8_t *response);
+
+#if NFC_ISO4_EN
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief      Set the function that processes the command APDUs
+ * @param [in] handler  APDU handler; NULL restores the default handler,
+ *                      which serves the NFC Forum Type 4 Tag NDEF
+ *                      application and the sample log image
+ */
+void NFC_ISO4_APDU_Handler(nfc_iso4_apdu_handler_t handler);
+
+/**
+ * @brief Leave ISO/IEC 14443-4 when the field is lost: go back to 106
+ *        kbit/s and restore the Layer 3 configuration of the IO RAM
+ */
+void NFC_ISO4_Reset(void);
+
+/**
+ * @brief          NFC engine frame handler: serve RATS, PPS, I-blocks,
+ *                 R-blocks and DESELECT once activated, and hand the
+ *                 other frames to NFC_Type2_Handler()
+ * @param [in,out] frame  Frame received, response written over it
+ * @param [in]     size   Frame size in bytes
+ * @return         Response size in bits, 0 to send no response
+ */
+uint32_t NFC_ISO4_Handler(uint8_t *frame, uint32_t size);
+
+#else    /* if NFC_ISO4_EN */
+
+#define NFC_ISO4_APDU_Handler(handler)
+#define NFC_ISO4_Reset()
+
+#endif    /* if NFC_ISO4_EN */
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* NFC_ISO4_H_ */
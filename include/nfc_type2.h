@@ -0,0 +1,180 @@
+/**
+ * @file nfc_type2.h
+ * @brief NFC Forum Type 2 Tag memory emulation header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef NFC_TYPE2_H_
+#define NFC_TYPE2_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "nfc_engine.h"
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Tag memory size in pages of 4 bytes (16 to 256): pages 0 to 2 hold the
+ * UID, internal and static lock bytes, page 3 the capability container and
+ * the following pages the data area */
+#ifndef NFC_TYPE2_PAGES
+#define NFC_TYPE2_PAGES                 128
+#endif    /* ifndef NFC_TYPE2_PAGES */
+
+#define NFC_TYPE2_PAGE_SIZE             4
+#define NFC_TYPE2_LOCK_PAGE             2
+#define NFC_TYPE2_CC_PAGE               3
+#define NFC_TYPE2_DATA_PAGE             4
+
+/* Byte offset and size of the data area */
+#define NFC_TYPE2_DATA_OFFSET           (NFC_TYPE2_DATA_PAGE * NFC_TYPE2_PAGE_SIZE)
+#define NFC_TYPE2_DATA_SIZE             ((NFC_TYPE2_PAGES - NFC_TYPE2_DATA_PAGE) * NFC_TYPE2_PAGE_SIZE)
+
+/* TLV blocks of the data area */
+#define NFC_TYPE2_TLV_NULL              0x00
+#define NFC_TYPE2_TLV_NDEF              0x03
+#define NFC_TYPE2_TLV_TERMINATOR        0xFE
+#define NFC_TYPE2_TLV_LENGTH_3_BYTES    0xFF
+
+/* Pages covered by the static lock bytes */
+#define NFC_TYPE2_STATIC_LOCK_PAGES     16
+
+/* Set this to 1 to export the sample log in the sectors following the tag
+ * memory: sector NFC_TYPE2_LOG_SECTOR onwards hold the sample_log_t image,
+ * header first, up to the last byte used */
+#ifndef NFC_TYPE2_LOG_EN
+#define NFC_TYPE2_LOG_EN                1
+#endif    /* ifndef NFC_TYPE2_LOG_EN */
+
+#define NFC_TYPE2_LOG_SECTOR            1
+
+/* Pages in a sector, selected with SECTOR_SELECT */
+#define NFC_TYPE2_SECTOR_PAGES          256
+
+/* Commands */
+#define NFC_TYPE2_CMD_READ              0x30
+#define NFC_TYPE2_CMD_FAST_READ         0x3A
+#define NFC_TYPE2_CMD_WRITE             0xA2
+#define NFC_TYPE2_CMD_COMP_WRITE        0xA0
+#define NFC_TYPE2_CMD_GET_VERSION       0x60
+#define NFC_TYPE2_CMD_SECTOR_SELECT     0xC2
+
+/* 4-bit acknowledge and negative acknowledge responses */
+#define NFC_TYPE2_ACK                   0xA
+#define NFC_TYPE2_NAK_ARGUMENT          0x0
+#define NFC_TYPE2_NAK_WRITE             0x5
+#define NFC_TYPE2_ACK_BITS              4
+
+/* READ returns 4 pages, wrapping around at the end of the memory */
+#define NFC_TYPE2_READ_PAGES            4
+
+/* Largest number of pages returned by FAST_READ, bounded by the Layer 3
+ * frame size */
+#define NFC_TYPE2_FAST_READ_PAGES       (NFC_ENGINE_L3_FRAME_MAX / NFC_TYPE2_PAGE_SIZE)
+
+/* GET_VERSION response: fixed header, vendor ID, product type and
+ * version; the storage size byte is computed from NFC_TYPE2_PAGES */
+#ifndef NFC_TYPE2_VENDOR_ID
+#define NFC_TYPE2_VENDOR_ID             0x00
+#endif    /* ifndef NFC_TYPE2_VENDOR_ID */
+#define NFC_TYPE2_PRODUCT_TYPE          0x04
+#define NFC_TYPE2_PRODUCT_SUBTYPE       0x02
+#define NFC_TYPE2_VERSION_MAJOR         0x01
+#define NFC_TYPE2_VERSION_MINOR         0x00
+#define NFC_TYPE2_PROTOCOL              0x03
+#define NFC_TYPE2_VERSION_SIZE          8
+
+/* Capability container: NDEF magic number, mapping version 1.0, data area
+ * size in units of 8 bytes, read and write access granted */
+#define NFC_TYPE2_CC_MAGIC              0xE1
+#define NFC_TYPE2_CC_VERSION            0x10
+#define NFC_TYPE2_CC_ACCESS             0x00
+
+/* Marker used to detect a valid tag memory after a reset */
+#define NFC_TYPE2_MAGIC                 (uint32_t)(0x54325447)
+
+/* NFC_Type2_Write() return values */
+#define NFC_TYPE2_NO_ERROR              (uint8_t)(0x00)
+#define NFC_TYPE2_INVALID               (uint8_t)(0x01)
+
+/* Tag memory */
+typedef struct
+{
+    uint32_t magic;
+    uint8_t data[NFC_TYPE2_PAGES * NFC_TYPE2_PAGE_SIZE];
+} nfc_type2_t;
+
+/* Tag memory, kept in the non-initialized section so that the data written
+ * by the application or by a reader survives the reset following a wakeup
+ * from sleep without retention */
+extern nfc_type2_t nfc_type2;
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Validate the tag memory; if it does not hold a tag, load pages 0 to
+ *        15 from RAW_ARRAY and format the data area with an empty NDEF
+ *        message if the capability container is blank
+ */
+void NFC_Type2_Init(void);
+
+/**
+ * @brief Select the tag memory sector and cancel any command in progress,
+ *        when a new field appears
+ */
+void NFC_Type2_Reset(void);
+
+/**
+ * @brief      Update the tag memory from the application
+ * @param [in] page    First page to write
+ * @param [in] data    Data to write
+ * @param [in] length  Number of bytes
+ * @return     NFC_TYPE2_NO_ERROR, or NFC_TYPE2_INVALID if the data does not
+ *             fit in the memory
+ */
+uint8_t NFC_Type2_Write(uint32_t page, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief       Find the NDEF message TLV in the data area
+ * @param [out] message  First byte of the NDEF message
+ * @return      NDEF message size in bytes, 0 if the data area holds no NDEF
+ *              message TLV
+ */
+uint32_t NFC_Type2_NDEF_Message(const uint8_t **message);
+
+/**
+ * @brief          Answer a Type 2 Tag command (nfc_engine_handler_t); the
+ *                 response is built over the command in the IO RAM
+ * @param [in,out] frame  Command received, then response
+ * @param [in]     size   Command size in bytes
+ * @return         Response size in bits, 0 to send no response
+ */
+uint32_t NFC_Type2_Handler(uint8_t *frame, uint32_t size);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* NFC_TYPE2_H_ */
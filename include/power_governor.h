@@ -0,0 +1,122 @@
+/**
+ * @file power_governor.h
+ * @brief Runtime power mode selection header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef POWER_GOVERNOR_H_
+#define POWER_GOVERNOR_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Power modes the governor can select, ordered from the cheapest to enter
+ * and exit to the lowest sleep current */
+typedef enum
+{
+    POWER_MODE_CORE_RETENTION = 0,
+    POWER_MODE_NO_RETENTION   = 1,
+    POWER_MODE_DEEP_SLEEP     = 2,
+    POWER_MODE_COUNT          = 3
+} power_mode_t;
+
+/* Returned by Power_Governor_NextDeadline() when no timed wakeup source is
+ * armed, so the next wakeup can only come from an external event */
+#define POWER_GOVERNOR_NO_DEADLINE      ((uint32_t)0xFFFFFFFF)
+
+/* Subsystems whose state is not retained through a wakeup with reset. While
+ * one of them holds the governor, it selects no deeper mode than
+ * POWER_MODE_CORE_RETENTION */
+#define POWER_GOVERNOR_HOLD_SENSOR_REPLAY   ((uint32_t)(1U << 0))
+#define POWER_GOVERNOR_HOLD_IMPEDANCE       ((uint32_t)(1U << 1))
+
+/* Break-even sleep durations in RTC clock cycles (32768 Hz). A mode is only
+ * selected if the time until the next known deadline is at least its
+ * break-even time, i.e. long enough for its lower sleep current to pay back
+ * its extra entry and exit cost. The default values are estimates from the
+ * datasheet sleep currents and the boot and re-initialization time; they
+ * have not been characterized yet and should be measured on the target
+ * board, then set at runtime with Power_Governor_SetBreakEven().
+ *   - Core retention: always worth it
+ *   - No retention: ~250 ms (boot ROM and re-initialization on wakeup)
+ *   - Deep sleep: only used when no timed wakeup source is armed */
+#define POWER_GOVERNOR_BREAK_EVEN_CORE_RETENTION    ((uint32_t)0)
+#define POWER_GOVERNOR_BREAK_EVEN_NO_RETENTION      ((uint32_t)8192)
+#define POWER_GOVERNOR_BREAK_EVEN_DEEP_SLEEP        POWER_GOVERNOR_NO_DEADLINE
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief  Compute the time until the next known wakeup deadline
+ * @return Number of RTC clock cycles until the earliest armed RTC alarm or
+ *         baseband timer event, 0 if an interrupt is already pending, or
+ *         POWER_GOVERNOR_NO_DEADLINE if no timed source is armed
+ */
+uint32_t Power_Governor_NextDeadline(void);
+
+/**
+ * @brief  Select the power mode to use for the upcoming sleep
+ * @return The deepest power mode whose break-even time fits before the next
+ *         deadline, bounded by the limit set with Power_Governor_Limit(),
+ *         and by POWER_MODE_CORE_RETENTION while a subsystem holds the
+ *         governor
+ */
+power_mode_t Power_Governor_Select(void);
+
+/**
+ * @brief      Update the break-even time of a power mode
+ * @param [in] mode   Power mode to update
+ * @param [in] ticks  Break-even time in RTC clock cycles
+ */
+void Power_Governor_SetBreakEven(power_mode_t mode, uint32_t ticks);
+
+/**
+ * @brief      Limit the deepest power mode the governor may select
+ * @param [in] deepest  Deepest power mode allowed (use POWER_MODE_DEEP_SLEEP
+ *                      to remove the limit)
+ */
+void Power_Governor_Limit(power_mode_t deepest);
+
+/**
+ * @brief      Keep the core retained while a subsystem with non-retained
+ *             state is active
+ * @param [in] holder  POWER_GOVERNOR_HOLD_* bit of the subsystem
+ */
+void Power_Governor_Hold(uint32_t holder);
+
+/**
+ * @brief      Allow a wakeup with reset again once a subsystem is idle
+ * @param [in] holder  POWER_GOVERNOR_HOLD_* bit of the subsystem
+ */
+void Power_Governor_Release(uint32_t holder);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* POWER_GOVERNOR_H_ */
@@ -0,0 +1,117 @@
+/**
+ * @file sample_buffer.h
+ * @brief Retained sensor sample buffer header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef SAMPLE_BUFFER_H_
+#define SAMPLE_BUFFER_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Number of samples the buffer can hold (power of 2) */
+#ifndef SAMPLE_BUFFER_LENGTH
+#define SAMPLE_BUFFER_LENGTH            128
+#endif    /* ifndef SAMPLE_BUFFER_LENGTH */
+
+/* Marker used to detect a valid buffer after a reset */
+#define SAMPLE_BUFFER_MAGIC             (uint32_t)(0x534D504C)
+
+/* One ADC sample and the time it was taken at, in timebase ticks */
+typedef struct
+{
+    uint32_t time;
+    uint32_t value;
+} sensor_sample_t;
+
+/* Sample ring buffer, filled by the FIFO wakeup handler and emptied by the
+ * main loop */
+typedef struct
+{
+    uint32_t magic;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+
+    /* Samples dropped because the buffer was full */
+    uint32_t dropped;
+
+    /* Time of the last drain and estimated sample period, in ticks */
+    uint32_t last_drain;
+    uint32_t period;
+
+    sensor_sample_t samples[SAMPLE_BUFFER_LENGTH];
+} sample_buffer_t;
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Validate the buffer, clearing it if it does not hold samples
+ */
+void Sample_Buffer_Init(void);
+
+/**
+ * @brief      Move all the samples of the sensor FIFO to the buffer and
+ *             reset the FIFO
+ * @param [in] level  Number of samples in the FIFO
+ * @return     Number of samples stored
+ * @assumptions Called from the FIFO wakeup handler
+ */
+uint32_t Sample_Buffer_Drain(uint32_t level);
+
+/**
+ * @brief       Take the oldest sample from the buffer
+ * @param [out] sample  Sample taken
+ * @return      1 if a sample was taken, 0 if the buffer is empty
+ * @assumptions Called from the main loop
+ */
+uint8_t Sample_Buffer_Get(sensor_sample_t *sample);
+
+/**
+ * @brief  Sample period measured between the last two drains
+ * @return Sample period in timebase ticks, 0 if not measured yet
+ */
+uint32_t Sample_Buffer_Period(void);
+
+/**
+ * @brief  Number of samples waiting in the buffer
+ * @return Number of samples
+ */
+uint32_t Sample_Buffer_Count(void);
+
+/**
+ * @brief  Number of samples dropped because the buffer was full
+ * @return Number of samples
+ */
+uint32_t Sample_Buffer_Dropped(void);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* SAMPLE_BUFFER_H_ */
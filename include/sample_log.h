@@ -0,0 +1,112 @@
+/**
+ * @file sample_log.h
+ * @brief Compressed sensor sample log header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef SAMPLE_LOG_H_
+#define SAMPLE_LOG_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "sample_buffer.h"
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Size of the log data in bytes */
+#ifndef SAMPLE_LOG_SIZE
+#define SAMPLE_LOG_SIZE                 2048
+#endif    /* ifndef SAMPLE_LOG_SIZE */
+
+/* Largest number of samples in one block */
+#define SAMPLE_LOG_BLOCK_SAMPLES        32
+
+/* Rice codes with a quotient of this value or more are escaped: the
+ * quotient is replaced by this number of ones and the value follows on
+ * 32 bits */
+#define SAMPLE_LOG_RICE_ESCAPE          24
+
+/* Size of a block header in bytes */
+#define SAMPLE_LOG_BLOCK_HEADER_SIZE    14
+
+/* Marker used to detect a valid log after a reset */
+#define SAMPLE_LOG_MAGIC                (uint32_t)(0x534C4F47)
+
+/* Log of sample blocks; the layout is decoded by tools/sample_log_decode.py.
+ * Each block is made of a header:
+ *   - count  (uint8):  number of samples in the block
+ *   - k      (uint8):  Rice parameter of the block
+ *   - time   (uint32): time of the first sample in timebase ticks
+ *   - period (uint32): sample period in timebase ticks
+ *   - first  (uint32): value of the first sample
+ * followed by the Rice codes of the zig-zag encoded differences between
+ * consecutive samples, most significant bit first, padded to a byte. */
+typedef struct
+{
+    uint32_t magic;
+
+    /* Number of bytes used in data */
+    uint32_t length;
+
+    /* Number of blocks in the log */
+    uint32_t blocks;
+
+    /* Samples dropped because the log was full */
+    uint32_t dropped;
+
+    uint8_t data[SAMPLE_LOG_SIZE];
+} sample_log_t;
+
+/* Sample log, kept in the non-initialized section; also exported over NFC
+ * by the Type 2 Tag emulation */
+extern sample_log_t sample_log;
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Validate the log, clearing it if it does not hold a log or if its
+ *        length or number of blocks is out of range
+ */
+void Sample_Log_Init(void);
+
+/**
+ * @brief      Compress a batch of samples and append it to the log
+ * @param [in] samples  Samples, oldest first
+ * @param [in] count    Number of samples
+ * @return     Number of samples logged; samples that do not fit are dropped
+ */
+uint32_t Sample_Log_Write(const sensor_sample_t *samples, uint32_t count);
+
+/**
+ * @brief Empty the log, e.g. after its contents have been uploaded
+ */
+void Sample_Log_Clear(void);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* SAMPLE_LOG_H_ */
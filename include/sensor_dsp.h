@@ -0,0 +1,158 @@
+/**
+ * @file sensor_dsp.h
+ * @brief Fixed-point sensor sample processing header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef SENSOR_DSP_H_
+#define SENSOR_DSP_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Set this to 1 to use the SIMD instructions of the DSP extension, or to 0 to
+ * use the scalar reference implementation, which gives the same results and
+ * also builds on a host */
+#ifndef SENSOR_DSP_SIMD
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define SENSOR_DSP_SIMD                 1
+#else    /* if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1) */
+#define SENSOR_DSP_SIMD                 0
+#endif    /* if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1) */
+#endif    /* ifndef SENSOR_DSP_SIMD */
+
+/* Largest number of samples processed in one call */
+#define SENSOR_DSP_BATCH_MAX            32
+
+/* Largest number of filter taps (even) */
+#define SENSOR_DSP_TAPS_MAX             8
+
+/* Largest decimation factor */
+#define SENSOR_DSP_DECIMATION_MAX       4
+
+/* Unity gain of a filter coefficient (Q15) */
+#define SENSOR_DSP_Q15_ONE              (int16_t)(0x7FFF)
+
+/* Sensor_DSP_Configure() return codes */
+#define SENSOR_DSP_NO_ERROR             (uint8_t)(0x00)
+#define SENSOR_DSP_INVALID              (uint8_t)(0x01)
+
+/* Marker used to detect a valid processing state after a reset */
+#define SENSOR_DSP_MAGIC                (uint32_t)(0x44535031)
+
+/* Detection events */
+#define SENSOR_DSP_EVENT_RISE           (uint8_t)(0x01)    /* peak reached the threshold */
+#define SENSOR_DSP_EVENT_FALL           (uint8_t)(0x02)    /* peak fell below threshold - hysteresis */
+
+/* Default configuration used by Sensor_DSP_Init():
+ *   - No decimation
+ *   - 4 tap moving average
+ *   - Baseline following the batch mean with a weight of 1/8
+ *   - Detection above 0x100 ADC LSBs over the baseline */
+#define SENSOR_DSP_DEFAULT_DECIMATION       1
+#define SENSOR_DSP_DEFAULT_TAPS             4
+#define SENSOR_DSP_DEFAULT_BASELINE_SHIFT   3
+#define SENSOR_DSP_DEFAULT_THRESHOLD        (int16_t)(0x100)
+#define SENSOR_DSP_DEFAULT_HYSTERESIS       (int16_t)(0x40)
+
+/* Processing configuration. Samples go through, in order:
+ *   - Decimation: mean of each group of decimation samples
+ *   - FIR filter: y[n] = sum(coeffs[i] * x[n - i]) in Q15, saturated
+ *   - Baseline subtraction: the baseline follows the mean of each batch
+ *     with a weight of 1 / (1 << baseline_shift); 0 disables the stage
+ *   - Detection: the batch peak is compared to the threshold */
+typedef struct
+{
+    /* Decimation factor: 1, 2 or 4 */
+    uint8_t decimation;
+
+    /* Number of filter taps, even, up to SENSOR_DSP_TAPS_MAX */
+    uint8_t taps;
+
+    uint8_t baseline_shift;
+
+    /* Filter coefficients in Q15 */
+    int16_t coeffs[SENSOR_DSP_TAPS_MAX];
+
+    int16_t threshold;
+    int16_t hysteresis;
+} sensor_dsp_config_t;
+
+/* Result of the processing of one batch */
+typedef struct
+{
+    /* Number of output samples */
+    uint32_t count;
+
+    /* Largest output sample */
+    int16_t peak;
+
+    /* SENSOR_DSP_EVENT_* */
+    uint8_t events;
+} sensor_dsp_result_t;
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Load the default configuration and clear the processing state;
+ *        call on a cold boot
+ */
+void Sensor_DSP_Init(void);
+
+/**
+ * @brief  Keep the configuration and processing state retained through a
+ *         wakeup through reset
+ * @return true if the retained state was valid, false if it was lost and
+ *         the processing started again with Sensor_DSP_Init()
+ */
+uint8_t Sensor_DSP_Restore(void);
+
+/**
+ * @brief      Change the processing configuration and clear the processing
+ *             state
+ * @param [in] config  New configuration
+ * @return     SENSOR_DSP_NO_ERROR, or SENSOR_DSP_INVALID if a parameter is
+ *             out of range
+ */
+uint8_t Sensor_DSP_Configure(const sensor_dsp_config_t *config);
+
+/**
+ * @brief      Process a batch of samples; the filter, baseline and detection
+ *             state carry over between batches
+ * @param [in,out] samples  Samples, oldest first, replaced by the output
+ *                          samples
+ * @param [in] count        Number of samples, up to SENSOR_DSP_BATCH_MAX
+ * @param [out] result      Number of output samples, peak and events
+ */
+void Sensor_DSP_Process(int16_t *samples, uint32_t count, sensor_dsp_result_t *result);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* SENSOR_DSP_H_ */
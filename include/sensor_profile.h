@@ -0,0 +1,127 @@
+/**
+ * @file sensor_profile.h
+ * @brief Sensor measurement profiles header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef SENSOR_PROFILE_H_
+#define SENSOR_PROFILE_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Measurement profiles */
+typedef enum
+{
+    SENSOR_PROFILE_NORMAL    = 0,    /* current measurement */
+    SENSOR_PROFILE_IMPEDANCE = 1,    /* impedance measurement with a WEDAC step */
+    SENSOR_PROFILE_COUNT     = 2
+} sensor_profile_id_t;
+
+/* Marker used to detect a valid profile record after a reset */
+#define SENSOR_PROFILE_MAGIC            (uint32_t)(0x53505247)
+
+/* Register image of a measurement profile */
+typedef struct
+{
+    /* Sensor interface configuration and WEDAC levels */
+    uint32_t if_cfg;
+    uint32_t wedac_high;
+    uint32_t wedac_low;
+
+    /* Sensor timer control and reference electrode connection */
+    uint32_t timer_ctl;
+    uint32_t re_cfg;
+
+    /* Length of the pre integration, delay and idle states */
+    uint32_t int_cfg;
+    uint32_t delay_l;
+    uint32_t idle;
+
+    /* Threshold and differential mode of the sample storage */
+    uint32_t threshold;
+    uint32_t diff_mode;
+} sensor_profile_t;
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief      Program the sensor with a measurement profile; the sensor timer
+ *             restarts and the samples in the FIFO are discarded, so switch
+ *             right after the FIFO has been drained
+ * @param [in] profile  Profile to apply
+ * @assumptions The sensor clock has been enabled by Sensor_Init()
+ */
+void Sensor_Profile_Apply(sensor_profile_id_t profile);
+
+/**
+ * @brief  Profile currently programmed
+ * @return Profile set by the last Sensor_Profile_Apply()
+ */
+sensor_profile_id_t Sensor_Profile_Current(void);
+
+/**
+ * @brief      Count a FIFO wakeup and choose the profile of the next one; the
+ *             count is kept in the retained profile record
+ * @param [in] period  Number of FIFO wakeups between impedance measurements
+ * @return     SENSOR_PROFILE_IMPEDANCE once every period calls,
+ *             SENSOR_PROFILE_DEFAULT otherwise
+ */
+sensor_profile_id_t Sensor_Profile_Next(uint32_t period);
+
+/**
+ * @brief  Check if a profile has been applied since the last cold boot
+ * @return 1 if the retained profile record is valid, 0 otherwise
+ */
+uint8_t Sensor_Profile_Valid(void);
+
+/**
+ * @brief Forget the applied profile, so that the sensor is configured from
+ *        scratch; call on a cold boot
+ */
+void Sensor_Profile_Invalidate(void);
+
+/**
+ * @brief  Check if the sensor still holds the current profile, by reading
+ *         back the sensor clock, pre integration and delay configuration
+ * @return 1 if the sensor is still configured, 0 otherwise
+ */
+uint8_t Sensor_Profile_Check(void);
+
+/**
+ * @brief      Register image of a profile
+ * @param [in] profile  Profile
+ * @return     Register image
+ */
+const sensor_profile_t *Sensor_Profile_Get(sensor_profile_id_t profile);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* SENSOR_PROFILE_H_ */
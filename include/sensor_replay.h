@@ -0,0 +1,134 @@
+/**
+ * @file sensor_replay.h
+ * @brief Replay of recorded sensor traces header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef SENSOR_REPLAY_H_
+#define SENSOR_REPLAY_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "sample_buffer.h"
+#include "async_read.h"
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Set this to 1 to replace the sensor with a recorded trace. The trace,
+ * sensor_replay_trace[], is generated with tools/replay_trace_gen.py and
+ * must be added to the build.
+ * note: The real sensor is left unconfigured and the RTC alarm is enabled to
+ *       time the samples */
+#ifndef SENSOR_REPLAY_EN
+#define SENSOR_REPLAY_EN                0
+#endif    /* ifndef SENSOR_REPLAY_EN */
+
+/* Replay the trace this many times faster than recorded; the sample times
+ * seen by the application are compressed by the same factor */
+#ifndef SENSOR_REPLAY_SPEEDUP
+#define SENSOR_REPLAY_SPEEDUP           1
+#endif    /* ifndef SENSOR_REPLAY_SPEEDUP */
+
+/* Outcome of a replay, from Sensor_Replay_Report() */
+typedef struct
+{
+    /* Samples replayed so far, and whether the whole trace was replayed */
+    uint32_t samples;
+    uint8_t done;
+
+    /* Samples that reached the sample buffer, and samples lost because the
+     * FIFO or the sample buffer was full */
+    uint32_t captured;
+    uint32_t dropped;
+
+    /* Wakeups raised by the replayed samples */
+    uint32_t fifo_wakeups;
+    uint32_t threshold_wakeups;
+
+    /* System clock cycles spent in run mode since the replay started */
+    uint64_t run_cycles;
+} sensor_replay_report_t;
+
+#if SENSOR_REPLAY_EN
+
+/* Read the sensor FIFO: the replayed FIFO */
+#define SENSOR_ADC_DATA(index)          Sensor_Replay_ADC_Data(index)
+#define SENSOR_FIFO_LEVEL(value)        Sensor_Replay_FIFO_Level(value)
+
+/* Trace to replay: sample times in timebase ticks, from any origin */
+extern const sensor_sample_t sensor_replay_trace[];
+extern const uint32_t sensor_replay_trace_length;
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief      Start replaying a trace: each sample is pushed into the
+ *             replayed FIFO at its recorded time, and raises the FIFO full or
+ *             ADC threshold wakeup when the sensor would have
+ * @param [in] trace   Samples, oldest first
+ * @param [in] length  Number of samples
+ * @assumptions Called after SW_Timer_Init(), FIFO_Controller_Init() and
+ *              Threshold_Manager_Init()
+ */
+void Sensor_Replay_Start(const sensor_sample_t *trace, uint32_t length);
+
+/**
+ * @brief      Read a sample of the replayed FIFO; like SENSOR->ADC_DATA,
+ *             reading index 0 resets the FIFO
+ * @param [in] index  Position in the FIFO
+ * @return     Sample value
+ */
+uint32_t Sensor_Replay_ADC_Data(uint32_t index);
+
+/**
+ * @brief       Read the number of samples in the replayed FIFO
+ * @param [out] value  FIFO level
+ * @return      ASYNC_READ_NO_ERROR
+ */
+uint8_t Sensor_Replay_FIFO_Level(uint32_t *value);
+
+/**
+ * @brief       Summarize the replay so far
+ * @param [out] report  Replay report
+ */
+void Sensor_Replay_Report(sensor_replay_report_t *report);
+
+#else    /* if SENSOR_REPLAY_EN */
+
+/* Read the sensor FIFO */
+#define SENSOR_ADC_DATA(index)          (SENSOR->ADC_DATA[(index)])
+#define SENSOR_FIFO_LEVEL(value)        Async_Read_FIFO_Level(value)
+
+#define Sensor_Replay_Start(trace, length)
+#define Sensor_Replay_Report(report)
+
+#endif    /* if SENSOR_REPLAY_EN */
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* SENSOR_REPLAY_H_ */
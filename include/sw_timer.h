@@ -0,0 +1,136 @@
+/**
+ * @file sw_timer.h
+ * @brief Software timers multiplexed on the RTC alarm header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef SW_TIMER_H_
+#define SW_TIMER_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Maximum number of running timers */
+#ifndef SW_TIMER_MAX
+#define SW_TIMER_MAX                    32
+#endif    /* ifndef SW_TIMER_MAX */
+
+/* Timer durations are in timebase ticks (1 / 32768 s, corrected for the
+ * RTC clock error, see timebase.h) */
+
+/* Timers expiring less than this number of ticks after the
+ * earliest one are run in the same wakeup (10 ms) */
+#ifndef SW_TIMER_SLACK_TICKS
+#define SW_TIMER_SLACK_TICKS            (uint32_t)(328)
+#endif    /* ifndef SW_TIMER_SLACK_TICKS */
+
+/* Longest timer duration or period in ticks (~9 hours); it is
+ * also the RTC alarm period used while no timer is running */
+#define SW_TIMER_MAX_TICKS              (uint32_t)(0x3FFFFFFF)
+
+/* Shortest delay the RTC alarm is programmed with, in ticks */
+#define SW_TIMER_MIN_TICKS              (uint32_t)(2)
+
+/* Marker used to detect a valid timer heap after a reset */
+#define SW_TIMER_MAGIC                  (uint32_t)(0x53575449)
+
+/* Heap index of a timer that is not running */
+#define SW_TIMER_STOPPED                (uint8_t)(0xFF)
+
+/* SW_Timer_Start() return values */
+#define SW_TIMER_NO_ERROR               (uint8_t)(0x0)
+#define SW_TIMER_FULL                   (uint8_t)(0x1)
+#define SW_TIMER_INVALID                (uint8_t)(0x2)
+
+/* Software timer; the structure is owned by the caller and must stay valid
+ * while the timer is running. The timer heap is retained through a wakeup
+ * from sleep without retention, so a timer that may be running at that
+ * point must be placed in the non-initialized section as well:
+ *     static sw_timer_t timer __attribute__ ((section(".noinit")));
+ * Its callback then runs after the wakeup as if the core had been kept */
+typedef struct
+{
+    uint32_t expiry;                    /* Expiry time in ticks */
+    uint32_t period;                    /* Reload period in ticks, 0 for a one-shot timer */
+    void (*callback)(void *arg);
+    void *arg;
+    uint8_t index;                      /* Position in the timer heap */
+} sw_timer_t;
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Stop all timers; call after RTC_ALARM_Init() on a cold boot
+ */
+void SW_Timer_Init(void);
+
+/**
+ * @brief  Keep the timers that were running before a wakeup through reset;
+ *         the RTC alarm programmed for the earliest one is still running
+ * @return true if the retained timer heap was valid, false if it was lost
+ *         and all timers have been stopped
+ */
+uint8_t SW_Timer_Restore(void);
+
+/**
+ * @brief  Current time
+ * @return Ticks since Timebase_Init(), wrapping at 32 bits
+ */
+uint32_t SW_Timer_Now(void);
+
+/**
+ * @brief      Start or restart a timer
+ * @param [in] timer     Timer to start
+ * @param [in] ticks     Time until the first expiry in ticks
+ * @param [in] period    Reload period in ticks, 0 for a one-shot timer
+ * @param [in] callback  Function called from SW_Timer_Process() on expiry
+ * @param [in] arg       Argument passed to callback
+ * @return     SW_TIMER_NO_ERROR, SW_TIMER_FULL or SW_TIMER_INVALID
+ */
+uint8_t SW_Timer_Start(sw_timer_t *timer, uint32_t ticks, uint32_t period,
+                       void (*callback)(void *arg), void *arg);
+
+/**
+ * @brief      Stop a timer; does nothing if the timer is not running
+ * @param [in] timer  Timer to stop
+ */
+void SW_Timer_Stop(sw_timer_t *timer);
+
+/**
+ * @brief Run the callbacks of all timers expired or expiring within
+ *        SW_TIMER_SLACK_TICKS, reload the periodic ones and program the RTC
+ *        alarm with the next expiry; call from the main loop after an RTC
+ *        alarm wakeup
+ */
+void SW_Timer_Process(void);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* SW_TIMER_H_ */
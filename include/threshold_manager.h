@@ -0,0 +1,116 @@
+/**
+ * @file threshold_manager.h
+ * @brief ADC threshold tracking header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef THRESHOLD_MANAGER_H_
+#define THRESHOLD_MANAGER_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Value marking the retained manager state as valid */
+#define THRESHOLD_MANAGER_MAGIC         0x54484D31
+
+/* Distance between the baseline and the wakeup threshold (ADC LSBs) */
+#define THRESHOLD_MANAGER_BAND          (uint32_t)(0x100)
+
+/* After a wakeup, the threshold is armed again once the signal is this far
+ * below it (ADC LSBs) */
+#define THRESHOLD_MANAGER_HYSTERESIS    (uint32_t)(0x40)
+
+/* Weight of each sample in the baseline: 1 / (1 << shift) */
+#define THRESHOLD_MANAGER_BASELINE_SHIFT    4
+
+/* Period of the baseline samples taken while the threshold is armed */
+#define THRESHOLD_MANAGER_PERIOD_MS     (uint32_t)(60000)
+
+/* Time the threshold stays disarmed after a wakeup; it doubles, up to the
+ * maximum, each time the threshold triggers again shortly after being
+ * armed, and goes back to the minimum after a quiet period */
+#define THRESHOLD_MANAGER_HOLDOFF_MIN_MS    (uint32_t)(1000)
+#define THRESHOLD_MANAGER_HOLDOFF_MAX_MS    (uint32_t)(64000)
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Arm the threshold of the current sensor profile and start the
+ *        baseline samples
+ * @assumptions Called after SW_Timer_Init(); baseline samples and re-arming
+ *              after a holdoff need the RTC alarm wakeup source
+ */
+void Threshold_Manager_Init(void);
+
+/**
+ * @brief  Keep the threshold state and holdoff retained through a wakeup
+ *         through reset, and program the threshold again
+ * @return true if the retained state was valid, false if it was lost and
+ *         Threshold_Manager_Init() has been called
+ * @assumptions Called after SW_Timer_Restore(); call
+ *              Threshold_Manager_Update() if the timers were lost
+ */
+uint8_t Threshold_Manager_Restore(void);
+
+/**
+ * @brief Disarm the threshold after it woke up the core, so that a signal
+ *        staying above it does not wake the core again immediately
+ * @assumptions Called from the ADC threshold wakeup handler
+ */
+void Threshold_Manager_Trigger(void);
+
+/**
+ * @brief      Account for a sample in the baseline
+ * @param [in] value  Sample value
+ */
+void Threshold_Manager_Sample(uint32_t value);
+
+/**
+ * @brief Move the threshold with the baseline, or arm it again once the
+ *        holdoff has expired and the signal is back below the release level;
+ *        call from the main loop after a threshold wakeup
+ */
+void Threshold_Manager_Update(void);
+
+/**
+ * @brief  Current threshold
+ * @return Threshold in ADC LSBs, or the largest threshold while disarmed
+ */
+uint32_t Threshold_Manager_Threshold(void);
+
+/**
+ * @brief  Number of threshold wakeups since Threshold_Manager_Init()
+ * @return Number of wakeups
+ */
+uint32_t Threshold_Manager_Triggers(void);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* THRESHOLD_MANAGER_H_ */
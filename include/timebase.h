@@ -0,0 +1,150 @@
+/**
+ * @file timebase.h
+ * @brief Monotonic timebase kept across power modes header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Timebase ticks per second: the nominal RTC clock frequency */
+#define TIMEBASE_TICKS_HZ               32768
+
+/* Integer conversions between time and timebase ticks, rounded to nearest
+ * (32768 / 1000 = 4096 / 125 and 32768 / 1000000 = 512 / 15625) */
+#define TIMEBASE_MS_TO_TICKS(ms)        (uint32_t)((((uint64_t)(ms) * 4096) + 62) / 125)
+#define TIMEBASE_US_TO_TICKS(us)        (uint32_t)((((uint64_t)(us) * 512) + 7812) / 15625)
+#define TIMEBASE_TICKS_TO_MS(ticks)     ((((uint64_t)(ticks) * 125) + 2048) >> 12)
+#define TIMEBASE_TICKS_TO_US(ticks)     ((((uint64_t)(ticks) * 15625) + 256) >> 9)
+
+/* Number of RTC clock cycles over which the RTC clock is measured against
+ * the system clock by Timebase_Calibrate() (7.8 ms; at 8 MHz the resolution
+ * is 16 ppm) */
+#define TIMEBASE_CALIBRATION_TICKS      256
+
+/* Longest interval, in system clock cycles, between two samples of the RTC
+ * count for an edge to be dated by Timebase_Calibrate(); an edge seen after a
+ * longer gap (an interrupt ran) is skipped */
+#define TIMEBASE_EDGE_POLL_CYCLES       64
+
+/* Number of RTC clock periods Timebase_Calibrate() waits for a usable edge
+ * before giving up, e.g. if the RTC is stopped */
+#define TIMEBASE_EDGE_TIMEOUT_PERIODS   16
+
+/* Timebase_Calibrate() return values */
+#define TIMEBASE_NO_ERROR               (uint8_t)(0x0)
+#define TIMEBASE_TIMEOUT                (uint8_t)(0x1)
+
+/* Period of the RTC clock calibration when RTC_CLK_SRC is RTC_CLK_SRC_RC_OSC */
+#define TIMEBASE_CALIBRATION_PERIOD_MS  60000
+
+/* Limit of the RTC clock error that can be corrected, in ppm */
+#define TIMEBASE_PPM_MAX                100000
+
+/* Marker used to detect a valid timebase after a reset */
+#define TIMEBASE_MAGIC                  (uint32_t)(0x54494D45)
+
+typedef struct
+{
+    uint32_t magic;
+
+    /* RTC clock error in ppm (positive when the RTC clock runs fast) */
+    int32_t ppm;
+
+    /* Corrected time in ticks, and RTC_ALARM_Time() it was last updated at */
+    uint64_t ticks;
+    uint32_t rtc_time;
+
+    /* Remainder of the last error correction */
+    uint32_t remainder;
+} timebase_t;
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Start the timebase from zero, keeping a previously learned RTC
+ *        clock error; call after Wakeup_Source_Config() on a cold boot
+ */
+void Timebase_Init(void);
+
+/**
+ * @brief Account for the RTC clock cycles elapsed since the last update;
+ *        must be called at least once every 2^32 RTC clock cycles (36 hours)
+ */
+void Timebase_Update(void);
+
+/**
+ * @brief  Monotonic time, corrected for the RTC clock error
+ * @return Ticks (1 / TIMEBASE_TICKS_HZ s) since Timebase_Init()
+ */
+uint64_t Timebase_Ticks(void);
+
+/**
+ * @brief  Monotonic time in microseconds
+ * @return Microseconds since Timebase_Init()
+ */
+uint64_t Timebase_Now_us(void);
+
+/**
+ * @brief      Convert a duration in timebase ticks into RTC clock cycles
+ * @param [in] ticks  Duration in timebase ticks
+ * @return     Number of RTC clock cycles lasting the same time
+ */
+uint32_t Timebase_ToRTC(uint32_t ticks);
+
+/**
+ * @brief  Measure the RTC clock against the system clock (derived from the
+ *         48 MHz XTAL) and update the RTC clock error; does nothing unless
+ *         RTC_CLK_SRC is RTC_CLK_SRC_RC_OSC
+ * @return TIMEBASE_NO_ERROR, or TIMEBASE_TIMEOUT if the RTC did not count
+ *         as expected, in which case the RTC clock error is left unchanged
+ * @note   Busy waits for TIMEBASE_CALIBRATION_TICKS RTC clock cycles: call
+ *         on a cold boot and from the periodic calibration timer only
+ */
+uint8_t Timebase_Calibrate(void);
+
+/**
+ * @brief      Set the RTC clock error, e.g. from a production measurement
+ * @param [in] ppm  RTC clock error in ppm (positive when the RTC runs fast)
+ */
+void Timebase_SetPPM(int32_t ppm);
+
+/**
+ * @brief  Current RTC clock error
+ * @return RTC clock error in ppm
+ */
+int32_t Timebase_PPM(void);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* TIMEBASE_H_ */
@@ -91,6 +91,20 @@
  */
 #define RTC_SLEEP_TIME_MS				(uint32_t)(10000)
 
+/* Value preloaded in ACS_RTC_CFG once the RTC alarm is armed: after the alarm
+ * the RTC reloads it and keeps counting down, so that the time elapsed since
+ * the alarm can be read back from ACS_RTC_COUNT */
+#define RTC_CFG_RELOAD_VALUE            (uint32_t)(0xDEADBEEF)
+
+/* Interrupt priorities (a lower value is a higher priority):
+ *   - GPIO3_IRQn writes the RTC preload value within half an RTC clock cycle
+ *     of an edge, so it preempts all other application interrupts; sections
+ *     with interrupts masked must stay shorter than that
+ *   - WAKEUP_IRQn and NFC_IRQn share one priority, since both post to the
+ *     event queue */
+#define APP_IRQ_PRIORITY_RTC_EDGE       0
+#define APP_IRQ_PRIORITY_EVENT          1
+
 /* Define the time in low power baseband clock cycles to spend in deep sleep mode
  * before waking-up the device using baseband timer
  * Possible options:
@@ -219,14 +233,70 @@ void RTC_ALARM_Init(void);
 
 void RTC_ClockSource_Init(void);
 
+/**
+ * @brief Start the RTC with RTC_CLK_SRC and no alarm, unless
+ *        RTC_ALARM_Init() owns it; a running RTC is never reset, so that
+ *        RTC_ALARM_Time() and the timebase keep counting
+ */
+void RTC_Timebase_Start(void);
+
 void RTC_ALARM_Reconfig(uint32_t timer_counter);
 
+/**
+ * @brief  Check if a value passed to RTC_ALARM_Reconfig() is still being loaded
+ * @return 1 while the RTC timer counter has not been loaded yet, 0 otherwise
+ */
+uint8_t RTC_ALARM_Reconfig_Busy(void);
+
+/**
+ * @brief Wait, with the core clock gated, until the value passed to
+ *        RTC_ALARM_Reconfig() has been loaded; call before entering a power
+ *        mode, in which the standby clock is not routed to GPIO8
+ * @note  Interrupts are unmasked while waiting, so that GPIO3_IRQHandler can
+ *        run; the interrupt mask of the caller is restored on return
+ */
+void RTC_ALARM_Reconfig_Wait(void);
+
+/**
+ * @brief  Time kept by the RTC across the loads of RTC_ALARM_Reconfig()
+ * @return Number of RTC clock cycles since RTC_ALARM_Init(), wrapping at 32 bits
+ */
+uint32_t RTC_ALARM_Time(void);
+
+/**
+ * @brief  RTC_ALARM_Time() from a single read of the RTC count, for time
+ *         stamps taken on the wakeup path
+ * @return Number of RTC clock cycles since RTC_ALARM_Init(), wrapping at 32
+ *         bits
+ * @note   The RTC count is updated in the RTC clock domain: a read that
+ *         coincides with an RTC clock edge can return a wrong count. Use
+ *         RTC_ALARM_Time() where the time must be exact
+ */
+uint32_t RTC_ALARM_Time_Once(void);
+
+void GPIO3_IRQHandler(void);
+
 void GPIO_Interrupt_Init(void);
 
 void BB_Timer_Init(void);
 
 void Sensor_Init(void);
 
+/* Sensor_Restore() return codes, ordered from the slowest path */
+#define SENSOR_RESTORE_COLD             (uint8_t)(0x00)    /* full Sensor_Init() */
+#define SENSOR_RESTORE_REAPPLIED        (uint8_t)(0x01)    /* profile applied again */
+#define SENSOR_RESTORE_RETAINED         (uint8_t)(0x02)    /* configuration kept */
+
+/**
+ * @brief  Make sure the sensor is configured, doing as little as possible:
+ *         nothing if it still holds the profile applied last, only the
+ *         profile if it lost it, and the full Sensor_Init() if no profile
+ *         has been applied since the last cold boot
+ * @return SENSOR_RESTORE_COLD, SENSOR_RESTORE_REAPPLIED or
+ *         SENSOR_RESTORE_RETAINED
+ */
+uint8_t Sensor_Restore(void);
+
 void ADC_Threshold_Init(void);
 
 void ADC_FIFO_Init(void);
@@ -237,10 +307,30 @@ void SENSOR_DET_Init(void);
 
 void SensorFIFO_Reset(void);
 
+/**
+ * @brief      Change the number of ADC samples stored before waking up the core
+ * @param [in] size  FIFO size (SENSOR_FIFO_SIZE*)
+ */
+void Sensor_FIFO_Resize(uint32_t size);
+
+/**
+ * @brief  Number of ADC samples stored before waking up the core
+ * @return FIFO size (SENSOR_FIFO_SIZE*)
+ */
+uint32_t Sensor_FIFO_Size(void);
+
 void GPIO_Wakeup_Init(void);
 
 void Wakeup_Source_Config(void);
 
+/**
+ * @brief Set up the pads and interrupts of the wakeup sources again after a
+ *        wakeup through reset, without resetting the always-on RTC, BB
+ *        timer and sensor, or clearing the wakeup flags; call after
+ *        Sys_PowerModes_Wakeup_WithReset()
+ */
+void Wakeup_Source_Restore(void);
+
 void _isohf_configTypeALayer3BootAndWait_local(HFCTRL isohf, uint8_t *Layer3Source);
 
 #endif    /* WAKEUP_SOURCE_CONFIG_H_ */
@@ -0,0 +1,146 @@
+/**
+ * @file wakeup_trace.h
+ * @brief Retained wakeup trace header file
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+#ifndef WAKEUP_TRACE_H_
+#define WAKEUP_TRACE_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "montana.h"
+#include "app_metrics.h"
+#include "wakeup_source_config.h"
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Set this to 1 to record sleep and wakeup events in the retained trace.
+ * note: Durations come from the DWT cycle counter enabled with APP_METRICS_EN */
+#ifndef WAKEUP_TRACE_EN
+#define WAKEUP_TRACE_EN                 1
+#endif    /* ifndef WAKEUP_TRACE_EN */
+
+/* Number of records in the trace (power of 2) */
+#define WAKEUP_TRACE_LENGTH             64
+
+/* Durations are stored in units of (1 << WAKEUP_TRACE_CYCLE_SHIFT) system
+ * clock cycles, saturated to 16 bits (2 us and 131 ms at 8 MHz) */
+#define WAKEUP_TRACE_CYCLE_SHIFT        4
+
+/* Marker used to detect a valid trace after a reset; changed with the
+ * layout of wakeup_trace_t */
+#define WAKEUP_TRACE_MAGIC              (uint32_t)(0x54524333)
+
+/* Record types */
+#define WAKEUP_TRACE_SLEEP_ENTRY        1    /* arg: power mode */
+#define WAKEUP_TRACE_RESUME_RETENTION   2    /* execution resumed after SoC_Sleep() */
+#define WAKEUP_TRACE_RESUME_RESET       3    /* execution resumed through main() */
+#define WAKEUP_TRACE_WAKEUP_IRQ         4    /* arg: WAKEUP_SRC_* bits, data: duration */
+#define WAKEUP_TRACE_HANDLER            5    /* arg: WAKEUP_SRC_*, data: duration */
+
+/* One 8 byte trace record, time-stamped with RTC_ALARM_Time_Once(), which
+ * keeps counting up across the reloads of the RTC */
+typedef struct
+{
+    uint32_t rtc_time;
+    uint8_t type;
+    uint8_t arg;
+    uint16_t data;
+} wakeup_trace_record_t;
+
+/* Trace ring buffer; the layout is decoded by tools/wakeup_trace_decode.py.
+ * head counts every record added since the trace was cleared, so that the
+ * decoder can tell a full ring from a partly written one */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t head;
+    uint32_t core_clock;
+    uint8_t cycle_shift;
+    uint8_t length_log2;
+    uint16_t reserved;
+    wakeup_trace_record_t records[WAKEUP_TRACE_LENGTH];
+} wakeup_trace_t;
+
+#if WAKEUP_TRACE_EN
+
+/* Trace buffer, kept in the non-initialized section so that it survives
+ * sleep with core retention and wakeups through reset */
+extern wakeup_trace_t wakeup_trace;
+
+/**
+ * @brief      Append a record to the trace
+ * @param [in] type  Record type (WAKEUP_TRACE_*)
+ * @param [in] arg   Record argument
+ * @param [in] data  Record data
+ * @assumptions Called from WAKEUP_IRQHandler or with interrupts disabled
+ */
+static inline void Wakeup_Trace_Add(uint32_t type, uint32_t arg, uint32_t data)
+{
+    wakeup_trace_record_t *record = &wakeup_trace.records[wakeup_trace.head & (WAKEUP_TRACE_LENGTH - 1)];
+
+    /* A single read of the RTC count keeps the record cheap in the wakeup
+     * interrupt */
+    record->rtc_time = RTC_ALARM_Time_Once();
+    record->type = (uint8_t)type;
+    record->arg = (uint8_t)arg;
+    record->data = (uint16_t)data;
+    wakeup_trace.head++;
+}
+
+/**
+ * @brief      Convert a cycle count into a saturated trace duration
+ * @param [in] start  Value of METRICS_CYCLES() at the start of the interval
+ * @return     Duration in trace units
+ */
+static inline uint32_t Wakeup_Trace_Duration(uint32_t start)
+{
+    uint32_t duration = (METRICS_CYCLES() - start) >> WAKEUP_TRACE_CYCLE_SHIFT;
+
+    return (duration > 0xFFFF) ? 0xFFFF : duration;
+}
+
+/* ---------------------------------------------------------------------------
+* Function prototype definitions
+* --------------------------------------------------------------------------*/
+/**
+ * @brief Validate the trace buffer, clearing it if it does not hold a trace
+ */
+void Wakeup_Trace_Init(void);
+
+#else    /* if WAKEUP_TRACE_EN */
+
+#define Wakeup_Trace_Add(type, arg, data)
+#define Wakeup_Trace_Duration(start)    0
+#define Wakeup_Trace_Init()
+
+#endif    /* if WAKEUP_TRACE_EN */
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* WAKEUP_TRACE_H_ */
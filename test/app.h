@@ -0,0 +1,85 @@
+/**
+ * @file app.h
+ * @brief Host test replacement for the application header: declares only
+ *        what the modules under test use, without the device headers
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#ifndef APP_H_
+#define APP_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* Metrics: not collected on the host */
+#define METRICS_CYCLES()                    0
+#define Metrics_SampleLog(start, samples)   ((void)(start), (void)(samples))
+
+/* Count leading zeros, as the CLZ instruction */
+#define __CLZ(x)                            (((x) == 0) ? 32U : (uint32_t)__builtin_clz(x))
+
+/* Models of the DSP extension intrinsics, following the Armv8-M
+ * Architecture Reference Manual, so that the SIMD code paths can be
+ * compared with the scalar ones on the host */
+static inline int16_t Test_Lo(uint32_t x)
+{
+    return (int16_t)(x & 0xFFFF);
+}
+
+static inline int16_t Test_Hi(uint32_t x)
+{
+    return (int16_t)(x >> 16);
+}
+
+static inline uint16_t Test_Sat16(int32_t x)
+{
+    return (uint16_t)((x > INT16_MAX) ? INT16_MAX : ((x < INT16_MIN) ? INT16_MIN : x));
+}
+
+static inline uint32_t __SMUAD(uint32_t x, uint32_t y)
+{
+    return (uint32_t)((int32_t)Test_Lo(x) * Test_Lo(y) + (int32_t)Test_Hi(x) * Test_Hi(y));
+}
+
+static inline uint32_t __SMLAD(uint32_t x, uint32_t y, uint32_t acc)
+{
+    return acc + (uint32_t)((int32_t)Test_Lo(x) * Test_Lo(y)) + (uint32_t)((int32_t)Test_Hi(x) * Test_Hi(y));
+}
+
+static inline uint32_t __QSUB16(uint32_t x, uint32_t y)
+{
+    return ((uint32_t)Test_Sat16((int32_t)Test_Hi(x) - Test_Hi(y)) << 16) |
+           Test_Sat16((int32_t)Test_Lo(x) - Test_Lo(y));
+}
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_H_ */
@@ -0,0 +1,176 @@
+/**
+ * @file app.h
+ * @brief Host model replacement for the application header: the application
+ *        configuration used by lowpwr_manager.c and wakeup_source_config.c,
+ *        built against the device model in this directory
+ *
+ * All wakeup sources are enabled so that every configuration path runs, and
+ * the power governor picks the power mode so that the test can enter each of
+ * them. Metrics and wakeup trace are left out; the model counts
+ * register accesses and RTC cycles instead (model_stats).
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#ifndef APP_H_
+#define APP_H_
+
+/* Modules left out of the model build */
+#define APP_METRICS_EN                  0
+#define WAKEUP_TRACE_EN                 0
+#define APP_BENCHMARK_EN                0
+#define SENSOR_REPLAY_EN                0
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include "montana.h"
+#include "wakeup_source_config.h"
+#include "power_governor.h"
+#include "app_metrics.h"
+#include "app_benchmark.h"
+#include "async_read.h"
+#include "wakeup_trace.h"
+#include "timebase.h"
+#include "event_queue.h"
+#include "sample_buffer.h"
+#include "sensor_profile.h"
+#include "threshold_manager.h"
+#include "sensor_replay.h"
+#include "fifo_controller.h"
+#include "nfc_engine.h"
+#include "nfc_iso4.h"
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+extern sleep_mode_cfg app_sleep_mode_cfg;
+
+/* Options for wakeup restart address */
+#define SLEEP_MODE_TEST_NO_RETENTION               0
+#define SLEEP_MODE_TEST_MEMORY_RETENTION           1
+#define SLEEP_MODE_TEST_CORE_RETENTION             2
+#define DEEP_SLEEP_TEST                            3
+#define SLEEP_MODE_TEST_GOVERNOR                   4
+
+/* Interrupt mask of the model core: restoring it runs the interrupts that
+ * became pending while masked */
+#define GLOBAL_INT_DISABLE() ;                                               \
+    do {                                                                        \
+        uint32_t __primask_status = __get_PRIMASK();                            \
+        __disable_irq();
+
+#define GLOBAL_INT_RESTORE() ;                                               \
+    __set_PRIMASK(__primask_status);                                        \
+    } while (0)
+
+#define SLEEP_MODE_TEST                 SLEEP_MODE_TEST_GOVERNOR
+
+#define SENSOR_PROFILE_DEFAULT          SENSOR_PROFILE_NORMAL
+
+/* Enable Wakeup Sources for the application */
+#define WAKEUP_SRC_RTC_ALARM_EN            1
+#define WAKEUP_SRC_BB_EN                   1
+#define WAKEUP_SRC_GPIO_EN                 1
+#define WAKEUP_SRC_FIFO_EN                 1
+#define WAKEUP_SRC_NFC_EN                  1
+#define WAKEUP_SRC_ADC_THRESHOLD_EN        1
+#define WAKEUP_SRC_SENSOR_DETECTION_EN     1
+
+/* Wakeup source enabled mask */
+#define WAKEUP_SRC_EN_MSK     ((WAKEUP_SRC_RTC_ALARM_EN         << WAKEUP_SRC_RTC_ALARM)           | \
+                               (WAKEUP_SRC_BB_EN                << WAKEUP_SRC_BB)                  | \
+                               (WAKEUP_SRC_GPIO_EN              << WAKEUP_SRC_GPIO)                | \
+                               (WAKEUP_SRC_FIFO_EN              << WAKEUP_SRC_FIFO)                | \
+                               (WAKEUP_SRC_ADC_THRESHOLD_EN     << WAKEUP_SRC_ADC)                 | \
+                               (WAKEUP_SRC_NFC_EN               << WAKEUP_SRC_NFC)                 | \
+                               (WAKEUP_SRC_SENSOR_DETECTION_EN  << WAKEUP_SRC_SENSOR_DET))
+
+#define SYSTEM_CLK                      8000000
+
+/* Set this to 1 if you want to have debug GPIO capability for sleep mode or run mode */
+#define DEBUG_SLEEP_GPIO                1
+
+/* GPIOs monitoring the wakeup activity and the power mode */
+#define WAKEUP_ACTIVITY_FIFO_FULL       5
+#define WAKEUP_ACTIVITY_GPIO            4
+#define WAKEUP_ACTIVITY_RTC             6
+#define WAKEUP_ACTIVITY_BBTIMER         4
+#define WAKEUP_ACTIVITY_THRESHOLD       5
+#define WAKEUP_ACTIVITY_NFC             4
+#define WAKEUP_ACTIVITY_SENSOR_DET      4
+#define GPIO_WAKEUP_PIN                 1
+#define POWER_MODE_GPIO                 0
+
+/* Maximum number of wakeup event handlers */
+#define WAKEUP_HANDLER_MAX              12
+
+/* Number of wakeup event handlers registered by default */
+#define WAKEUP_HANDLER_DEFAULT_COUNT    7
+
+/* Maximum number of times WAKEUP_IRQHandler re-latches the wakeup flags
+ * before leaving the remaining events to the next interrupt */
+#define WAKEUP_DISPATCH_MAX_PASS        4
+
+/* Wakeup_Handler_Register() return values */
+#define WAKEUP_HANDLER_NO_ERROR         (uint8_t)(0x0)
+#define WAKEUP_HANDLER_TABLE_FULL       (uint8_t)(0x1)
+
+/* Wakeup event handler registration */
+typedef struct
+{
+    uint32_t event;             /* Event flag in ACS->WAKEUP_CTRL (one bit) */
+    uint32_t clear;             /* Bits written to ACS->WAKEUP_CTRL to clear the
+                                 * flag, 0 if the handler clears it itself */
+    uint32_t src;               /* Wakeup source (WAKEUP_SRC_*) for metrics and trace */
+    void (*handler)(void);
+} wakeup_handler_t;
+
+/* ---------------------------------------------------------------------------
+* Function prototypes
+* --------------------------------------------------------------------------*/
+void SoC_Sleep(void);
+
+void WAKEUP_IRQHandler(void);
+
+void FIFO_Wakeup_Process_Handler(void);
+
+void GPIO1_Wakeup_Process_Handler(void);
+
+void RTC_Alarm_Wakeup_Process_Handler(void);
+
+void NFC_Wakeup_Process_Handler(void);
+
+void Threshold_Wakeup_Process_Handler(void);
+
+void Sensor_Detection_Wakeup_Process_Handler(void);
+
+void BB_Timer_Wakeup_Process_Handler(void);
+
+uint8_t Wakeup_Handler_Register(uint32_t event, uint32_t clear, uint32_t src,
+                                void (*handler)(void));
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_H_ */
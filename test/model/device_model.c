@@ -0,0 +1,642 @@
+/**
+ * @file device_model.c
+ * @brief Host model of the device blocks declared in montana.h and of the
+ *        system library functions the firmware calls
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "app.h"
+#include "sensor.h"
+#include "iso14443.h"
+
+/* Size of the host memory mapped for the HF controller registers and the HF
+ * IO RAM */
+#define MODEL_HF_BANK_SIZE              0x1000
+#define MODEL_HF_BUFFER_SIZE            0x4000
+
+/* Longest wait for a wakeup in __WFI() or in a power mode, in half RTC clock
+ * cycles: a sleep without any wakeup source stops the test */
+#define MODEL_WAIT_MAX                  ((uint64_t)1 << 32)
+
+/* Low power clock of the RTC and the baseband timer */
+#define MODEL_RTC_HZ                    32768
+
+/* Running priority of thread mode */
+#define MODEL_THREAD_PRIORITY           0x100
+
+uint32_t SystemCoreClock = SYSTEM_CLK;
+
+model_stats_t model_stats;
+void (*model_reset_hook)(void);
+
+RESET_Type model_reset;
+CLK_Type model_clk;
+SYSCTRL_Type model_sysctrl;
+NFC_Type model_nfc;
+
+static ACS_Type model_acs;
+static SENSOR_Type model_sensor;
+static BBIF_Type model_bbif;
+static BB_Type model_bb;
+
+/* Sticky wakeup flags, bit n for MODEL_WAKEUP_n */
+static uint32_t model_flags;
+
+/* RTC reset waiting for an edge of the RTC clock */
+static uint8_t model_rtc_reset;
+
+/* Wakeup raised by Model_Wakeup_At(), in half RTC clock cycles */
+static uint32_t model_scheduled_flag;
+static uint64_t model_scheduled_time;
+static uint8_t model_scheduled;
+
+/* Half RTC clock cycles elapsed, odd while the RTC clock is high */
+static uint64_t model_time;
+
+/* Baseband deep sleep, and low power clock cycles left to the BB timer
+ * wakeup */
+static uint8_t model_bb_sleeping;
+static uint32_t model_bb_remaining;
+
+/* GPIO pad and interrupt line configurations */
+static uint32_t model_gpio_cfg[MODEL_GPIO_COUNT];
+static uint32_t model_gpio_int_cfg[4];
+static uint32_t model_gpio_out;
+
+/* NVIC and core */
+static uint8_t model_irq_enabled[MODEL_IRQ_COUNT];
+static uint8_t model_irq_pending[MODEL_IRQ_COUNT];
+static uint32_t model_irq_priority[MODEL_IRQ_COUNT];
+static uint32_t model_running_priority = MODEL_THREAD_PRIORITY;
+static uint32_t model_primask;
+static uint8_t model_asleep;
+
+/* System clock cycles not yet turned into RTC clock cycles by Sys_Delay() */
+static uint32_t model_delay_remainder;
+
+/* Handlers of the interrupts, NULL for those the firmware under test does
+ * not serve */
+static void (*const model_irq_handlers[MODEL_IRQ_COUNT])(void) =
+{
+    [WAKEUP_IRQn] = WAKEUP_IRQHandler,
+    [GPIO3_IRQn] = GPIO3_IRQHandler
+};
+
+/**
+ * @brief      Set a sticky wakeup flag; a flag going high makes the wakeup
+ *             interrupt pending
+ * @param [in] n  MODEL_WAKEUP_*
+ */
+static void Model_Raise(uint32_t n)
+{
+    if (!(model_flags & (1U << n)))
+    {
+        model_flags |= (1U << n);
+        model_irq_pending[WAKEUP_IRQn] = 1;
+    }
+    model_acs.WAKEUP_CTRL = model_flags << MODEL_WAKEUP_EVENT_Pos;
+}
+
+/**
+ * @brief Apply the effects of the register writes since the last access:
+ *        write-1-to-clear flags, RTC reset, baseband deep sleep entry and
+ *        wakeup, sensor FIFO size
+ */
+static void Model_Sync(void)
+{
+    /* Only the clear bits of WAKEUP_CTRL are writable */
+    model_flags &= ~(model_acs.WAKEUP_CTRL & MODEL_WAKEUP_CLEAR_Mask);
+    model_acs.WAKEUP_CTRL = model_flags << MODEL_WAKEUP_EVENT_Pos;
+
+    /* The RTC reset loads the preload value on the next edge of the RTC
+     * clock, or at once when the clock is forced */
+    if (model_acs.RTC_CTRL & RTC_RESET)
+    {
+        model_rtc_reset = 1;
+        model_acs.RTC_CTRL &= ~RTC_RESET;
+    }
+    if (model_acs.RTC_CTRL & RTC_FORCE_CLOCK)
+    {
+        model_acs.RTC_CTRL &= ~RTC_FORCE_CLOCK;
+        if (model_rtc_reset)
+        {
+            model_rtc_reset = 0;
+            model_acs.RTC_COUNT = model_acs.RTC_CFG;
+        }
+    }
+
+    if (model_bb_sleeping && (model_bbif.CTRL & BB_WAKEUP))
+    {
+        model_bb_sleeping = 0;
+        model_bb.DEEPSLCNTL &= ~DEEP_SLEEP_ON_1;
+    }
+    else if (!model_bb_sleeping && (model_bb.DEEPSLCNTL & DEEP_SLEEP_ON_1) &&
+             (model_acs.BB_TIMER_CTRL & BB_TIMER_NRESET))
+    {
+        model_bb_sleeping = 1;
+        model_bb_remaining = model_bb.DEEPSLWKUP >> BB_DEEPSLWKUP_DEEPSLTIME_Pos;
+    }
+    model_bbif.STATUS = model_bb_sleeping ? (OSC_DISABLED | RF_DISABLED | LOW_POWER_CLK) :
+                        (OSC_ENABLED | RF_ENABLED | MASTER_CLK);
+}
+
+ACS_Type *Model_ACS(void)
+{
+    Model_Sync();
+    model_stats.reg_accesses++;
+    return &model_acs;
+}
+
+SENSOR_Type *Model_SENSOR(void)
+{
+    Model_Sync();
+    model_stats.reg_accesses++;
+    return &model_sensor;
+}
+
+BBIF_Type *Model_BBIF(void)
+{
+    Model_Sync();
+    model_stats.reg_accesses++;
+    return &model_bbif;
+}
+
+BB_Type *Model_BB(void)
+{
+    Model_Sync();
+    model_stats.reg_accesses++;
+    return &model_bb;
+}
+
+/**
+ * @brief      Signal an edge of the RTC clock on the GPIO3 interrupt line, if
+ *             it is routed there and the line waits for that edge
+ * @param [in] edge  GPIO_EVENT_RISING_EDGE or GPIO_EVENT_FALLING_EDGE
+ */
+static void Model_Edge(uint32_t edge)
+{
+    uint32_t cfg = model_gpio_int_cfg[3];
+
+    if (((cfg & MODEL_GPIO_SRC_Mask) == GPIO_SRC_GPIO_8) && ((cfg & MODEL_GPIO_EVENT_Mask) == edge) &&
+        ((model_gpio_cfg[8] & GPIO_MODE_STANDBYCLK) == GPIO_MODE_STANDBYCLK))
+    {
+        model_irq_pending[GPIO3_IRQn] = 1;
+        Model_Run_IRQs();
+    }
+}
+
+/**
+ * @brief Run half an RTC clock cycle: the RTC and the baseband timer count
+ *        on the rising edge
+ */
+static void Model_Step(void)
+{
+    Model_Sync();
+    model_time++;
+
+    if (model_time & 1)
+    {
+        model_stats.rtc_cycles++;
+        if (model_asleep)
+        {
+            model_stats.sleep_cycles++;
+        }
+
+        if (model_rtc_reset)
+        {
+            model_rtc_reset = 0;
+            model_acs.RTC_COUNT = model_acs.RTC_CFG;
+        }
+        else if (model_acs.RTC_CTRL & RTC_ENABLE)
+        {
+            if (model_acs.RTC_COUNT == 0)
+            {
+                model_acs.RTC_COUNT = model_acs.RTC_CFG;
+            }
+            else
+            {
+                model_acs.RTC_COUNT--;
+                if ((model_acs.RTC_COUNT == 0) &&
+                    ((model_acs.RTC_CTRL & ACS_RTC_CTRL_ALARM_CFG_Mask) == RTC_ALARM_ZERO))
+                {
+                    Model_Raise(MODEL_WAKEUP_RTC_ALARM);
+                }
+            }
+        }
+
+        if (model_bb_sleeping && (model_bb_remaining != 0) && (--model_bb_remaining == 0))
+        {
+            Model_Raise(MODEL_WAKEUP_BB_TIMER);
+        }
+    }
+
+    if (model_scheduled && (model_time >= model_scheduled_time))
+    {
+        model_scheduled = 0;
+        Model_Raise(model_scheduled_flag);
+    }
+
+    Model_Edge((model_time & 1) ? GPIO_EVENT_RISING_EDGE : GPIO_EVENT_FALLING_EDGE);
+    Model_Run_IRQs();
+}
+
+/**
+ * @brief  Check for an interrupt that wakes up the core
+ * @return 1 if an enabled interrupt is pending, masked or not
+ */
+static uint8_t Model_IRQ_Waiting(void)
+{
+    for (uint32_t i = 0; i < MODEL_IRQ_COUNT; i++)
+    {
+        if (model_irq_enabled[i] && model_irq_pending[i])
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief      Stop the test on a wait that never ends
+ * @param [in] what  Wait
+ */
+static void Model_Stuck(const char *what)
+{
+    fprintf(stderr, "model: %s never ends\n", what);
+    exit(1);
+}
+
+/**
+ * @brief      Sleep until a wakeup flag is set; without retention, reset the
+ *             core and restart the firmware through model_reset_hook
+ * @param [in] retention  1 if the core keeps its state
+ */
+static void Model_Sleep(uint8_t retention)
+{
+    uint64_t start = model_time;
+
+    model_stats.sleeps++;
+    model_asleep = 1;
+    while (model_flags == 0)
+    {
+        if ((model_time - start) > MODEL_WAIT_MAX)
+        {
+            Model_Stuck("sleep");
+        }
+        Model_Step();
+    }
+    model_asleep = 0;
+
+    if (retention)
+    {
+        Model_Run_IRQs();
+        return;
+    }
+
+    /* Only the always-on blocks keep their state */
+    model_stats.resets++;
+    memset(model_irq_enabled, 0, sizeof(model_irq_enabled));
+    memset(model_irq_pending, 0, sizeof(model_irq_pending));
+    memset(model_gpio_int_cfg, 0, sizeof(model_gpio_int_cfg));
+
+    /* The wakeup flags that woke the core up keep the wakeup interrupt
+     * pending through the reset */
+    model_irq_pending[WAKEUP_IRQn] = (model_flags != 0);
+    model_running_priority = MODEL_THREAD_PRIORITY;
+    model_primask = 0;
+
+    if (model_reset_hook != NULL)
+    {
+        model_reset_hook();
+    }
+    Model_Stuck("wakeup through reset");
+}
+
+int Model_Init(void)
+{
+    static uint8_t mapped;
+
+    if (!mapped)
+    {
+        /* The firmware reaches the HF controller and IO RAM at fixed
+         * addresses: back them with host memory */
+        void *bank = mmap((void *)(uintptr_t)PLATFORM_HF_BANK_ADDR, MODEL_HF_BANK_SIZE,
+                          PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        void *buffer = mmap((void *)(uintptr_t)PLATFORM_HF_BUFFER_ADDR, MODEL_HF_BUFFER_SIZE,
+                            PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if ((bank != (void *)(uintptr_t)PLATFORM_HF_BANK_ADDR) ||
+            (buffer != (void *)(uintptr_t)PLATFORM_HF_BUFFER_ADDR))
+        {
+            fprintf(stderr, "model: cannot map the HF controller at 0x%08X and 0x%08X\n",
+                    (unsigned)PLATFORM_HF_BANK_ADDR, (unsigned)PLATFORM_HF_BUFFER_ADDR);
+            return -1;
+        }
+        mapped = 1;
+    }
+
+    memset((void *)(uintptr_t)PLATFORM_HF_BANK_ADDR, 0, MODEL_HF_BANK_SIZE);
+    memset((void *)(uintptr_t)PLATFORM_HF_BUFFER_ADDR, 0, MODEL_HF_BUFFER_SIZE);
+
+    memset(&model_acs, 0, sizeof(model_acs));
+    memset(&model_sensor, 0, sizeof(model_sensor));
+    memset(&model_bbif, 0, sizeof(model_bbif));
+    memset(&model_bb, 0, sizeof(model_bb));
+    memset(&model_reset, 0, sizeof(model_reset));
+    memset(&model_clk, 0, sizeof(model_clk));
+    memset(&model_sysctrl, 0, sizeof(model_sysctrl));
+    memset(&model_nfc, 0, sizeof(model_nfc));
+    memset(&model_stats, 0, sizeof(model_stats));
+    memset(model_gpio_cfg, 0, sizeof(model_gpio_cfg));
+    memset(model_gpio_int_cfg, 0, sizeof(model_gpio_int_cfg));
+    memset(model_irq_enabled, 0, sizeof(model_irq_enabled));
+    memset(model_irq_pending, 0, sizeof(model_irq_pending));
+    memset(model_irq_priority, 0, sizeof(model_irq_priority));
+
+    model_flags = 0;
+    model_rtc_reset = 0;
+    model_scheduled = 0;
+    model_time = 0;
+    model_bb_sleeping = 0;
+    model_bb_remaining = 0;
+    model_gpio_out = 0;
+    model_running_priority = MODEL_THREAD_PRIORITY;
+    model_primask = 0;
+    model_asleep = 0;
+    model_delay_remainder = 0;
+    model_bbif.STATUS = OSC_ENABLED | RF_ENABLED | MASTER_CLK;
+
+    return 0;
+}
+
+void Model_Advance(uint32_t cycles)
+{
+    for (uint64_t i = 0; i < ((uint64_t)cycles * 2); i++)
+    {
+        Model_Step();
+    }
+}
+
+void Model_Wakeup(uint32_t n)
+{
+    Model_Sync();
+    Model_Raise(n);
+    Model_Run_IRQs();
+}
+
+void Model_Wakeup_At(uint32_t n, uint32_t cycles)
+{
+    model_scheduled_flag = n;
+    model_scheduled_time = model_time + ((uint64_t)cycles * 2);
+    model_scheduled = 1;
+}
+
+uint32_t Model_Wakeup_Flags(void)
+{
+    Model_Sync();
+    return model_flags;
+}
+
+void Model_Sensor_Sample(uint32_t value)
+{
+    uint32_t level;
+    uint32_t threshold;
+
+    Model_Sync();
+    level = (model_sensor.FIFO_CFG & SENSOR_FIFO_CFG_FIFO_LEVEL_Mask) >> SENSOR_FIFO_CFG_FIFO_LEVEL_Pos;
+    if (level < MODEL_SENSOR_FIFO_DEPTH)
+    {
+        model_sensor.ADC_DATA[level++] = value;
+        model_sensor.FIFO_CFG = (model_sensor.FIFO_CFG & ~SENSOR_FIFO_CFG_FIFO_LEVEL_Mask) |
+                                (level << SENSOR_FIFO_CFG_FIFO_LEVEL_Pos);
+    }
+
+    if (level > (model_sensor.FIFO_CFG & SENSOR_FIFO_CFG_FIFO_SIZE_Mask))
+    {
+        Model_Raise(MODEL_WAKEUP_FIFO_FULL);
+    }
+
+    threshold = model_sensor.PROCESSING & SENSOR_PROCESSING_THRESHOLD_Mask;
+    if ((threshold != 0) && (value >= threshold))
+    {
+        Model_Raise(MODEL_WAKEUP_THRESHOLD);
+    }
+
+    Model_Run_IRQs();
+}
+
+void Model_Sensor_FIFO_Reset(void)
+{
+    model_sensor.FIFO_CFG &= ~SENSOR_FIFO_CFG_FIFO_LEVEL_Mask;
+}
+
+uint32_t Model_GPIO_Config(uint32_t gpio)
+{
+    return model_gpio_cfg[gpio];
+}
+
+uint32_t Model_GPIO_Output(void)
+{
+    return model_gpio_out;
+}
+
+void Model_Run_IRQs(void)
+{
+    while (!model_primask && !model_asleep)
+    {
+        int best = -1;
+
+        for (uint32_t i = 0; i < MODEL_IRQ_COUNT; i++)
+        {
+            if (model_irq_enabled[i] && model_irq_pending[i] && (model_irq_handlers[i] != NULL) &&
+                (model_irq_priority[i] < model_running_priority) &&
+                ((best < 0) || (model_irq_priority[i] < model_irq_priority[best])))
+            {
+                best = (int)i;
+            }
+        }
+
+        if (best < 0)
+        {
+            break;
+        }
+
+        uint32_t previous = model_running_priority;
+
+        model_stats.irqs++;
+        model_irq_pending[best] = 0;
+        model_running_priority = model_irq_priority[best];
+        model_irq_handlers[best]();
+        model_running_priority = previous;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Core
+ * --------------------------------------------------------------------------*/
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+    model_irq_enabled[irq] = 1;
+    Model_Run_IRQs();
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+    model_irq_enabled[irq] = 0;
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type irq)
+{
+    model_irq_pending[irq] = 1;
+    Model_Run_IRQs();
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+    model_irq_pending[irq] = 0;
+}
+
+uint32_t NVIC_GetPendingIRQ(IRQn_Type irq)
+{
+    return model_irq_pending[irq];
+}
+
+uint32_t NVIC_GetEnableIRQ(IRQn_Type irq)
+{
+    return model_irq_enabled[irq];
+}
+
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+    model_irq_priority[irq] = priority;
+}
+
+uint32_t NVIC_GetPriority(IRQn_Type irq)
+{
+    return model_irq_priority[irq];
+}
+
+uint32_t __get_PRIMASK(void)
+{
+    return model_primask;
+}
+
+void __set_PRIMASK(uint32_t primask)
+{
+    model_primask = primask & 1;
+    Model_Run_IRQs();
+}
+
+void __disable_irq(void)
+{
+    model_primask = 1;
+}
+
+void __enable_irq(void)
+{
+    __set_PRIMASK(0);
+}
+
+void __WFI(void)
+{
+    uint64_t start = model_time;
+
+    while (!Model_IRQ_Waiting())
+    {
+        if ((model_time - start) > MODEL_WAIT_MAX)
+        {
+            Model_Stuck("__WFI()");
+        }
+        Model_Step();
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * System library
+ * --------------------------------------------------------------------------*/
+void SYS_GPIO_CONFIG(uint32_t gpio, uint32_t config)
+{
+    model_gpio_cfg[gpio] = config;
+}
+
+void Sys_GPIO_IntConfig(uint32_t index, uint32_t config, uint32_t dbnc_clk, uint32_t dbnc_count)
+{
+    (void)dbnc_clk;
+    (void)dbnc_count;
+
+    model_gpio_int_cfg[index] = config;
+}
+
+void Sys_GPIO_Set_High(uint32_t gpio)
+{
+    model_gpio_out |= (1U << gpio);
+}
+
+void Sys_GPIO_Set_Low(uint32_t gpio)
+{
+    model_gpio_out &= ~(1U << gpio);
+}
+
+void Sys_Delay(uint32_t cycles)
+{
+    uint64_t total = (uint64_t)cycles * MODEL_RTC_HZ + model_delay_remainder;
+
+    model_delay_remainder = (uint32_t)(total % SystemCoreClock);
+    Model_Advance((uint32_t)(total / SystemCoreClock));
+}
+
+void SYS_WATCHDOG_REFRESH(void)
+{
+}
+
+void Sys_PowerModes_Sleep_Init(sleep_mode_cfg *cfg)
+{
+    (void)cfg;
+}
+
+void Sys_PowerModes_Sleep_Enter(sleep_mode_cfg *cfg, uint32_t mode)
+{
+    (void)cfg;
+
+    Model_Sleep(mode == SLEEP_CORE_RETENTION);
+}
+
+void Sys_PowerModes_DeepSleep_Init(deepsleep_mode_cfg *cfg)
+{
+    (void)cfg;
+}
+
+void Sys_PowerModes_DeepSleep_Enter(deepsleep_mode_cfg *cfg)
+{
+    (void)cfg;
+
+    Model_Sleep(0);
+}
+
+void Sys_Sensor_StorageConfig(uint32_t diff_mode, uint32_t summation, uint32_t nbr_samples,
+                              uint32_t threshold, uint32_t fifo_store, uint32_t fifo_size)
+{
+    (void)diff_mode;
+    (void)summation;
+    (void)fifo_store;
+
+    SENSOR->PROCESSING = (nbr_samples & ~SENSOR_PROCESSING_THRESHOLD_Mask) |
+                         (threshold & SENSOR_PROCESSING_THRESHOLD_Mask);
+    SENSOR->FIFO_CFG = (SENSOR->FIFO_CFG & ~SENSOR_FIFO_CFG_FIFO_SIZE_Mask) |
+                       (fifo_size & SENSOR_FIFO_CFG_FIFO_SIZE_Mask);
+}
@@ -0,0 +1,495 @@
+/**
+ * @file montana.h
+ * @brief Host model of the device header: the ACS, SENSOR, BBIF, BB and
+ *        NVIC blocks live in host memory, with the behavior the firmware
+ *        relies on (sticky wakeup flags, RTC counter, baseband deep sleep,
+ *        sensor FIFO level and threshold, pending interrupts)
+ *
+ * Only the registers and bit fields used by the firmware sources built
+ * against the model are declared. The bit positions are the model's own, not
+ * those of the device; the firmware only uses them through these names.
+ *
+ * Every access through ACS, SENSOR, BBIF or BB first brings the model up to
+ * date with the previous accesses, so that a write-1-to-clear flag or a
+ * polled status bit changes between two accesses as on the device. The RTC
+ * clock only advances with Model_Advance(), or while the core waits in
+ * __WFI() or in a power mode.
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#ifndef MONTANA_H_
+#define MONTANA_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/* ----------------------------------------------------------------------------
+ * Core
+ * --------------------------------------------------------------------------*/
+#define __IO                            volatile
+#define __NVIC_PRIO_BITS                3U
+
+/* Interrupts of the model; the handlers of WAKEUP_IRQn and GPIO3_IRQn are run
+ * by the model when pending, enabled and not masked */
+typedef enum
+{
+    WAKEUP_IRQn     = 0,
+    GPIO3_IRQn      = 1,
+    BLE_SLP_IRQn    = 2,
+    NFC_IRQn        = 3,
+    MODEL_IRQ_COUNT = 4
+} IRQn_Type;
+
+#define PRIMASK_ENABLE_INTERRUPTS       0x0
+
+extern uint32_t SystemCoreClock;
+
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void NVIC_SetPendingIRQ(IRQn_Type irq);
+void NVIC_ClearPendingIRQ(IRQn_Type irq);
+uint32_t NVIC_GetPendingIRQ(IRQn_Type irq);
+uint32_t NVIC_GetEnableIRQ(IRQn_Type irq);
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority);
+uint32_t NVIC_GetPriority(IRQn_Type irq);
+
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+void __disable_irq(void);
+void __enable_irq(void);
+void __WFI(void);
+
+#define __NOP()                         ((void)0)
+#define __DMB()                         __sync_synchronize()
+#define __CLZ(x)                        (((x) == 0) ? 32U : (uint32_t)__builtin_clz(x))
+#define __RBIT(x)                       Model_RBIT(x)
+#define __UNALIGNED_UINT32_READ(p)      Model_Read32(p)
+#define __UNALIGNED_UINT32_WRITE(p, v)  Model_Write32((p), (v))
+
+static inline uint32_t Model_RBIT(uint32_t x)
+{
+    uint32_t r = 0;
+
+    for (uint32_t i = 0; i < 32; i++, x >>= 1)
+    {
+        r = (r << 1) | (x & 1);
+    }
+
+    return r;
+}
+
+static inline uint32_t Model_Read32(const void *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void Model_Write32(void *p, uint32_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+/* ----------------------------------------------------------------------------
+ * Always-on control system (ACS)
+ * --------------------------------------------------------------------------*/
+typedef struct
+{
+    __IO uint32_t WAKEUP_CTRL;
+    __IO uint32_t WAKEUP_CFG;
+    __IO uint32_t RTC_CTRL;
+    __IO uint32_t RTC_CFG;
+    __IO uint32_t RTC_COUNT;
+    __IO uint32_t RESET_STATUS;
+    __IO uint32_t CLK_DET_CTRL;
+    __IO uint32_t SENSOR_DET_CFG;
+    __IO uint32_t RCOSC_CTRL;
+    __IO uint32_t VDDIF_CTRL;
+    __IO uint32_t BB_TIMER_CTRL;
+    __IO uint32_t BOOT_CFG;
+} ACS_Type;
+
+/* WAKEUP_CTRL: write 1 to bit n to clear the sticky flag read at bit n + 16 */
+#define MODEL_WAKEUP_RTC_ALARM          0
+#define MODEL_WAKEUP_GPIO0              1
+#define MODEL_WAKEUP_GPIO1              2
+#define MODEL_WAKEUP_GPIO2              3
+#define MODEL_WAKEUP_GPIO3              4
+#define MODEL_WAKEUP_BB_TIMER           5
+#define MODEL_WAKEUP_FIFO_FULL          6
+#define MODEL_WAKEUP_THRESHOLD          7
+#define MODEL_WAKEUP_NFC_FIELD          8
+#define MODEL_WAKEUP_SENSOR_DET         9
+#define MODEL_WAKEUP_COUNT              10
+#define MODEL_WAKEUP_CLEAR_Mask         ((1U << MODEL_WAKEUP_COUNT) - 1)
+#define MODEL_WAKEUP_EVENT_Pos          16
+
+#define MODEL_WAKEUP_EVENT(n)           ((uint32_t)(1U << (MODEL_WAKEUP_EVENT_Pos + (n))))
+#define MODEL_WAKEUP_CLEAR(n)           ((uint32_t)(1U << (n)))
+
+#define WAKEUP_RTC_ALARM_EVENT_SET      MODEL_WAKEUP_EVENT(MODEL_WAKEUP_RTC_ALARM)
+#define WAKEUP_GPIO1_EVENT_SET          MODEL_WAKEUP_EVENT(MODEL_WAKEUP_GPIO1)
+#define WAKEUP_BB_TIMER_EVENT_SET       MODEL_WAKEUP_EVENT(MODEL_WAKEUP_BB_TIMER)
+#define WAKEUP_FIFO_FULL_EVENT_SET      MODEL_WAKEUP_EVENT(MODEL_WAKEUP_FIFO_FULL)
+#define WAKEUP_THRESHOLD_EVENT_SET      MODEL_WAKEUP_EVENT(MODEL_WAKEUP_THRESHOLD)
+#define WAKEUP_NFC_FIELD_EVENT_SET      MODEL_WAKEUP_EVENT(MODEL_WAKEUP_NFC_FIELD)
+#define WAKEUP_SENSOR_DET_EVENT_SET     MODEL_WAKEUP_EVENT(MODEL_WAKEUP_SENSOR_DET)
+
+#define WAKEUP_RTC_ALARM_EVENT_CLEAR    MODEL_WAKEUP_CLEAR(MODEL_WAKEUP_RTC_ALARM)
+#define WAKEUP_GPIO0_EVENT_CLEAR        MODEL_WAKEUP_CLEAR(MODEL_WAKEUP_GPIO0)
+#define WAKEUP_GPIO1_EVENT_CLEAR        MODEL_WAKEUP_CLEAR(MODEL_WAKEUP_GPIO1)
+#define WAKEUP_GPIO2_EVENT_CLEAR        MODEL_WAKEUP_CLEAR(MODEL_WAKEUP_GPIO2)
+#define WAKEUP_GPIO3_EVENT_CLEAR        MODEL_WAKEUP_CLEAR(MODEL_WAKEUP_GPIO3)
+#define WAKEUP_BB_TIMER_CLEAR           MODEL_WAKEUP_CLEAR(MODEL_WAKEUP_BB_TIMER)
+#define WAKEUP_FIFO_FULL_EVENT_CLEAR    MODEL_WAKEUP_CLEAR(MODEL_WAKEUP_FIFO_FULL)
+#define THRESHOLD_FULL_EVENT_CLEAR      MODEL_WAKEUP_CLEAR(MODEL_WAKEUP_THRESHOLD)
+#define WAKEUP_NFC_FIELD_EVENT_CLEAR    MODEL_WAKEUP_CLEAR(MODEL_WAKEUP_NFC_FIELD)
+#define WAKEUP_SENSOR_DET_EVENT_CLEAR   MODEL_WAKEUP_CLEAR(MODEL_WAKEUP_SENSOR_DET)
+
+/* WAKEUP_CFG: recorded only */
+#define WAKEUP_DELAY_16                 ((uint32_t)(0x4U << 0))
+#define WAKEUP_NFC_FIELD_ENABLE         ((uint32_t)(0x1U << 4))
+#define NFC_FIELD_0                     ((uint32_t)(0x0U << 5))
+#define WAKEUP_USE_HF_OK                ((uint32_t)(0x1U << 8))
+#define WAKEUP_FIFO_ENABLE              ((uint32_t)(0x1U << 9))
+
+/* RTC_CTRL: the RTC counts down on each RTC clock cycle while enabled, and
+ * the count after zero is RTC_CFG again. RESET loads RTC_CFG into RTC_COUNT
+ * on the next RTC clock edge, or at once with FORCE_CLOCK; both bits clear
+ * themselves. The alarm flag is raised when the count reaches zero with
+ * ALARM_ZERO */
+#define RTC_DISABLE                     ((uint32_t)(0x0U << 0))
+#define RTC_ENABLE                      ((uint32_t)(0x1U << 0))
+#define RTC_RESET                       ((uint32_t)(0x1U << 1))
+#define RTC_FORCE_CLOCK                 ((uint32_t)(0x1U << 2))
+#define ACS_RTC_CTRL_ALARM_CFG_Mask     ((uint32_t)(0x3U << 4))
+#define RTC_ALARM_DISABLE               ((uint32_t)(0x0U << 4))
+#define RTC_ALARM_ZERO                  ((uint32_t)(0x1U << 4))
+#define RTC_CLK_SRC_RC_OSC              ((uint32_t)(0x0U << 8))
+#define RTC_CLK_SRC_XTAL32K             ((uint32_t)(0x1U << 8))
+#define RTC_CLK_SRC_GPIO0               ((uint32_t)(0x2U << 8))
+#define RTC_CLK_SRC_GPIO1               ((uint32_t)(0x3U << 8))
+
+#define ACS_CLK_DET_CTRL_ENABLE_Pos     0
+#define ACS_CLK_DET_CTRL_RESET_IGNORE_Pos 1
+
+#define SENSOR_DET_DISABLED             ((uint32_t)(0x0U << 0))
+#define SENSOR_DET_ENABLED              ((uint32_t)(0x1U << 0))
+#define SENSOR_DET_RESET                ((uint32_t)(0x0U << 1))
+#define SENSOR_DET_NOT_RESET            ((uint32_t)(0x1U << 1))
+#define SENSOR_DETECTED                 ((uint32_t)(0x1U << 2))
+
+#define RC32_OSC_ENABLE                 ((uint32_t)(0x1U << 0))
+#define RC_OSC_12MHZ                    ((uint32_t)(0x1U << 8))
+#define RC_OSC_P46P5                    ((uint32_t)(0x2U << 12))
+
+#define VDDIF_ENABLE                    ((uint32_t)(0x1U << 0))
+
+#define BB_CLK_PRESCALE_1               ((uint32_t)(0x0U << 0))
+#define BB_TIMER_RESET                  ((uint32_t)(0x0U << 4))
+#define BB_TIMER_NRESET                 ((uint32_t)(0x1U << 4))
+
+#define ACS_BOOT_CFG_PADS_RETENTION_EN_Pos 0
+
+/* ----------------------------------------------------------------------------
+ * Sensor interface
+ * --------------------------------------------------------------------------*/
+#define MODEL_SENSOR_FIFO_DEPTH         16
+
+typedef struct
+{
+    __IO uint32_t FIFO_CFG;
+    __IO uint32_t PROCESSING;
+    __IO uint32_t ADC_DATA[MODEL_SENSOR_FIFO_DEPTH];
+} SENSOR_Type;
+
+#define SENSOR_FIFO_CFG_FIFO_LEVEL_Pos  8
+#define SENSOR_FIFO_CFG_FIFO_LEVEL_Mask ((uint32_t)(0x1FU << SENSOR_FIFO_CFG_FIFO_LEVEL_Pos))
+#define SENSOR_FIFO_CFG_FIFO_SIZE_Mask  ((uint32_t)(0xFU << 0))
+
+/* FIFO_SIZE field: FIFO full after SENSOR_FIFO_SIZEn samples */
+#define SENSOR_FIFO_SIZE1               ((uint32_t)(0x0U << 0))
+#define SENSOR_FIFO_SIZE2               ((uint32_t)(0x1U << 0))
+#define SENSOR_FIFO_SIZE4               ((uint32_t)(0x3U << 0))
+#define SENSOR_FIFO_SIZE8               ((uint32_t)(0x7U << 0))
+#define SENSOR_FIFO_SIZE16              ((uint32_t)(0xFU << 0))
+
+/* PROCESSING: the threshold flag is raised by a sample at or above a non
+ * zero THRESHOLD */
+#define SENSOR_PROCESSING_THRESHOLD_Pos 0
+#define SENSOR_PROCESSING_THRESHOLD_Mask ((uint32_t)(0xFFFFU << SENSOR_PROCESSING_THRESHOLD_Pos))
+#define SENSOR_THRESHOLD_DISABLED       ((uint32_t)(0x0U << SENSOR_PROCESSING_THRESHOLD_Pos))
+#define SENSOR_PROCESSING_NBR_SAMPLES_Pos 16
+#define SENSOR_NBR_SAMPLES_1            ((uint32_t)(0x0U << SENSOR_PROCESSING_NBR_SAMPLES_Pos))
+#define SENSOR_NBR_SAMPLES_2            ((uint32_t)(0x1U << SENSOR_PROCESSING_NBR_SAMPLES_Pos))
+#define SENSOR_SUMMATION_DISABLED       ((uint32_t)(0x0U << 24))
+#define SENSOR_FIFO_STORE_ENABLED       ((uint32_t)(0x1U << 25))
+
+/* ----------------------------------------------------------------------------
+ * Baseband interface and baseband low power timer
+ * --------------------------------------------------------------------------*/
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t STATUS;
+} BBIF_Type;
+
+#define BB_CLK_ENABLE                   ((uint32_t)(0x1U << 0))
+#define BBCLK_DIVIDER_8                 ((uint32_t)(0x7U << 4))
+#define BB_DEEP_SLEEP                   ((uint32_t)(0x1U << 8))
+#define BB_WAKEUP                       ((uint32_t)(0x1U << 9))
+
+#define OSC_DISABLED                    ((uint32_t)(0x0U << 0))
+#define OSC_ENABLED                     ((uint32_t)(0x1U << 0))
+#define RF_DISABLED                     ((uint32_t)(0x0U << 1))
+#define RF_ENABLED                      ((uint32_t)(0x1U << 1))
+#define MASTER_CLK                      ((uint32_t)(0x0U << 2))
+#define LOW_POWER_CLK                   ((uint32_t)(0x1U << 2))
+
+/* The baseband enters deep sleep when DEEP_SLEEP_ON is set, counts
+ * DEEPSLTIME low power clock cycles, then raises the BB timer flag; BB_WAKEUP
+ * brings it back to the master clock and clears DEEP_SLEEP_ON */
+typedef struct
+{
+    __IO uint32_t RWBBCNTL;
+    __IO uint32_t DEEPSLCNTL;
+    __IO uint32_t DEEPSLWKUP;
+    __IO uint32_t ENBPRESET;
+} BB_Type;
+
+#define MASTER_SOFT_RST_1               ((uint32_t)(0x1U << 0))
+#define MASTER_TGSOFT_RST_1             ((uint32_t)(0x1U << 1))
+#define RADIOCNTL_SOFT_RST_1            ((uint32_t)(0x1U << 2))
+#define OSC_SLEEP_EN_1                  ((uint32_t)(0x1U << 0))
+#define RADIO_SLEEP_EN_1                ((uint32_t)(0x1U << 1))
+#define DEEP_SLEEP_ON_1                 ((uint32_t)(0x1U << 2))
+#define BB_DEEPSLWKUP_DEEPSLTIME_Pos    0
+#define BB_ENBPRESET_TWOSC_Pos          0
+#define BB_ENBPRESET_TWRM_Pos           16
+
+/* ----------------------------------------------------------------------------
+ * Other blocks: recorded only
+ * --------------------------------------------------------------------------*/
+typedef struct
+{
+    __IO uint32_t DIG_STATUS;
+} RESET_Type;
+
+typedef struct
+{
+    __IO uint32_t DIV_CFG1;
+} CLK_Type;
+
+typedef struct
+{
+    __IO uint32_t NFC_CFG;
+} SYSCTRL_Type;
+
+typedef struct
+{
+    __IO uint32_t HFCTRL_TEST_CTRL;
+} NFC_Type;
+
+#define SENSOR_CLK_ENABLE               ((uint32_t)(0x1U << 0))
+#define NFC_EN                          ((uint32_t)(0x1U << 0))
+#define CLK_EXTRACTOR_ENABLED           ((uint32_t)(0x1U << 0))
+
+/* ----------------------------------------------------------------------------
+ * Block instances
+ * --------------------------------------------------------------------------*/
+ACS_Type *Model_ACS(void);
+SENSOR_Type *Model_SENSOR(void);
+BBIF_Type *Model_BBIF(void);
+BB_Type *Model_BB(void);
+
+extern RESET_Type model_reset;
+extern CLK_Type model_clk;
+extern SYSCTRL_Type model_sysctrl;
+extern NFC_Type model_nfc;
+
+#define ACS                             (Model_ACS())
+#define SENSOR                          (Model_SENSOR())
+#define BBIF                            (Model_BBIF())
+#define BB                              (Model_BB())
+#define RESET                           (&model_reset)
+#define CLK                             (&model_clk)
+#define SYSCTRL                         (&model_sysctrl)
+#define NFC                             (&model_nfc)
+
+/* ----------------------------------------------------------------------------
+ * GPIO
+ * --------------------------------------------------------------------------*/
+#define GPIO0                           0
+#define GPIO1                           1
+
+#define GPIO_MODE_DISABLE               ((uint32_t)(0x0U << 0))
+#define GPIO_MODE_INPUT                 ((uint32_t)(0x1U << 0))
+#define GPIO_MODE_STANDBYCLK            ((uint32_t)(0x2U << 0))
+#define GPIO_NO_PULL                    ((uint32_t)(0x0U << 4))
+#define GPIO_WEAK_PULL_UP               ((uint32_t)(0x1U << 4))
+#define GPIO_LPF_DISABLE                ((uint32_t)(0x0U << 6))
+#define GPIO_2X_DRIVE                   ((uint32_t)(0x1U << 8))
+#define GPIO_6X_DRIVE                   ((uint32_t)(0x3U << 8))
+#define NS_CANNOT_USE_GPIO              ((uint32_t)(0x0U << 12))
+
+/* Interrupt line configuration: the GPIO3 line fires on the selected edge
+ * of the RTC clock when its source is GPIO8 in standby clock mode */
+#define GPIO_EVENT_NONE                 ((uint32_t)(0x0U << 0))
+#define GPIO_EVENT_RISING_EDGE          ((uint32_t)(0x2U << 0))
+#define GPIO_EVENT_FALLING_EDGE         ((uint32_t)(0x3U << 0))
+#define MODEL_GPIO_EVENT_Mask           ((uint32_t)(0x7U << 0))
+#define GPIO_DEBOUNCE_DISABLE           ((uint32_t)(0x0U << 3))
+#define GPIO_SRC_GPIO_8                 ((uint32_t)(0x8U << 8))
+#define MODEL_GPIO_SRC_Mask             ((uint32_t)(0xFU << 8))
+#define NS_CANNOT_ACCESS_GPIO_INT       ((uint32_t)(0x0U << 12))
+#define GPIO_DEBOUNCE_SLOWCLK_DIV32     0
+
+#define MODEL_GPIO_COUNT                16
+
+void SYS_GPIO_CONFIG(uint32_t gpio, uint32_t config);
+void Sys_GPIO_IntConfig(uint32_t index, uint32_t config, uint32_t dbnc_clk, uint32_t dbnc_count);
+void Sys_GPIO_Set_High(uint32_t gpio);
+void Sys_GPIO_Set_Low(uint32_t gpio);
+
+/* ----------------------------------------------------------------------------
+ * System library
+ * --------------------------------------------------------------------------*/
+typedef struct
+{
+    uint32_t wakeup_cfg;
+} sleep_mode_cfg;
+
+typedef sleep_mode_cfg deepsleep_mode_cfg;
+
+#define SLEEP_CORE_RETENTION            1
+#define SLEEP_NO_RETENTION              0
+
+void Sys_Delay(uint32_t cycles);
+void SYS_WATCHDOG_REFRESH(void);
+void Sys_PowerModes_Sleep_Init(sleep_mode_cfg *cfg);
+void Sys_PowerModes_Sleep_Enter(sleep_mode_cfg *cfg, uint32_t mode);
+void Sys_PowerModes_DeepSleep_Init(deepsleep_mode_cfg *cfg);
+void Sys_PowerModes_DeepSleep_Enter(deepsleep_mode_cfg *cfg);
+
+/* ----------------------------------------------------------------------------
+ * Model control, used by the host tests
+ * --------------------------------------------------------------------------*/
+/* Counts since Model_Init() */
+typedef struct
+{
+    uint64_t reg_accesses;      /* accesses through ACS, SENSOR, BBIF and BB */
+    uint64_t rtc_cycles;        /* RTC clock cycles elapsed */
+    uint64_t sleep_cycles;      /* RTC clock cycles spent in a power mode */
+    uint32_t sleeps;            /* power mode entries */
+    uint32_t resets;            /* wakeups through reset */
+    uint32_t irqs;              /* interrupt handlers run */
+} model_stats_t;
+
+extern model_stats_t model_stats;
+
+/* Called for a wakeup through reset (sleep without retention or deep
+ * sleep): the test restarts the firmware from there, typically with
+ * longjmp(); the model stops the test if it returns */
+extern void (*model_reset_hook)(void);
+
+/**
+ * @brief  Reset the blocks to their power-on state and map the HF controller
+ *         and IO RAM at PLATFORM_HF_BANK_ADDR and PLATFORM_HF_BUFFER_ADDR
+ * @return 0, or -1 if the HF addresses cannot be mapped
+ */
+int Model_Init(void);
+
+/**
+ * @brief      Run RTC clock cycles: RTC counter, baseband timer, edges on
+ *             the GPIO3 interrupt line, and the interrupts taken on the way
+ * @param [in] cycles  Number of RTC clock cycles
+ */
+void Model_Advance(uint32_t cycles);
+
+/**
+ * @brief      Raise a sticky wakeup flag, as the hardware would
+ * @param [in] n  MODEL_WAKEUP_*
+ */
+void Model_Wakeup(uint32_t n);
+
+/**
+ * @brief      Raise a sticky wakeup flag after some RTC clock cycles, for a
+ *             wakeup that happens while the firmware sleeps
+ * @param [in] n       MODEL_WAKEUP_*
+ * @param [in] cycles  RTC clock cycles from now
+ */
+void Model_Wakeup_At(uint32_t n, uint32_t cycles);
+
+/**
+ * @brief  Sticky wakeup flags set
+ * @return Bit n set for MODEL_WAKEUP_n
+ */
+uint32_t Model_Wakeup_Flags(void);
+
+/**
+ * @brief      Store one ADC sample in the sensor FIFO, raising the FIFO full
+ *             and threshold flags as the sensor would
+ * @param [in] value  Sample
+ */
+void Model_Sensor_Sample(uint32_t value);
+
+/**
+ * @brief Empty the sensor FIFO. Reading SENSOR->ADC_DATA[0] empties the FIFO
+ *        of the device, but the model does not see reads: the code that
+ *        drains the FIFO calls this instead
+ */
+void Model_Sensor_FIFO_Reset(void);
+
+/**
+ * @brief      Configuration written by SYS_GPIO_CONFIG()
+ * @param [in] gpio  GPIO number
+ * @return     Configuration
+ */
+uint32_t Model_GPIO_Config(uint32_t gpio);
+
+/**
+ * @brief  GPIO output levels
+ * @return Bit n set when GPIO n is high
+ */
+uint32_t Model_GPIO_Output(void);
+
+/**
+ * @brief Run the pending interrupts that are enabled and not masked, highest
+ *        priority first
+ */
+void Model_Run_IRQs(void);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* MONTANA_H_ */
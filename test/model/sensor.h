@@ -0,0 +1,55 @@
+/**
+ * @file sensor.h
+ * @brief Host model of the sensor interface library
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#ifndef SENSOR_H_
+#define SENSOR_H_
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include "montana.h"
+
+/* ----------------------------------------------------------------------------
+ * If building with a C++ compiler, make all of the definitions in this header
+ * have a C binding.
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+/**
+ * @brief      Configure the sample storage: the threshold goes to
+ *             SENSOR->PROCESSING and the FIFO size to SENSOR->FIFO_CFG
+ * @param [in] diff_mode    Differential mode, recorded only
+ * @param [in] summation    Summation mode, recorded only
+ * @param [in] nbr_samples  SENSOR_NBR_SAMPLES_*
+ * @param [in] threshold    Threshold
+ * @param [in] fifo_store   Storage in the FIFO, recorded only
+ * @param [in] fifo_size    SENSOR_FIFO_SIZE*
+ */
+void Sys_Sensor_StorageConfig(uint32_t diff_mode, uint32_t summation, uint32_t nbr_samples,
+                              uint32_t threshold, uint32_t fifo_store, uint32_t fifo_size);
+
+/* ----------------------------------------------------------------------------
+ * Close the 'extern "C"' block
+ * ------------------------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* SENSOR_H_ */
@@ -0,0 +1,610 @@
+/**
+ * @file test_device_model.c
+ * @brief Run the wakeup path (lowpwr_manager.c, wakeup_source_config.c) on
+ *        the host model of the device in model/, and print the register
+ *        accesses and RTC clock cycles of each scenario
+ *
+ * The events reach the test through the event queue. The other modules the
+ * wakeup path hands its work to (sample buffer, FIFO controller, threshold
+ * manager, sensor profiles, power governor) are replaced by the stubs below.
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include <stdio.h>
+#include <setjmp.h>
+#include "app.h"
+#include "iso14443.h"
+
+/* Events taken with Event_Get() */
+#define TEST_EVENT_MAX                  64
+
+/* Events posted with RTC_ALARM_Reconfig() */
+#define TEST_RTC_ALARM_TICKS            100
+
+/* RTC clock cycles from a sleep entry to the scheduled wakeup */
+#define TEST_SLEEP_CYCLES               1000
+
+typedef struct
+{
+    uint32_t src;
+    uint32_t value;
+} test_event_t;
+
+static test_event_t test_events[TEST_EVENT_MAX];
+static uint32_t test_event_count;
+
+/* Number of times Test_GPIO1_Handler() raises the GPIO1 flag again, and
+ * number of times it ran */
+static uint32_t test_gpio1_repeat;
+static uint32_t test_gpio1_calls;
+
+/* Power mode returned by Power_Governor_Select() */
+static power_mode_t test_power_mode;
+
+/* Samples taken by Sample_Buffer_Drain() */
+static uint32_t test_drained;
+
+static uint8_t test_profile_valid;
+static const sensor_profile_t test_profile;
+
+/* Wakeup through reset */
+static jmp_buf test_reset;
+
+/* Model counts at the start and at the end of the running scenario, before
+ * the checks read the registers */
+static model_stats_t test_start;
+static model_stats_t test_end;
+
+/* ----------------------------------------------------------------------------
+ * Stubs of the modules the wakeup path hands its work to
+ * --------------------------------------------------------------------------*/
+uint32_t Sample_Buffer_Drain(uint32_t level)
+{
+    for (uint32_t i = 0; i < level; i++)
+    {
+        test_drained += SENSOR->ADC_DATA[i];
+    }
+
+    Model_Sensor_FIFO_Reset();
+
+    return level;
+}
+
+void FIFO_Controller_Apply(void)
+{
+}
+
+void Threshold_Manager_Trigger(void)
+{
+}
+
+void Timebase_Update(void)
+{
+}
+
+void NFC_Engine_Init(void)
+{
+}
+
+power_mode_t Power_Governor_Select(void)
+{
+    return test_power_mode;
+}
+
+void Sensor_Profile_Apply(sensor_profile_id_t profile)
+{
+    (void)profile;
+
+    test_profile_valid = 1;
+}
+
+sensor_profile_id_t Sensor_Profile_Current(void)
+{
+    return SENSOR_PROFILE_DEFAULT;
+}
+
+uint8_t Sensor_Profile_Valid(void)
+{
+    return test_profile_valid;
+}
+
+void Sensor_Profile_Invalidate(void)
+{
+    test_profile_valid = 0;
+}
+
+uint8_t Sensor_Profile_Check(void)
+{
+    return 1;
+}
+
+const sensor_profile_t *Sensor_Profile_Get(sensor_profile_id_t profile)
+{
+    (void)profile;
+
+    return &test_profile;
+}
+
+/* ----------------------------------------------------------------------------
+ * Scenarios
+ * --------------------------------------------------------------------------*/
+/**
+ * @brief Restart the firmware after a wakeup through reset
+ */
+static void Test_Reset_Hook(void)
+{
+    longjmp(test_reset, 1);
+}
+
+/**
+ * @brief Take the events waiting in the queue
+ */
+static void Test_Take(void)
+{
+    app_event_t event;
+
+    while (Event_Get(&event))
+    {
+        if ((event.type == EVENT_WAKEUP) && (test_event_count < TEST_EVENT_MAX))
+        {
+            test_events[test_event_count].src = event.arg;
+            test_events[test_event_count].value = event.value;
+            test_event_count++;
+        }
+    }
+}
+
+/**
+ * @brief Start a scenario: forget the events taken so far
+ */
+static void Test_Begin(void)
+{
+    Test_Take();
+    test_event_count = 0;
+    test_start = model_stats;
+}
+
+/**
+ * @brief End the part of the scenario run by the firmware
+ */
+static void Test_Measure(void)
+{
+    test_end = model_stats;
+}
+
+/**
+ * @brief      Print the register accesses and RTC clock cycles of the
+ *             scenario
+ * @param [in] name    Scenario
+ * @param [in] failed  0 if the scenario passed
+ * @return     failed
+ */
+static int Test_End(const char *name, int failed)
+{
+    printf("%-28s %-4s %8llu accesses %10llu RTC cycles %3u IRQs\n", name, failed ? "FAIL" : "ok",
+           (unsigned long long)(test_end.reg_accesses - test_start.reg_accesses),
+           (unsigned long long)(test_end.rtc_cycles - test_start.rtc_cycles),
+           (unsigned)(test_end.irqs - test_start.irqs));
+
+    return failed;
+}
+
+/**
+ * @brief  Number of events taken in the scenario
+ * @return Number of events
+ */
+static uint32_t Test_Count(void)
+{
+    Test_Take();
+
+    return test_event_count;
+}
+
+/**
+ * @brief      Check an event taken from the queue
+ * @param [in] index  Event index
+ * @param [in] src    Expected WAKEUP_SRC_*
+ * @return     0 if the event was signaled by the handler of src
+ */
+static int Test_Event(uint32_t index, uint32_t src)
+{
+    Test_Take();
+
+    if ((index >= test_event_count) || (test_events[index].src != src))
+    {
+        fprintf(stderr, "event %u: expected source %u, got %s%u\n", (unsigned)index, (unsigned)src,
+                (index >= test_event_count) ? "no event " : "",
+                (index >= test_event_count) ? 0 : (unsigned)test_events[index].src);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  Cold boot configuration: all sources set up, no flag left set,
+ *         the Type A answer in the IO RAM, the baseband in deep sleep
+ * @return 0 on success
+ */
+static int Test_Config(void)
+{
+    const uint8_t *layer3 = (const uint8_t *)(uintptr_t)PLATFORM_HF_BUFFER_ADDR + (HF_IO_RAM_EMPTY_OFFSET >> 2);
+    int failed = 0;
+
+    Test_Begin();
+    Wakeup_Source_Config();
+
+    /* Let the RTC load its preload value */
+    Model_Advance(1);
+
+    Test_Measure();
+
+    failed |= (Model_Wakeup_Flags() != 0);
+    failed |= (NVIC_GetEnableIRQ(WAKEUP_IRQn) == 0);
+    failed |= (ACS->RTC_CFG != RTC_CFG_RELOAD_VALUE);
+    failed |= ((ACS->RTC_CTRL & (RTC_ENABLE | ACS_RTC_CTRL_ALARM_CFG_Mask)) != (RTC_ENABLE | RTC_ALARM_ZERO));
+    failed |= ((BBIF->STATUS & LOW_POWER_CLK) != LOW_POWER_CLK);
+    failed |= (layer3[0] != 0x44) || (layer3[13] != NFC_ISO4_SAK);
+    failed |= (test_profile_valid == 0);
+
+    return Test_End("Wakeup_Source_Config", failed);
+}
+
+/**
+ * @brief  Flags raised while interrupts are masked are all dispatched by one
+ *         WAKEUP_IRQHandler() entry and cleared; the main loop takes the
+ *         signals lowest source first
+ * @return 0 on success
+ */
+static int Test_Dispatch(void)
+{
+    int failed = 0;
+
+    Test_Begin();
+    test_drained = 0;
+
+    __disable_irq();
+    Model_Wakeup(MODEL_WAKEUP_GPIO1);
+    Model_Wakeup(MODEL_WAKEUP_NFC_FIELD);
+    Model_Sensor_Sample(0x1234);
+    __enable_irq();
+
+    Test_Measure();
+
+    failed |= Test_Event(0, WAKEUP_SRC_FIFO);
+    failed |= Test_Event(1, WAKEUP_SRC_NFC);
+    failed |= Test_Event(2, WAKEUP_SRC_GPIO);
+    failed |= (Test_Count() != 3);
+    failed |= (test_drained != 0x1234);
+    failed |= (Model_Wakeup_Flags() != 0);
+    failed |= ((model_stats.irqs - test_start.irqs) != 1);
+
+    return Test_End("dispatch", failed);
+}
+
+/**
+ * @brief GPIO1 handler raising the GPIO1 flag again test_gpio1_repeat times
+ */
+static void Test_GPIO1_Handler(void)
+{
+    test_gpio1_calls++;
+    GPIO1_Wakeup_Process_Handler();
+
+    if (test_gpio1_repeat != 0)
+    {
+        test_gpio1_repeat--;
+        Model_Wakeup(MODEL_WAKEUP_GPIO1);
+    }
+}
+
+/**
+ * @brief  A flag raised again by the handlers is dispatched on a later pass;
+ *         after WAKEUP_DISPATCH_MAX_PASS passes the interrupt is left pending
+ *         and entered again. The signals not taken yet by the main loop are
+ *         merged into one event
+ * @return 0 on success
+ */
+static int Test_Dispatch_Passes(void)
+{
+    const uint32_t repeat = WAKEUP_DISPATCH_MAX_PASS + 2;
+    int failed = 0;
+
+    Test_Begin();
+    test_gpio1_repeat = repeat;
+    test_gpio1_calls = 0;
+
+    Wakeup_Handler_Register(WAKEUP_GPIO1_EVENT_SET, WAKEUP_GPIO1_EVENT_CLEAR, WAKEUP_SRC_GPIO,
+                            Test_GPIO1_Handler);
+    Model_Wakeup(MODEL_WAKEUP_GPIO1);
+    Wakeup_Handler_Register(WAKEUP_GPIO1_EVENT_SET, WAKEUP_GPIO1_EVENT_CLEAR, WAKEUP_SRC_GPIO,
+                            GPIO1_Wakeup_Process_Handler);
+
+    Test_Measure();
+
+    failed |= (test_gpio1_calls != (repeat + 1));
+    failed |= Test_Event(0, WAKEUP_SRC_GPIO);
+    failed |= (Test_Count() != 1);
+    failed |= (Model_Wakeup_Flags() != 0);
+    failed |= ((model_stats.irqs - test_start.irqs) < 2);
+
+    return Test_End("dispatch passes", failed);
+}
+
+/**
+ * @brief  A wakeup is not lost when the event queue is full: its signal is
+ *         taken before the queued events
+ * @return 0 on success
+ */
+static int Test_Queue_Full(void)
+{
+    app_event_t event;
+    uint32_t dropped = Event_Queue_Dropped();
+    uint32_t queued = 0;
+    int failed = 0;
+
+    Test_Begin();
+
+    for (uint32_t i = 0; i <= EVENT_QUEUE_LENGTH; i++)
+    {
+        queued += Event_Post(EVENT_NFC, 0, 0, i);
+    }
+    Model_Wakeup(MODEL_WAKEUP_RTC_ALARM);
+
+    Test_Measure();
+
+    failed |= (queued != EVENT_QUEUE_LENGTH);
+    failed |= ((Event_Queue_Dropped() - dropped) != 1);
+    failed |= (Event_Get(&event) == 0);
+    failed |= (event.type != EVENT_WAKEUP) || (event.arg != WAKEUP_SRC_RTC_ALARM);
+    for (uint32_t i = 0; i < EVENT_QUEUE_LENGTH; i++)
+    {
+        failed |= (Event_Get(&event) == 0) || (event.type != EVENT_NFC) || (event.value != i);
+    }
+    failed |= (Event_Queue_Empty() == 0);
+
+    return Test_End("wakeup with the queue full", failed);
+}
+
+/**
+ * @brief  The threshold handler reads the sample that crossed the threshold
+ * @return 0 on success
+ */
+static int Test_Threshold(void)
+{
+    int failed = 0;
+
+    Test_Begin();
+
+    SENSOR->PROCESSING = (SENSOR->PROCESSING & ~SENSOR_PROCESSING_THRESHOLD_Mask) | 0x100;
+    Model_Sensor_Sample(0x200);
+    SENSOR->PROCESSING &= ~SENSOR_PROCESSING_THRESHOLD_Mask;
+
+    Test_Measure();
+
+    failed |= Test_Event(0, WAKEUP_SRC_FIFO);
+    failed |= Test_Event(1, WAKEUP_SRC_ADC);
+    failed |= (Test_Count() != 2) || (test_events[1].value != 0x200);
+
+    return Test_End("threshold", failed);
+}
+
+/**
+ * @brief  The BB timer wakeup restarts the BB timer and leaves the RTC
+ *         running: RTC_ALARM_Time() keeps counting the RTC clock cycles
+ * @return 0 on success
+ */
+static int Test_BB_Timer(void)
+{
+    uint32_t ctrl = ACS->RTC_CTRL;
+    uint32_t time = RTC_ALARM_Time();
+    uint64_t cycles;
+    int failed = 0;
+
+    Test_Begin();
+
+    Model_Advance((BB_DEEP_SLEEP_TIME >> BB_DEEPSLWKUP_DEEPSLTIME_Pos) + 1);
+    cycles = model_stats.rtc_cycles - test_start.rtc_cycles;
+
+    Test_Measure();
+
+    failed |= (Test_Count() != 0);
+    failed |= (Model_Wakeup_Flags() != 0);
+    failed |= ((BBIF->STATUS & LOW_POWER_CLK) != LOW_POWER_CLK);
+    failed |= (ACS->RTC_CTRL != ctrl);
+    failed |= ((RTC_ALARM_Time() - time) != cycles);
+
+    return Test_End("BB timer", failed);
+}
+
+/**
+ * @brief  RTC_ALARM_Reconfig() loads the alarm on the edges of the RTC
+ *         clock; RTC_ALARM_Time() counts one per RTC clock cycle through the
+ *         reconfiguration, the alarm and the reload that follows it
+ * @return 0 on success
+ */
+static int Test_RTC_Alarm(void)
+{
+    uint32_t time;
+    uint64_t start;
+    int failed = 0;
+
+    Test_Begin();
+
+    time = RTC_ALARM_Time();
+    start = model_stats.rtc_cycles;
+
+    /* The second value replaces the first, not loaded yet */
+    RTC_ALARM_Reconfig(2 * TEST_RTC_ALARM_TICKS);
+    RTC_ALARM_Reconfig(TEST_RTC_ALARM_TICKS);
+    RTC_ALARM_Reconfig_Wait();
+
+    Test_Measure();
+
+    failed |= RTC_ALARM_Reconfig_Busy();
+    failed |= (NVIC_GetEnableIRQ(GPIO3_IRQn) != 0);
+    failed |= ((RTC_ALARM_Time() - time) != (model_stats.rtc_cycles - start));
+    failed |= (ACS->RTC_CFG != RTC_CFG_RELOAD_VALUE);
+
+    for (uint32_t i = 0; i < (2 * TEST_RTC_ALARM_TICKS); i++)
+    {
+        Model_Advance(1);
+        if ((RTC_ALARM_Time() - time) != (model_stats.rtc_cycles - start))
+        {
+            fprintf(stderr, "RTC_ALARM_Time(): %u cycles after the reconfiguration, off by %d\n",
+                    (unsigned)i, (int)((RTC_ALARM_Time() - time) - (uint32_t)(model_stats.rtc_cycles - start)));
+            failed = 1;
+            break;
+        }
+    }
+
+    failed |= Test_Event(0, WAKEUP_SRC_RTC_ALARM);
+    failed |= (Test_Count() != 1);
+
+    return Test_End("RTC alarm", failed);
+}
+
+/**
+ * @brief      Sleep in a power mode until a GPIO1 wakeup, then serve it
+ * @param [in] name  Scenario
+ * @param [in] mode  Power mode selected by the governor
+ * @return     0 on success
+ */
+static int Test_Sleep(const char *name, power_mode_t mode)
+{
+    uint64_t sleep_cycles = model_stats.sleep_cycles;
+    int failed = 0;
+
+    Test_Begin();
+    test_power_mode = mode;
+
+    Model_Wakeup_At(MODEL_WAKEUP_GPIO1, TEST_SLEEP_CYCLES);
+
+    if (setjmp(test_reset) == 0)
+    {
+        model_reset_hook = Test_Reset_Hook;
+        SoC_Sleep();
+
+        /* Woken up with the core retained */
+        failed |= (mode != POWER_MODE_CORE_RETENTION);
+    }
+    else
+    {
+        /* Woken up through reset: the flag tells what woke the core up */
+        failed |= (mode == POWER_MODE_CORE_RETENTION);
+        failed |= (Model_Wakeup_Flags() != (1U << MODEL_WAKEUP_GPIO1));
+        failed |= (Test_Count() != 0);
+
+        Wakeup_Source_Restore();
+    }
+    model_reset_hook = NULL;
+
+    Test_Measure();
+
+    failed |= Test_Event(0, WAKEUP_SRC_GPIO);
+    failed |= (Test_Count() != 1);
+    failed |= (Model_Wakeup_Flags() != 0);
+    failed |= ((model_stats.sleep_cycles - sleep_cycles) != TEST_SLEEP_CYCLES);
+
+    return Test_End(name, failed);
+}
+
+/**
+ * @brief  Wakeup_Handler_Register() removes, adds and replaces handlers
+ * @return 0 on success
+ */
+static int Test_Register(void)
+{
+    uint32_t added = 0;
+    uint8_t status = WAKEUP_HANDLER_NO_ERROR;
+    int failed = 0;
+
+    Test_Begin();
+
+    /* Without a handler, the flag is neither served nor cleared */
+    failed |= (Wakeup_Handler_Register(WAKEUP_GPIO1_EVENT_SET, 0, 0, NULL) != WAKEUP_HANDLER_NO_ERROR);
+    Model_Wakeup(MODEL_WAKEUP_GPIO1);
+    failed |= (Test_Count() != 0);
+    failed |= (Model_Wakeup_Flags() != (1U << MODEL_WAKEUP_GPIO1));
+
+    /* Registered again, the pending flag is served on the next event */
+    failed |= (Wakeup_Handler_Register(WAKEUP_GPIO1_EVENT_SET, WAKEUP_GPIO1_EVENT_CLEAR, WAKEUP_SRC_GPIO,
+                                       GPIO1_Wakeup_Process_Handler) != WAKEUP_HANDLER_NO_ERROR);
+    Model_Wakeup(MODEL_WAKEUP_NFC_FIELD);
+    failed |= Test_Event(0, WAKEUP_SRC_NFC);
+    failed |= Test_Event(1, WAKEUP_SRC_GPIO);
+
+    /* Fill the table with the flags not served yet */
+    for (uint32_t n = MODEL_WAKEUP_GPIO0; (n <= MODEL_WAKEUP_GPIO3) && (status == WAKEUP_HANDLER_NO_ERROR); n++)
+    {
+        if (n != MODEL_WAKEUP_GPIO1)
+        {
+            status = Wakeup_Handler_Register(MODEL_WAKEUP_EVENT(n), MODEL_WAKEUP_CLEAR(n), WAKEUP_SRC_GPIO,
+                                             GPIO1_Wakeup_Process_Handler);
+            added += (status == WAKEUP_HANDLER_NO_ERROR);
+        }
+    }
+    for (uint32_t bit = MODEL_WAKEUP_COUNT; (bit < MODEL_WAKEUP_EVENT_Pos) && (status == WAKEUP_HANDLER_NO_ERROR); bit++)
+    {
+        status = Wakeup_Handler_Register(MODEL_WAKEUP_EVENT(bit), 0, WAKEUP_SRC_GPIO, GPIO1_Wakeup_Process_Handler);
+        added += (status == WAKEUP_HANDLER_NO_ERROR);
+    }
+    failed |= (status != WAKEUP_HANDLER_TABLE_FULL);
+    failed |= ((WAKEUP_HANDLER_DEFAULT_COUNT + added) != WAKEUP_HANDLER_MAX);
+
+    /* A new handler takes the GPIO0 flag */
+    Model_Wakeup(MODEL_WAKEUP_GPIO0);
+    failed |= Test_Event(2, WAKEUP_SRC_GPIO);
+    failed |= (Model_Wakeup_Flags() != 0);
+
+    /* Back to the default handlers */
+    for (uint32_t n = MODEL_WAKEUP_GPIO0; n <= MODEL_WAKEUP_GPIO3; n++)
+    {
+        if (n != MODEL_WAKEUP_GPIO1)
+        {
+            Wakeup_Handler_Register(MODEL_WAKEUP_EVENT(n), 0, 0, NULL);
+        }
+    }
+    for (uint32_t bit = MODEL_WAKEUP_COUNT; bit < MODEL_WAKEUP_EVENT_Pos; bit++)
+    {
+        Wakeup_Handler_Register(MODEL_WAKEUP_EVENT(bit), 0, 0, NULL);
+    }
+
+    Test_Measure();
+
+    return Test_End("Wakeup_Handler_Register", failed);
+}
+
+int main(void)
+{
+    int failed = 0;
+
+    if (Model_Init() != 0)
+    {
+        return 1;
+    }
+
+    failed |= Test_Config();
+    failed |= Test_Dispatch();
+    failed |= Test_Dispatch_Passes();
+    failed |= Test_Queue_Full();
+    failed |= Test_Threshold();
+    failed |= Test_BB_Timer();
+    failed |= Test_RTC_Alarm();
+    failed |= Test_Sleep("sleep, core retention", POWER_MODE_CORE_RETENTION);
+    failed |= Test_Sleep("sleep, no retention", POWER_MODE_NO_RETENTION);
+    failed |= Test_Sleep("deep sleep", POWER_MODE_DEEP_SLEEP);
+    failed |= Test_Register();
+
+    return failed;
+}
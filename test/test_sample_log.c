@@ -0,0 +1,160 @@
+/**
+ * @file test_sample_log.c
+ * @brief Fill the sample log with known samples, then write the log image
+ *        and the samples logged, so that tools/sample_log_decode.py can be
+ *        checked against the encoder
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include <stdio.h>
+#include "app.h"
+#include "sample_log.h"
+
+/* Largest batch written at once: more than one block */
+#define TEST_BATCH_MAX                  (2 * SAMPLE_LOG_BLOCK_SAMPLES + 5)
+
+static uint32_t test_seed;
+
+/**
+ * @brief  Pseudo-random number, so that each run logs the same samples
+ * @return Next value
+ */
+static uint32_t Test_Random(void)
+{
+    test_seed = (test_seed * 1664525) + 1013904223;
+    return test_seed >> 8;
+}
+
+/**
+ * @brief      Check that Sample_Log_Init() clears a log with an invalid
+ *             header
+ * @param [in] length  Length to set
+ * @param [in] blocks  Number of blocks to set
+ * @param [in] kept    1 if the log must be kept, 0 if it must be cleared
+ * @return     0 on success, 1 on failure
+ */
+static int Test_Init(uint32_t length, uint32_t blocks, uint8_t kept)
+{
+    sample_log.magic = SAMPLE_LOG_MAGIC;
+    sample_log.length = length;
+    sample_log.blocks = blocks;
+    sample_log.dropped = 0;
+
+    Sample_Log_Init();
+
+    if ((sample_log.length == length) != kept)
+    {
+        fprintf(stderr, "Sample_Log_Init(): length %u, %u blocks %s\n", (unsigned)length,
+                (unsigned)blocks, kept ? "cleared" : "kept");
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *image;
+    FILE *csv;
+    uint32_t time = 0xFFFF0000;
+    uint32_t value = 0x1000;
+    int failed = 0;
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s <log image> <samples csv>\n", argv[0]);
+        return 2;
+    }
+
+    failed |= Test_Init(0, 0, 1);
+    failed |= Test_Init(SAMPLE_LOG_SIZE, SAMPLE_LOG_SIZE / SAMPLE_LOG_BLOCK_HEADER_SIZE, 1);
+    failed |= Test_Init(SAMPLE_LOG_SIZE + 1, 1, 0);
+    failed |= Test_Init(0xFFFFFFF0, 1, 0);
+    failed |= Test_Init(SAMPLE_LOG_BLOCK_HEADER_SIZE, 2, 0);
+
+    csv = fopen(argv[2], "w");
+    if (csv == NULL)
+    {
+        perror(argv[2]);
+        return 2;
+    }
+
+    /* Write batches until the log is full: slow drifts, noise, large jumps
+     * that need escaped codes, values wrapping through zero and a timebase
+     * wrapping at 32 bits */
+    Sample_Log_Clear();
+    test_seed = 1;
+    while (sample_log.dropped == 0)
+    {
+        sensor_sample_t samples[TEST_BATCH_MAX];
+        uint32_t count = 1 + (Test_Random() % TEST_BATCH_MAX);
+        uint32_t period = 1 + (Test_Random() % 1000);
+        uint32_t pattern = Test_Random() % 4;
+        uint32_t logged;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            switch (pattern)
+            {
+                case 0:
+                {
+                    value += (Test_Random() & 0x7) - 3;
+                }
+                break;
+
+                case 1:
+                {
+                    value += (Test_Random() & 0x3FF) - 0x200;
+                }
+                break;
+
+                case 2:
+                {
+                    value = Test_Random() << 8;
+                }
+                break;
+
+                default:
+                {
+                    value -= Test_Random() & 0xFF;
+                }
+                break;
+            }
+
+            samples[i].time = time;
+            samples[i].value = value;
+            time += period;
+        }
+
+        logged = Sample_Log_Write(samples, count);
+        for (uint32_t i = 0; i < logged; i++)
+        {
+            fprintf(csv, "%u,%u\n", (unsigned)samples[i].time, (unsigned)samples[i].value);
+        }
+    }
+    fclose(csv);
+
+    image = fopen(argv[1], "wb");
+    if ((image == NULL) || (fwrite(&sample_log, sizeof(sample_log), 1, image) != 1))
+    {
+        perror(argv[1]);
+        return 2;
+    }
+    fclose(image);
+
+    printf("%u blocks, %u bytes, %u samples dropped\n", (unsigned)sample_log.blocks,
+           (unsigned)sample_log.length, (unsigned)sample_log.dropped);
+
+    return failed;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file test_sensor_dsp.c
+ * @brief Run fixed sample streams through the sensor processing and print
+ *        the results; the outputs of the SIMD and scalar builds must match
+ *
+ * @copyright @parblock
+ * Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+ * onsemi), All Rights Reserved
+ *
+ * This code is the property of onsemi and may not be redistributed
+ * in any form without prior written permission from onsemi.
+ * The terms of use and warranty for this code are covered by contractual
+ * agreements between onsemi and the licensee.
+ *
+ * This is Reusable Code.
+ * @endparblock
+ */
+
+#include <stdio.h>
+#include "app.h"
+#include "sensor_dsp.h"
+
+/* Number of batches processed with each configuration and signal */
+#define TEST_BATCHES                    64
+
+/* Signals */
+#define TEST_SIGNAL_RANDOM              0    /* full scale noise */
+#define TEST_SIGNAL_NOISE               1    /* small noise over an offset */
+#define TEST_SIGNAL_STEPS               2    /* steps crossing the threshold */
+#define TEST_SIGNAL_EXTREMES            3    /* INT16_MIN / INT16_MAX patterns */
+#define TEST_SIGNALS                    4
+
+static uint32_t test_seed;
+
+/**
+ * @brief  Pseudo-random number, so that both builds see the same samples
+ * @return Next value
+ */
+static uint32_t Test_Random(void)
+{
+    test_seed = (test_seed * 1664525) + 1013904223;
+    return test_seed >> 8;
+}
+
+/**
+ * @brief      Sample of a test signal
+ * @param [in] signal  TEST_SIGNAL_*
+ * @param [in] n       Sample index
+ * @return     Sample value
+ */
+static int16_t Test_Sample(uint32_t signal, uint32_t n)
+{
+    switch (signal)
+    {
+        case TEST_SIGNAL_RANDOM:
+        {
+            return (int16_t)Test_Random();
+        }
+
+        case TEST_SIGNAL_NOISE:
+        {
+            return (int16_t)(1000 + (int32_t)(Test_Random() & 0x3F) - 0x20);
+        }
+
+        case TEST_SIGNAL_STEPS:
+        {
+            return (int16_t)((((n / 40) & 1) ? 0x400 : 0) + (int32_t)(Test_Random() & 0xF));
+        }
+
+        default:
+        {
+            uint32_t r = Test_Random();
+
+            return (r & 1) ? INT16_MAX : ((r & 2) ? INT16_MIN : (int16_t)(r >> 2));
+        }
+    }
+}
+
+/**
+ * @brief      Process the test signals with one configuration and print the
+ *             outputs
+ * @param [in] config  Configuration
+ * @return     0 on success, 1 if the configuration was rejected
+ */
+static int Test_Config(const sensor_dsp_config_t *config)
+{
+    for (uint32_t signal = 0; signal < TEST_SIGNALS; signal++)
+    {
+        uint32_t n = 0;
+
+        if (Sensor_DSP_Configure(config) != SENSOR_DSP_NO_ERROR)
+        {
+            printf("configuration rejected\n");
+            return 1;
+        }
+
+        test_seed = signal + 1;
+        printf("decimation %u taps %u shift %u signal %u\n", config->decimation,
+               config->taps, config->baseline_shift, (unsigned)signal);
+
+        for (uint32_t batch = 0; batch < TEST_BATCHES; batch++)
+        {
+            int16_t samples[SENSOR_DSP_BATCH_MAX];
+            uint32_t count = 1 + (Test_Random() % SENSOR_DSP_BATCH_MAX);
+            sensor_dsp_result_t result;
+
+            for (uint32_t i = 0; i < count; i++, n++)
+            {
+                samples[i] = Test_Sample(signal, n);
+            }
+
+            Sensor_DSP_Process(samples, count, &result);
+
+            printf("%u %d %u:", (unsigned)result.count, result.peak, result.events);
+            for (uint32_t i = 0; i < result.count; i++)
+            {
+                printf(" %d", samples[i]);
+            }
+            printf("\n");
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  Check that Sensor_DSP_Restore() keeps the processing state: a
+ *         stream restored half-way must give the outputs of an
+ *         uninterrupted one
+ * @return 0 on success, 1 on a mismatch
+ */
+static int Test_Restore(void)
+{
+    static int16_t outputs[2][TEST_BATCHES][SENSOR_DSP_BATCH_MAX];
+    sensor_dsp_config_t config;
+
+    memset(&config, 0, sizeof(config));
+    config.decimation = 4;
+    config.taps = 4;
+    config.baseline_shift = 3;
+    config.threshold = 0x100;
+    config.hysteresis = 0x40;
+    for (uint32_t i = 0; i < config.taps; i++)
+    {
+        config.coeffs[i] = (int16_t)(0x8000 / config.taps);
+    }
+
+    memset(outputs, 0, sizeof(outputs));
+    for (uint32_t run = 0; run < 2; run++)
+    {
+        uint32_t n = 0;
+
+        Sensor_DSP_Configure(&config);
+        test_seed = 1;
+
+        for (uint32_t batch = 0; batch < TEST_BATCHES; batch++)
+        {
+            uint32_t count = 1 + (Test_Random() % SENSOR_DSP_BATCH_MAX);
+            sensor_dsp_result_t result;
+
+            if ((run == 1) && (batch == (TEST_BATCHES / 2)) && !Sensor_DSP_Restore())
+            {
+                printf("restore: retained state rejected\n");
+                return 1;
+            }
+
+            for (uint32_t i = 0; i < count; i++, n++)
+            {
+                outputs[run][batch][i] = Test_Sample(TEST_SIGNAL_STEPS, n);
+            }
+            Sensor_DSP_Process(outputs[run][batch], count, &result);
+        }
+    }
+
+    if (memcmp(outputs[0], outputs[1], sizeof(outputs[0])) != 0)
+    {
+        printf("restore: outputs differ\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    static const uint8_t decimations[] = { 1, 2, 4 };
+    static const uint8_t taps[] = { 2, 4, SENSOR_DSP_TAPS_MAX };
+    static const uint8_t shifts[] = { 0, 3 };
+    int failed = 0;
+
+    for (uint32_t d = 0; d < sizeof(decimations); d++)
+    {
+        for (uint32_t t = 0; t < sizeof(taps); t++)
+        {
+            for (uint32_t s = 0; s < sizeof(shifts); s++)
+            {
+                sensor_dsp_config_t config;
+
+                memset(&config, 0, sizeof(config));
+                config.decimation = decimations[d];
+                config.taps = taps[t];
+                config.baseline_shift = shifts[s];
+                config.threshold = 0x100;
+                config.hysteresis = 0x40;
+
+                /* Moving average */
+                for (uint32_t i = 0; i < config.taps; i++)
+                {
+                    config.coeffs[i] = (int16_t)(0x8000 / config.taps);
+                }
+                failed |= Test_Config(&config);
+
+                /* Gain above one and negative taps, so that the filter
+                 * output saturates */
+                for (uint32_t i = 0; i < config.taps; i++)
+                {
+                    config.coeffs[i] = (i & 1) ? (int16_t)-0x6000 : SENSOR_DSP_Q15_ONE;
+                }
+                failed |= Test_Config(&config);
+            }
+        }
+    }
+
+    failed |= Test_Restore();
+
+    return failed;
+}
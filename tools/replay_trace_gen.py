@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""
+@file replay_trace_gen.py
+@brief Generate the sensor replay trace (sensor_replay_trace[]) from a CSV
+
+Reads one "time,value" line per sample, oldest first, as printed by
+sample_log_decode.py, with the time in timebase ticks (32768 Hz):
+    python3 sample_log_decode.py sample_log.bin > trace.csv
+    python3 replay_trace_gen.py trace.csv -o code/sensor_replay_trace.c
+With --ms, the times are read in milliseconds instead. Lines that do not
+start with a number (headers, comments) are skipped.
+
+Build the generated file with SENSOR_REPLAY_EN set to 1.
+
+Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+onsemi), All Rights Reserved
+"""
+
+import argparse
+import sys
+
+TICKS_PER_SECOND = 32768
+VALUE_MASK = 0xFFFFFFFF
+
+
+def load(path, ms):
+    samples = []
+    with open(path) as csv:
+        for number, line in enumerate(csv, 1):
+            fields = [field.strip() for field in line.split(",")]
+            if len(fields) < 2 or not fields[0][:1].isdigit():
+                continue
+            try:
+                time = float(fields[0])
+                value = int(fields[1], 0)
+            except ValueError:
+                sys.exit("%s:%d: expected time,value" % (path, number))
+            if ms:
+                time = time * TICKS_PER_SECOND / 1000
+            samples.append((int(round(time)) & VALUE_MASK, value & VALUE_MASK))
+
+    for index in range(1, len(samples)):
+        # Times wrap at 32 bits, like the timebase
+        if ((samples[index][0] - samples[index - 1][0]) & VALUE_MASK) >= 0x80000000:
+            sys.exit("%s: sample %d is older than the previous one" % (path, index))
+
+    return samples
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[2])
+    parser.add_argument("csv", help="time,value samples, oldest first")
+    parser.add_argument("-o", "--output", help="C file to write (default: stdout)")
+    parser.add_argument("--ms", action="store_true", help="times are in milliseconds")
+    args = parser.parse_args()
+
+    samples = load(args.csv, args.ms)
+    if not samples:
+        sys.exit("%s: no samples" % args.csv)
+
+    lines = [
+        "/* Generated by tools/replay_trace_gen.py from %s; do not edit */" % args.csv,
+        "",
+        "#include \"app.h\"",
+        "",
+        "#if SENSOR_REPLAY_EN",
+        "",
+        "const sensor_sample_t sensor_replay_trace[] =",
+        "{",
+    ]
+    lines += ["    { 0x%08X, 0x%08X }," % sample for sample in samples]
+    lines += [
+        "};",
+        "",
+        "const uint32_t sensor_replay_trace_length = %d;" % len(samples),
+        "",
+        "#endif    /* if SENSOR_REPLAY_EN */",
+        "",
+    ]
+
+    output = open(args.output, "w") if args.output else sys.stdout
+    output.write("\n".join(lines))
+    if args.output:
+        output.close()
+        duration = ((samples[-1][0] - samples[0][0]) & VALUE_MASK) / TICKS_PER_SECOND
+        print("%d samples, %.3f s" % (len(samples), duration))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""
+@file sample_log_decode.py
+@brief Decode a dump of the compressed sensor sample log (sample_log_t)
+
+Dump the log with the debugger, for example from GDB:
+    dump binary value sample_log.bin sample_log
+then run:
+    python3 sample_log_decode.py sample_log.bin [--blocks]
+
+Prints one "time,value" line per sample, oldest first, with the time in
+timebase ticks (32768 Hz). With --blocks, prints a summary of each block
+and the compression ratio instead.
+
+Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+onsemi), All Rights Reserved
+"""
+
+import argparse
+import struct
+import sys
+
+LOG_MAGIC = 0x534C4F47
+HEADER = struct.Struct("<IIII")
+BLOCK_HEADER = struct.Struct("<BBIII")
+RICE_ESCAPE = 24
+SAMPLE_SIZE = 8
+
+
+class BitReader:
+    """Read bits most significant first"""
+
+    def __init__(self, data, offset):
+        self.data = data
+        self.pos = offset * 8
+
+    def bit(self):
+        value = (self.data[self.pos >> 3] >> (7 - (self.pos & 7))) & 1
+        self.pos += 1
+        return value
+
+    def bits(self, count):
+        value = 0
+        for _ in range(count):
+            value = (value << 1) | self.bit()
+        return value
+
+    def offset(self):
+        # Blocks are padded to a byte
+        return (self.pos + 7) >> 3
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def decode_block(data, offset):
+    count, k, time, period, first = BLOCK_HEADER.unpack_from(data, offset)
+    reader = BitReader(data, offset + BLOCK_HEADER.size)
+    values = [first]
+    for _ in range(count - 1):
+        q = 0
+        while q < RICE_ESCAPE and reader.bit():
+            q += 1
+        if q < RICE_ESCAPE:
+            zigzag = (q << k) | reader.bits(k)
+        else:
+            zigzag = reader.bits(32)
+        values.append((values[-1] + unzigzag(zigzag)) & 0xFFFFFFFF)
+    samples = [((time + i * period) & 0xFFFFFFFF, value) for i, value in enumerate(values)]
+    return samples, k, reader.offset()
+
+
+def load(path):
+    data = open(path, "rb").read()
+    magic, length, blocks, dropped = HEADER.unpack_from(data, 0)
+    if magic != LOG_MAGIC:
+        sys.exit("%s: no valid sample log (magic 0x%08X)" % (path, magic))
+    body = data[HEADER.size:HEADER.size + length]
+    if len(body) < length:
+        sys.exit("%s: dump truncated (%d of %d bytes)" % (path, len(body), length))
+    return body, blocks, dropped
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[2])
+    parser.add_argument("dump", help="binary dump of sample_log")
+    parser.add_argument("--blocks", action="store_true", help="print a summary of each block")
+    args = parser.parse_args()
+
+    body, blocks, dropped = load(args.dump)
+    offset = 0
+    total = 0
+    for index in range(blocks):
+        samples, k, end = decode_block(body, offset)
+        if args.blocks:
+            print("block %4d: offset=%5d bytes=%3d samples=%2d k=%2d time=%u"
+                  % (index, offset, end - offset, len(samples), k, samples[0][0]))
+        else:
+            for time, value in samples:
+                print("%u,%u" % (time, value))
+        total += len(samples)
+        offset = end
+
+    if args.blocks:
+        ratio = (total * SAMPLE_SIZE / offset) if offset else 0
+        print("%d samples in %d bytes (%.2fx), %d dropped" % (total, offset, ratio, dropped))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""
+@file wakeup_trace_decode.py
+@brief Decode a dump of the retained wakeup trace (wakeup_trace_t)
+
+Dump the trace with the debugger, for example from GDB:
+    dump binary value wakeup_trace.bin wakeup_trace
+then run:
+    python3 wakeup_trace_decode.py wakeup_trace.bin [--records]
+
+Prints the records in chronological order (with --records) and latency
+histograms for WAKEUP_IRQHandler, each wakeup handler and the time asleep
+per power mode.
+
+Copyright (c) 2022 Semiconductor Components Industries, LLC (d/b/a
+onsemi), All Rights Reserved
+"""
+
+import argparse
+import struct
+import sys
+
+TRACE_MAGIC = 0x54524333
+HEADER = struct.Struct("<IIIBBH")
+RECORD = struct.Struct("<IBBH")
+
+SLEEP_ENTRY, RESUME_RETENTION, RESUME_RESET, WAKEUP_IRQ, HANDLER = range(1, 6)
+TYPE_NAMES = {
+    SLEEP_ENTRY: "SLEEP_ENTRY",
+    RESUME_RETENTION: "RESUME_RETENTION",
+    RESUME_RESET: "RESUME_RESET",
+    WAKEUP_IRQ: "WAKEUP_IRQ",
+    HANDLER: "HANDLER",
+}
+SOURCE_NAMES = ["RTC_ALARM", "RTC_CLOCK", "FIFO", "BB", "NFC", "ADC", "GPIO", "SENSOR_DET"]
+MODE_NAMES = ["CORE_RETENTION", "NO_RETENTION", "DEEP_SLEEP"]
+RTC_CLK_HZ = 32768
+
+
+def load(path):
+    data = open(path, "rb").read()
+    magic, head, core_clock, cycle_shift, length_log2, _ = HEADER.unpack_from(data, 0)
+    if magic != TRACE_MAGIC:
+        sys.exit("%s: no valid wakeup trace (magic 0x%08X)" % (path, magic))
+    length = 1 << length_log2
+    records = [RECORD.unpack_from(data, HEADER.size + i * RECORD.size) for i in range(length)]
+
+    # Oldest record first; head is the 32-bit number of records added, so
+    # only [0, head) is valid until the ring has been filled once
+    if head < length:
+        ordered = records[:head]
+    else:
+        start = head % length
+        ordered = records[start:] + records[:start]
+    return ordered, cycle_shift, core_clock
+
+
+def source_bits(bits):
+    return "|".join(name for i, name in enumerate(SOURCE_NAMES) if bits & (1 << i)) or "-"
+
+
+def histogram(title, values_us):
+    if not values_us:
+        return
+    print("%s: n=%d min=%.1f us max=%.1f us mean=%.1f us"
+          % (title, len(values_us), min(values_us), max(values_us), sum(values_us) / len(values_us)))
+    # Power of 2 buckets in microseconds
+    buckets = {}
+    for value in values_us:
+        bucket = 1
+        while bucket < value:
+            bucket <<= 1
+        buckets[bucket] = buckets.get(bucket, 0) + 1
+    peak = max(buckets.values())
+    for bucket in sorted(buckets):
+        count = buckets[bucket]
+        print("  <= %8d us %6d %s" % (bucket, count, "#" * max(1, count * 40 // peak)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[2])
+    parser.add_argument("dump", help="binary dump of wakeup_trace")
+    parser.add_argument("--records", action="store_true", help="print every record")
+    args = parser.parse_args()
+
+    records, cycle_shift, core_clock = load(args.dump)
+    unit_us = (1 << cycle_shift) * 1e6 / core_clock
+
+    irq_us = []
+    handler_us = {}
+    sleep_us = {}
+    sleep_entry = None
+
+    for rtc_time, rtype, arg, data in records:
+        if args.records:
+            if rtype == WAKEUP_IRQ:
+                detail = "sources=%s duration=%.1f us" % (source_bits(arg), data * unit_us)
+            elif rtype == HANDLER:
+                detail = "source=%s duration=%.1f us" % (SOURCE_NAMES[arg & 7], data * unit_us)
+            elif rtype == SLEEP_ENTRY:
+                detail = "mode=%s" % (MODE_NAMES[arg] if arg < len(MODE_NAMES) else arg)
+            else:
+                detail = ""
+            print("rtc=%10u %-16s %s" % (rtc_time, TYPE_NAMES.get(rtype, rtype), detail))
+
+        if rtype == SLEEP_ENTRY:
+            sleep_entry = (rtc_time, arg)
+        elif rtype in (RESUME_RETENTION, RESUME_RESET) and sleep_entry is not None:
+            # The time counts up across RTC reloads; a 32-bit difference also
+            # covers the wrap of the time itself
+            entry_time, mode = sleep_entry
+            sleep_us.setdefault(mode, []).append(((rtc_time - entry_time) & 0xFFFFFFFF) * 1e6 / RTC_CLK_HZ)
+            sleep_entry = None
+        elif rtype == WAKEUP_IRQ:
+            irq_us.append(data * unit_us)
+        elif rtype == HANDLER:
+            handler_us.setdefault(arg, []).append(data * unit_us)
+
+    histogram("WAKEUP_IRQHandler", irq_us)
+    for source in sorted(handler_us):
+        histogram("Handler %s" % SOURCE_NAMES[source & 7], handler_us[source])
+    for mode in sorted(sleep_us):
+        histogram("Asleep %s" % (MODE_NAMES[mode] if mode < len(MODE_NAMES) else mode), sleep_us[mode])
+
+
+if __name__ == "__main__":
+    main()